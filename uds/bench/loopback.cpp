@@ -0,0 +1,341 @@
+#include <uds/configuration/AppConfiguration.h>
+#include <uds/net/IPEndPoint.h>
+#include <uds/threading/Hosting.h>
+#include <uds/threading/Logger.h>
+#include <uds/cryptography/Encryptor.h>
+#include <uds/client/Router.h>
+#include <uds/server/Switches.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+/* End-to-end loopback benchmark: one process stands up a Switches, a Router
+ * and a plain TCP echo destination, then drives ping-pong load through the
+ * full relay (loopback client -> Router -> tunnel -> Switches -> echo) and
+ * reports throughput, latency quantiles and memory growth.
+ *
+ *   uds_bench --protocol=tcp --connections=8 --size=1024 --duration=5
+ *
+ * Protocol variants follow the production ini values (tcp, encryptor,
+ * chacha20-poly1305, ssl, tls, websocket, websocket+ssl); the ssl family
+ * additionally needs --cert/--key/--host paths a scraper can read. */
+
+using uds::Reference;
+using uds::configuration::AppConfiguration;
+using uds::threading::Hosting;
+
+struct BenchOptions {
+    std::string protocol_ = "tcp";
+    std::string method_ = "aes-128-cfb";
+    std::string password_ = "benchmark";
+    std::string cert_;
+    std::string key_;
+    std::string host_ = "localhost";
+    int         connections_ = 8;
+    int         size_ = 1024;
+    int         duration_ = 5;
+    int         port_ = 20440;
+    int         concurrent_ = 0;
+    bool        mux_ = false;
+    bool        fast_handshake_ = false;
+    bool        resume_ = false;
+    bool        compression_ = false;
+    int         framing_ = 1;
+    bool        priority_ = false;
+    bool        adaptive_ = false;
+    bool        affinity_ = false;
+    bool        log_ = false;
+};
+
+static int Bench_GetArgument(int argc, const char* argv[], const char* name, int defaultValue) noexcept {
+    std::string value = uds::GetCommandArgument(name, argc, argv);
+    return value.empty() ? defaultValue : atoi(value.data());
+}
+
+static std::string Bench_GetArgument(int argc, const char* argv[], const char* name, const char* defaultValue) noexcept {
+    std::string value = uds::GetCommandArgument(name, argc, argv);
+    return value.empty() ? defaultValue : value;
+}
+
+static AppConfiguration::ProtocolType Bench_Protocol(const std::string& protocol) noexcept {
+    if (protocol == "encryptor") {
+        return AppConfiguration::ProtocolType_Encryptor;
+    }
+    elif(protocol == "udp") {
+        return AppConfiguration::ProtocolType_UDP;
+    }
+    elif(protocol == "chacha20-poly1305") {
+        return AppConfiguration::ProtocolType_ChaCha20Poly1305;
+    }
+    elif(protocol == "ssl") {
+        return AppConfiguration::ProtocolType_SSL;
+    }
+    elif(protocol == "tls") {
+        return AppConfiguration::ProtocolType_TLS;
+    }
+    elif(protocol == "websocket") {
+        return AppConfiguration::ProtocolType_WebSocket;
+    }
+    elif(protocol == "websocket+ssl") {
+        return AppConfiguration::ProtocolType_WebSocket_SSL;
+    }
+    else {
+        return AppConfiguration::ProtocolType_TCP;
+    }
+}
+
+static std::shared_ptr<AppConfiguration> Bench_NewConfiguration(const BenchOptions& options, bool server) noexcept {
+    std::shared_ptr<AppConfiguration> configuration = uds::make_shared_object<AppConfiguration>();
+    configuration->Mode = server ? AppConfiguration::LoopbackMode_Server : AppConfiguration::LoopbackMode_Client;
+    configuration->IP = "127.0.0.1";
+    configuration->Port = server ? options.port_ : options.port_ + 3; /* Server: echo destination. Client: loopback listener. */
+    configuration->Inbound.IP = "127.0.0.1";
+    configuration->Inbound.Port = options.port_ + 1;
+    configuration->Outbound.IP = "127.0.0.1";
+    configuration->Outbound.Port = options.port_ + 2;
+    configuration->Alignment = 4096; /* The production ini default. */
+    configuration->Backlog = 511;
+    configuration->Concurrent = options.concurrent_;
+    configuration->Turbo = true;
+    configuration->Mux = options.mux_;
+    configuration->FastHandshake = options.fast_handshake_;
+    configuration->Resume = options.resume_;
+    configuration->Compression.Enabled = options.compression_;
+    configuration->Framing.Version = options.framing_;
+    configuration->Priority.Enabled = options.priority_;
+    configuration->Adaptive.Enabled = options.adaptive_ && options.framing_ >= 2;
+    configuration->Affinity = options.affinity_;
+    configuration->Accepts = 1;
+    configuration->Protocol = Bench_Protocol(options.protocol_);
+    configuration->Protocols.Encryptor.Method = options.method_;
+    configuration->Protocols.Encryptor.Password = options.password_;
+    configuration->Protocols.Ssl.Host = options.host_;
+    configuration->Protocols.Ssl.CertificateFile = options.cert_;
+    configuration->Protocols.Ssl.CertificateKeyFile = options.key_;
+    configuration->Protocols.Ssl.VerifyPeer = false;
+    configuration->Protocols.WebSocket.Host = options.host_;
+    configuration->Protocols.WebSocket.Path = "/";
+    configuration->LogFile = options.log_ ? "stdout" : "";
+    return configuration;
+}
+
+static int Bench_Listen(int port) noexcept {
+    int server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (server == -1) {
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in bindEP;
+    memset(&bindEP, 0, sizeof(bindEP));
+    bindEP.sin_family = AF_INET;
+    bindEP.sin_addr.s_addr = inet_addr("127.0.0.1");
+    bindEP.sin_port = htons(port);
+
+    if (bind(server, (struct sockaddr*)&bindEP, sizeof(bindEP)) == -1 || listen(server, 511) == -1) {
+        close(server);
+        return -1;
+    }
+    return server;
+}
+
+static int Bench_Connect(int port) noexcept {
+    int client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (client == -1) {
+        return -1;
+    }
+
+    int nodelay = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    struct sockaddr_in remoteEP;
+    memset(&remoteEP, 0, sizeof(remoteEP));
+    remoteEP.sin_family = AF_INET;
+    remoteEP.sin_addr.s_addr = inet_addr("127.0.0.1");
+    remoteEP.sin_port = htons(port);
+
+    if (connect(client, (struct sockaddr*)&remoteEP, sizeof(remoteEP)) == -1) {
+        close(client);
+        return -1;
+    }
+    return client;
+}
+
+static bool Bench_Transfer(int fd, char* buffer, int length, bool sending) noexcept {
+    for (int offset = 0; offset < length;) {
+        ssize_t transferred = sending ?
+            send(fd, buffer + offset, length - offset, MSG_NOSIGNAL) :
+            recv(fd, buffer + offset, length - offset, 0);
+        if (transferred < 1) {
+            return false;
+        }
+        offset += (int)transferred;
+    }
+    return true;
+}
+
+static void Bench_EchoLoopback(int server) noexcept {
+    for (;;) {
+        int client = accept(server, NULL, NULL);
+        if (client == -1) {
+            return;
+        }
+
+        std::thread(
+            [client]() noexcept {
+                char chunk[65536];
+                for (;;) {
+                    ssize_t length = recv(client, chunk, sizeof(chunk), 0);
+                    if (length < 1 || !Bench_Transfer(client, chunk, (int)length, true)) {
+                        break;
+                    }
+                }
+                close(client);
+            }).detach();
+    }
+}
+
+static uint64_t Bench_MaxRss() noexcept {
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss;
+}
+
+static int64_t Bench_Quantile(const std::vector<int64_t>& samples, double q) noexcept {
+    if (samples.empty()) {
+        return 0;
+    }
+
+    std::size_t index = (std::size_t)(q * (samples.size() - 1));
+    return samples[index];
+}
+
+static void Bench_Driver(const BenchOptions& options) noexcept {
+    typedef std::chrono::steady_clock steady_clock;
+
+    uint64_t rss = Bench_MaxRss();
+    std::atomic<uint64_t> frames = ATOMIC_VAR_INIT(0);
+    std::vector<std::vector<int64_t> > latencies(options.connections_);
+
+    steady_clock::time_point deadline = steady_clock::now() + std::chrono::seconds(options.duration_);
+    std::vector<std::thread> drivers;
+    for (int i = 0; i < options.connections_; i++) {
+        drivers.emplace_back(
+            [&options, &frames, &latencies, deadline, i]() noexcept {
+                int client = Bench_Connect(options.port_ + 3);
+                if (client == -1) {
+                    return;
+                }
+
+                std::vector<int64_t>& samples = latencies[i];
+                std::vector<char> frame(options.size_, 'A' + (i % 26));
+
+                while (steady_clock::now() < deadline) {
+                    steady_clock::time_point departure = steady_clock::now();
+                    if (!Bench_Transfer(client, frame.data(), options.size_, true) ||
+                        !Bench_Transfer(client, frame.data(), options.size_, false)) {
+                        break;
+                    }
+
+                    samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - departure).count());
+                    frames++;
+                }
+                close(client);
+            });
+    }
+
+    for (std::thread& driver : drivers) {
+        driver.join();
+    }
+
+    std::vector<int64_t> samples;
+    for (std::vector<int64_t>& partial : latencies) {
+        samples.insert(samples.end(), partial.begin(), partial.end());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    uint64_t relayed = frames.load() * (uint64_t)options.size_ * 2; /* Both directions cross the tunnel. */
+    double seconds = (double)options.duration_;
+    fprintf(stdout,
+        "protocol=%s connections=%d size=%d duration=%ds mux=%d "
+        "frames=%llu throughput_mbps=%.2f rtt_p50_us=%.1f rtt_p99_us=%.1f rtt_p999_us=%.1f rss_grow_kb=%llu\n",
+        options.protocol_.data(), options.connections_, options.size_, options.duration_, options.mux_ ? 1 : 0,
+        (unsigned long long)frames.load(),
+        (relayed * 8.0) / (seconds * 1000000.0),
+        Bench_Quantile(samples, 0.50) / 1000.0,
+        Bench_Quantile(samples, 0.99) / 1000.0,
+        Bench_Quantile(samples, 0.999) / 1000.0,
+        (unsigned long long)(Bench_MaxRss() - rss));
+    exit(0);
+}
+
+int main(int argc, const char* argv[]) noexcept {
+    BenchOptions options;
+    options.protocol_ = Bench_GetArgument(argc, argv, "--protocol", options.protocol_.data());
+    options.method_ = Bench_GetArgument(argc, argv, "--method", options.method_.data());
+    options.password_ = Bench_GetArgument(argc, argv, "--password", options.password_.data());
+    options.cert_ = Bench_GetArgument(argc, argv, "--cert", "");
+    options.key_ = Bench_GetArgument(argc, argv, "--key", "");
+    options.host_ = Bench_GetArgument(argc, argv, "--host", options.host_.data());
+    options.connections_ = std::max(1, Bench_GetArgument(argc, argv, "--connections", options.connections_));
+    options.size_ = std::max(1, Bench_GetArgument(argc, argv, "--size", options.size_));
+    options.duration_ = std::max(1, Bench_GetArgument(argc, argv, "--duration", options.duration_));
+    options.port_ = Bench_GetArgument(argc, argv, "--port", options.port_);
+    options.concurrent_ = Bench_GetArgument(argc, argv, "--concurrent", options.concurrent_);
+    options.mux_ = Bench_GetArgument(argc, argv, "--mux", 0) != 0;
+    options.fast_handshake_ = Bench_GetArgument(argc, argv, "--fast-handshake", 0) != 0;
+    options.resume_ = Bench_GetArgument(argc, argv, "--resume", 0) != 0;
+    options.compression_ = Bench_GetArgument(argc, argv, "--compression", 0) != 0;
+    options.framing_ = Bench_GetArgument(argc, argv, "--framing", options.framing_);
+    options.priority_ = Bench_GetArgument(argc, argv, "--priority", 0) != 0;
+    options.adaptive_ = Bench_GetArgument(argc, argv, "--adaptive", 0) != 0;
+    options.affinity_ = Bench_GetArgument(argc, argv, "--affinity", 0) != 0;
+    options.log_ = Bench_GetArgument(argc, argv, "--log", 0) != 0;
+
+    signal(SIGPIPE, SIG_IGN);
+    uds::cryptography::Encryptor::Initialize();
+    if (options.log_) {
+        uds::threading::Logger::Open("stdout");
+    }
+
+    int echo = Bench_Listen(options.port_);
+    if (echo == -1) {
+        fprintf(stderr, "unable to open the echo destination on port %d\n", options.port_);
+        return 1;
+    }
+    std::thread(Bench_EchoLoopback, echo).detach();
+
+    std::shared_ptr<Hosting> hosting = Reference::NewReference<Hosting>();
+    Hosting::Affinity = options.affinity_; /* Pinning has to be decided before the hosting threads spawn. */
+    hosting->Run(options.concurrent_,
+        [hosting, options]() noexcept {
+            std::shared_ptr<uds::server::Switches> server =
+                Reference::NewReference<uds::server::Switches>(hosting, Bench_NewConfiguration(options, true));
+            if (!server->Listen()) {
+                fprintf(stderr, "unable to listen the switches tunnel endpoints\n");
+                exit(1);
+            }
+
+            std::shared_ptr<uds::client::Router> client =
+                Reference::NewReference<uds::client::Router>(hosting, Bench_NewConfiguration(options, false));
+            if (!client->Listen()) {
+                fprintf(stderr, "unable to listen the router loopback endpoint\n");
+                exit(1);
+            }
+
+            std::thread(Bench_Driver, options).detach();
+        });
+    return 0;
+}
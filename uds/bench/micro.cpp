@@ -0,0 +1,283 @@
+#include <uds/cryptography/Encryptor.h>
+#include <uds/transmission/Transmission.h>
+#include <uds/tunnel/Connection.h>
+#include <uds/io/MemoryStream.h>
+#include <uds/io/ChunkedStream.h>
+#include <uds/collections/Dictionary.h>
+#include <uds/collections/FlatHashMap.h>
+#include <uds/threading/Hosting.h>
+#include <uds/threading/BufferslabPool.h>
+
+#include <chrono>
+#include <unordered_map>
+
+using uds::Byte;
+using uds::Int64;
+
+/* Microbenchmarks for the leaf hot functions the relay spends its cycles in:
+ * the cipher kernels, frame packing, the handshake codec, MemoryStream growth
+ * and the lookup tables. Each case prints one machine-readable line:
+ *
+ *   name=encrypt method=aes-128-cfb size=1024 ns_op=312.4 bytes_op=1056.0
+ *
+ * so runs before and after a change diff cleanly. bytes_op counts bytes
+ * requested from operator new during the timed loop, not net live bytes. */
+
+static std::atomic<uint64_t> MICRO_ALLOCATED = ATOMIC_VAR_INIT(0);
+
+void* operator new(std::size_t size) {
+    MICRO_ALLOCATED.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    MICRO_ALLOCATED.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept {
+    free(block);
+}
+
+template<typename LoopbackBody>
+static void Micro_Run(const char* name, const char* detail, int iterations, LoopbackBody&& op) noexcept {
+    typedef std::chrono::steady_clock steady_clock;
+
+    for (int i = 0, warm = std::max(1, iterations / 16); i < warm; i++) { /* Warm the caches and lazy init. */
+        op();
+    }
+
+    uint64_t allocated = MICRO_ALLOCATED.load(std::memory_order_relaxed);
+    steady_clock::time_point departure = steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        op();
+    }
+
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - departure).count();
+    allocated = MICRO_ALLOCATED.load(std::memory_order_relaxed) - allocated;
+    fprintf(stdout, "name=%s %s iterations=%d ns_op=%.1f bytes_op=%.1f\n",
+        name, detail, iterations, (double)elapsed / iterations, (double)allocated / iterations);
+}
+
+static int Micro_Iterations(int size) noexcept {
+    int iterations = 16777216 / size;
+    return std::max(4096, std::min(262144, iterations));
+}
+
+static void Micro_Ciphers() noexcept {
+    typedef uds::cryptography::Encryptor Encryptor;
+
+    static const char* methods[] = { "aes-128-cfb", "aes-256-cfb", "aes-128-gcm", "aes-256-gcm", "chacha20-poly1305" };
+    static const int sizes[] = { 64, 1024, 16384 };
+
+    for (const char* method : methods) {
+        if (!Encryptor::Support(method)) {
+            continue;
+        }
+
+        for (int size : sizes) {
+            Encryptor encryptor(method, "benchmark");
+            Encryptor decryptor(method, "benchmark");
+
+            std::vector<Byte> plaintext(size, 0x5a);
+            char detail[128];
+            snprintf(detail, sizeof(detail), "method=%s size=%d", method, size);
+
+            Micro_Run("encrypt", detail, Micro_Iterations(size),
+                [&encryptor, &plaintext, size]() noexcept {
+                    int outlen = 0;
+                    encryptor.Encrypt(plaintext.data(), size, outlen);
+                });
+
+            /* Streaming ciphers chain their state call to call, so every timed
+             * Decrypt consumes the matching Encrypt output produced just before
+             * it; only the Decrypt half lands between the clock reads. */
+            typedef std::chrono::steady_clock steady_clock;
+
+            int iterations = Micro_Iterations(size);
+            int outlen = 0;
+            for (int i = 0, warm = iterations / 16; i < warm; i++) {
+                std::shared_ptr<Byte> ciphertext = decryptor.Encrypt(plaintext.data(), size, outlen); /* Self-feed to keep both states aligned. */
+            }
+
+            int64_t elapsed = 0;
+            uint64_t allocated = 0;
+            for (int i = 0; i < iterations; i++) {
+                std::shared_ptr<Byte> ciphertext = encryptor.Encrypt(plaintext.data(), size, outlen);
+                if (!ciphertext) {
+                    break;
+                }
+
+                uint64_t mark = MICRO_ALLOCATED.load(std::memory_order_relaxed);
+                steady_clock::time_point departure = steady_clock::now();
+                int decrypted = 0;
+                decryptor.Decrypt(ciphertext.get(), outlen, decrypted);
+                elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - departure).count();
+                allocated += MICRO_ALLOCATED.load(std::memory_order_relaxed) - mark;
+            }
+            fprintf(stdout, "name=decrypt %s iterations=%d ns_op=%.1f bytes_op=%.1f\n",
+                detail, iterations, (double)elapsed / iterations, (double)allocated / iterations);
+        }
+    }
+}
+
+static void Micro_TransmissionPack() noexcept {
+    /* Pack is protected: the probe widens it for the benchmark only. */
+    class PackProbe final : public uds::transmission::Transmission {
+    public:
+        PackProbe(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const std::shared_ptr<boost::asio::ip::tcp::socket>& socket, int alignment) noexcept
+            : Transmission(hosting, context, socket, alignment) {
+
+        }
+
+    public:
+        pmessage Probe(const std::shared_ptr<Byte>& buffer, int offset, int length) noexcept {
+            return Pack(buffer, offset, length,
+                [](bool) noexcept {
+
+                });
+        }
+    };
+
+    std::shared_ptr<uds::threading::Hosting> hosting = uds::Reference::NewReference<uds::threading::Hosting>();
+    std::shared_ptr<boost::asio::io_context> context = uds::make_shared_object<boost::asio::io_context>();
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket = uds::make_shared_object<boost::asio::ip::tcp::socket>(*context);
+
+    PackProbe probe(hosting, context, socket, 16384);
+    for (int size : { 64, 1024, 16384 }) {
+        std::shared_ptr<Byte> buffer = uds::threading::BufferslabPool::Alloc(size);
+        char detail[64];
+        snprintf(detail, sizeof(detail), "size=%d", size);
+
+        Micro_Run("transmission_pack", detail, 262144,
+            [&probe, &buffer, size]() noexcept {
+                probe.Probe(buffer, 0, size);
+            });
+    }
+}
+
+static void Micro_HandshakeCodec() noexcept {
+    typedef uds::tunnel::Connection Connection;
+    typedef uds::io::MemoryStream MemoryStream;
+
+    Micro_Run("handshake_pack_plaintext", "alignment=4096", 65536,
+        []() noexcept {
+            MemoryStream messages;
+            Connection::PackPlaintextHeaders(messages, 12345678, 4096);
+        });
+
+    MemoryStream packed;
+    Connection::PackPlaintextHeaders(packed, 12345678, 4096);
+    Micro_Run("handshake_unpack_plaintext", "alignment=4096", 262144,
+        [&packed]() noexcept {
+            Connection::UnpackPlaintextLength(packed.GetBuffer().get(), 0, packed.GetPosition());
+        });
+
+    Micro_Run("handshake_pack_binary", "alignment=4096", 65536,
+        []() noexcept {
+            MemoryStream messages;
+            Connection::PackBinaryHeaders(messages, 12345678, 4096);
+        });
+
+    MemoryStream binary;
+    Connection::PackBinaryHeaders(binary, 12345678, 4096);
+    Micro_Run("handshake_unpack_binary", "alignment=4096", 262144,
+        [&binary]() noexcept {
+            Connection::UnpackBinaryLength(binary.GetBuffer().get(), 0, binary.GetPosition());
+        });
+}
+
+static void Micro_MemoryStream() noexcept {
+    typedef uds::io::MemoryStream MemoryStream;
+
+    static const int chunk = 256;
+    static const int total = 1048576;
+
+    char detail[64];
+    snprintf(detail, sizeof(detail), "chunk=%d total=%d", chunk, total);
+
+    Byte block[chunk];
+    memset(block, 0x5a, sizeof(block));
+
+    /* One op grows a fresh stream from empty to 1MB: the doublings and the
+     * copies they imply dominate, which is exactly what the case measures. */
+    Micro_Run("memorystream_write", detail, 256,
+        [&block]() noexcept {
+            MemoryStream messages;
+            for (int offset = 0; offset < total; offset += chunk) {
+                messages.Write(block, 0, chunk);
+            }
+        });
+
+    /* Same growth pattern through the rope: appended segments never re-copy the
+     * bytes already written, and the segments recycle through the slab pool. */
+    Micro_Run("chunkedstream_write", detail, 256,
+        [&block]() noexcept {
+            uds::io::ChunkedStream messages;
+            for (int offset = 0; offset < total; offset += chunk) {
+                messages.Write(block, 0, chunk);
+            }
+        });
+}
+
+static void Micro_Dictionaries() noexcept {
+    typedef uds::collections::Dictionary Dictionary;
+
+    for (int size : { 1024, 65536 }) {
+        std::unordered_map<Int64, int> stl;
+        uds::collections::FlatHashMap<Int64, int> flat;
+        std::vector<Int64> keys(size);
+
+        for (int i = 0; i < size; i++) {
+            Int64 key = ((Int64)i * 2654435761LL) & 0x7fffffffffffLL; /* Scattered but reproducible. */
+            keys[i] = key;
+            stl[key] = i;
+            flat[key] = i;
+        }
+
+        char detail[64];
+        snprintf(detail, sizeof(detail), "entries=%d", size);
+
+        int cursor = 0;
+        int sink = 0; /* Keeps the optimizer from hollowing the lookup out. */
+        Micro_Run("dictionary_unordered_map", detail, 1048576,
+            [&stl, &keys, &cursor, &sink, size]() noexcept {
+                int value = 0;
+                Dictionary::TryGetValue(stl, keys[cursor++ & (size - 1)], value);
+                sink += value;
+            });
+
+        cursor = 0;
+        Micro_Run("dictionary_flat_hash_map", detail, 1048576,
+            [&flat, &keys, &cursor, &sink, size]() noexcept {
+                sink += flat.find(keys[cursor++ & (size - 1)])->second;
+            });
+
+        if (sink == INT_MIN) {
+            fprintf(stderr, "%d", sink);
+        }
+    }
+}
+
+int main(int argc, const char* argv[]) noexcept {
+    uds::cryptography::Encryptor::Initialize();
+
+    Micro_Ciphers();
+    Micro_TransmissionPack();
+    Micro_HandshakeCodec();
+    Micro_MemoryStream();
+    Micro_Dictionaries();
+    return 0;
+}
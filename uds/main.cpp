@@ -2,6 +2,7 @@
 #include <uds/io/File.h>
 #include <uds/net/IPEndPoint.h>
 #include <uds/threading/Hosting.h>
+#include <uds/threading/Logger.h>
 #include <uds/cryptography/Encryptor.h>
 #include <uds/client/Router.h>
 #include <uds/server/Switches.h>
@@ -59,6 +60,94 @@ LoadAppConfiguration(int argc, const char* argv[]) noexcept {
     return NULL;
 }
 
+#ifndef _WIN32
+static volatile sig_atomic_t uds_reload_pending_ = 0;
+#endif
+
+/* SIGHUP re-reads the ini and swaps the new snapshot into the running loopback:
+ * the handler only flips a flag, and a timing-wheel poll does the file work so
+ * nothing heavier than a store happens in signal context. */
+static void
+WatchReloadSignal(const std::shared_ptr<Hosting>& hosting, const std::shared_ptr<AppConfiguration>& configuration, std::function<bool(const std::shared_ptr<AppConfiguration>&)>&& reload) noexcept {
+#ifndef _WIN32
+    if (configuration->Path.empty()) {
+        return;
+    }
+
+    signal(SIGHUP,
+        [](int) {
+            uds_reload_pending_ = 1;
+        });
+
+    typedef std::function<void()> PollHandler;
+
+    const std::function<bool(const std::shared_ptr<AppConfiguration>&)> sreload = std::move(reload);
+    std::shared_ptr<PollHandler> poll = uds::make_shared_object<PollHandler>();
+    if (!poll) {
+        return;
+    }
+
+    *poll = [hosting, configuration, sreload, poll]() noexcept {
+        if (uds_reload_pending_) {
+            uds_reload_pending_ = 0;
+
+            std::shared_ptr<AppConfiguration> next = AppConfiguration::LoadIniFile(configuration->Path);
+            if (next && sreload(next)) {
+                fprintf(stdout, "Configuration reloaded: %s\r\n", configuration->Path.data());
+            }
+            else {
+                fprintf(stdout, "Configuration reload rejected: %s\r\n", configuration->Path.data());
+            }
+        }
+
+        hosting->GetTimingWheel()->SetTimeout(
+            [poll](void*) noexcept {
+                (*poll)();
+            }, 1000);
+    };
+    (*poll)();
+#endif
+}
+
+static void
+BenchmarkEncryptorMethod(const std::shared_ptr<AppConfiguration>& configuration) noexcept {
+    typedef uds::cryptography::Encryptor Encryptor;
+
+    if (configuration->Protocol != AppConfiguration::ProtocolType_Encryptor || !configuration->Protocols.Encryptor.Benchmark) {
+        return;
+    }
+
+    const std::string& method = configuration->Protocols.Encryptor.Method;
+    const std::string& password = configuration->Protocols.Encryptor.Password;
+    const char* candidates[] = { method.data(), "aes-128-gcm", "aes-256-gcm", "aes-128-ctr", "chacha20", "rc4" };
+
+    const char* fastest = NULL;
+    double best = 0;
+
+    fprintf(stdout, "Encryptor:\r\n");
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        const char* candidate = candidates[i];
+        if (i > 0 && method == candidate) { /* The configured method already measured first. */
+            continue;
+        }
+
+        double throughput = Encryptor::Throughput(candidate, password, 250);
+        if (throughput <= 0) {
+            continue;
+        }
+
+        fprintf(stdout, "    %-20s: %.0f MB/s\r\n", candidate, throughput / (1024 * 1024));
+        if (throughput > best) {
+            best = throughput;
+            fastest = candidate;
+        }
+    }
+
+    if (fastest && method != fastest) {
+        fprintf(stdout, "    %-20s: %s (both ends must be configured alike)\r\n", "recommended", fastest);
+    }
+}
+
 int main(int argc, const char* argv[]) noexcept {
 #ifdef _WIN32
     SetConsoleTitle(TEXT(UDS_APPNAME));
@@ -96,9 +185,15 @@ int main(int argc, const char* argv[]) noexcept {
     uds::SetProcessPriorityToMaxLevel();
     uds::SetThreadPriorityToMaxLevel();
     uds::cryptography::Encryptor::Initialize(); /* Prepare the OpenSSL cryptography library environment. */
+    BenchmarkEncryptorMethod(configuration);
+
+    if (configuration->LogFile.size()) {
+        uds::threading::Logger::Open(configuration->LogFile);
+    }
 
     std::shared_ptr<Hosting> hosting = Reference::NewReference<Hosting>();
-    hosting->Run(
+    Hosting::Affinity = configuration->Affinity; /* Pinning has to be decided before the hosting threads spawn. */
+    hosting->Run(configuration->Concurrent,
         [configuration, hosting]() noexcept {
             auto protocol = [](AppConfiguration* config) noexcept {
                 switch (config->Protocol)
@@ -109,6 +204,8 @@ int main(int argc, const char* argv[]) noexcept {
                     return "tls";
                 case AppConfiguration::ProtocolType_Encryptor:
                     return "encryptor";
+                case AppConfiguration::ProtocolType_ChaCha20Poly1305:
+                    return "chacha20-poly1305";
                 case AppConfiguration::ProtocolType_WebSocket:
                     return "websocket";
                 case AppConfiguration::ProtocolType_WebSocket_SSL:
@@ -128,10 +225,15 @@ int main(int argc, const char* argv[]) noexcept {
                     fprintf(stdout, "%s\r\nLoopback:\r\n", "Application started. Press Ctrl+C to shut down.");
                     fprintf(stdout, "Mode                  : %s\r\n", "server");
                     fprintf(stdout, "Process               : %d\r\n", uds::GetCurrentProcessId());
+                    fprintf(stdout, "Concurrent            : %d\r\n", hosting->GetConcurrency());
                     fprintf(stdout, "Protocol              : %s\r\n", protocol(configuration.get()));
                     fprintf(stdout, "Cwd                   : %s\r\n", uds::GetCurrentDirectoryPath().data());
                     fprintf(stdout, "TCP/IP RX             : %s\r\n", IPEndPoint::ToEndPoint(server->GetLocalEndPoint(true)).ToString().data());
                     fprintf(stdout, "TCP/IP TX             : %s\r\n", IPEndPoint::ToEndPoint(server->GetLocalEndPoint(false)).ToString().data());
+                    WatchReloadSignal(hosting, configuration,
+                        [server](const std::shared_ptr<AppConfiguration>& next) noexcept {
+                            return server->Reload(next);
+                        });
                 }
                 else {
                     exit(0);
@@ -146,9 +248,14 @@ int main(int argc, const char* argv[]) noexcept {
                     fprintf(stdout, "%s\r\nLoopback:\r\n", "Application started. Press Ctrl+C to shut down.");
                     fprintf(stdout, "Mode                  : %s\r\n", "client");
                     fprintf(stdout, "Process               : %d\r\n", uds::GetCurrentProcessId());
+                    fprintf(stdout, "Concurrent            : %d\r\n", hosting->GetConcurrency());
                     fprintf(stdout, "Protocol              : %s\r\n", protocol(configuration.get()));
                     fprintf(stdout, "Cwd                   : %s\r\n", uds::GetCurrentDirectoryPath().data());
                     fprintf(stdout, "TCP/IP                : %s\r\n", IPEndPoint::ToEndPoint(client->GetLocalEndPoint()).ToString().data());
+                    WatchReloadSignal(hosting, configuration,
+                        [client](const std::shared_ptr<AppConfiguration>& next) noexcept {
+                            return client->Reload(next);
+                        });
                 }
                 else {
                     exit(0);
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    template <typename Signature>
+    class InplaceFunction;
+
+    /* Small-buffer replacement for the std::function callbacks flying through the
+     * transmission stack. Captures up to EINPLACEFUNCTION_CSS bytes live inside the
+     * object itself, so the usual two-or-three shared_ptr capture costs neither a heap
+     * allocation nor a pointer chase per asynchronous hop; the rare larger capture
+     * spills to the heap and behaves exactly like std::function did. */
+    template <typename R, typename... Args>
+    class InplaceFunction<R(Args...)> final {
+    public:
+        static const int                        EINPLACEFUNCTION_CSS = 64; /* Inline capture capacity; sized for the capture patterns in the relay pipeline. */
+
+    public:
+        inline InplaceFunction() noexcept
+            : vtable_(NULL) {
+
+        }
+        inline InplaceFunction(std::nullptr_t) noexcept
+            : vtable_(NULL) {
+
+        }
+        inline InplaceFunction(const InplaceFunction& other) noexcept
+            : vtable_(other.vtable_) {
+            if (NULL != vtable_) {
+                vtable_->copy_(&storage_, &other.storage_);
+            }
+        }
+        inline InplaceFunction(InplaceFunction&& other) noexcept
+            : vtable_(other.vtable_) {
+            if (NULL != vtable_) {
+                vtable_->move_(&storage_, &other.storage_);
+                other.vtable_ = NULL;
+            }
+        }
+        template <typename F, typename TCallable = typename std::decay<F>::type,
+            typename = typename std::enable_if<
+                !std::is_same<TCallable, InplaceFunction>::value &&
+                !std::is_same<TCallable, std::nullptr_t>::value>::type,
+            typename = decltype(std::declval<TCallable&>()(std::declval<Args>()...))>
+        inline InplaceFunction(F&& f) noexcept
+            : vtable_(NULL) {
+            vtable_ = Manager<TCallable, sizeof(TCallable) <= EINPLACEFUNCTION_CSS>::Construct(&storage_, std::forward<F>(f));
+        }
+        inline ~InplaceFunction() noexcept {
+            Release();
+        }
+
+    public:
+        inline InplaceFunction&                 operator=(const InplaceFunction& other) noexcept {
+            if (this != &other) {
+                Release();
+                vtable_ = other.vtable_;
+                if (NULL != vtable_) {
+                    vtable_->copy_(&storage_, &other.storage_);
+                }
+            }
+            return *this;
+        }
+        inline InplaceFunction&                 operator=(InplaceFunction&& other) noexcept {
+            if (this != &other) {
+                Release();
+                vtable_ = other.vtable_;
+                if (NULL != vtable_) {
+                    vtable_->move_(&storage_, &other.storage_);
+                    other.vtable_ = NULL;
+                }
+            }
+            return *this;
+        }
+        inline InplaceFunction&                 operator=(std::nullptr_t) noexcept {
+            Release();
+            return *this;
+        }
+        template <typename F, typename TCallable = typename std::decay<F>::type,
+            typename = typename std::enable_if<
+                !std::is_same<TCallable, InplaceFunction>::value &&
+                !std::is_same<TCallable, std::nullptr_t>::value>::type,
+            typename = decltype(std::declval<TCallable&>()(std::declval<Args>()...))>
+        inline InplaceFunction&                 operator=(F&& f) noexcept {
+            InplaceFunction callable(std::forward<F>(f));
+            return *this = std::move(callable);
+        }
+
+    public:
+        inline R                                operator()(Args... args) const {
+            return vtable_->invoke_(&storage_, std::forward<Args>(args)...);
+        }
+        inline explicit                         operator bool() const noexcept { return NULL != vtable_; }
+
+    public:
+        friend inline bool                      operator==(const InplaceFunction& f, std::nullptr_t) noexcept { return !f; }
+        friend inline bool                      operator==(std::nullptr_t, const InplaceFunction& f) noexcept { return !f; }
+        friend inline bool                      operator!=(const InplaceFunction& f, std::nullptr_t) noexcept { return (bool)f; }
+        friend inline bool                      operator!=(std::nullptr_t, const InplaceFunction& f) noexcept { return (bool)f; }
+
+    private:
+        struct VirtualTable {
+            R                                   (*invoke_)(const void* storage, Args&&... args);
+            void                                (*copy_)(void* storage, const void* from);
+            void                                (*move_)(void* storage, void* from);
+            void                                (*destroy_)(void* storage);
+        };
+
+        template <typename TCallable, bool TInline>
+        struct Manager { /* The capture fits the inline slab. */
+            static R                            Invoke(const void* storage, Args&&... args) {
+                return (*(TCallable*)storage)(std::forward<Args>(args)...);
+            }
+            static void                         Copy(void* storage, const void* from) noexcept {
+                new (storage) TCallable(*(const TCallable*)from);
+            }
+            static void                         Move(void* storage, void* from) noexcept {
+                TCallable* callable = (TCallable*)from;
+                new (storage) TCallable(std::move(*callable));
+                callable->~TCallable();
+            }
+            static void                         Destroy(void* storage) noexcept {
+                ((TCallable*)storage)->~TCallable();
+            }
+            template <typename F>
+            static const VirtualTable*          Construct(void* storage, F&& f) noexcept {
+                static const VirtualTable vtable = { &Invoke, &Copy, &Move, &Destroy };
+
+                new (storage) TCallable(std::forward<F>(f));
+                return &vtable;
+            }
+        };
+
+        template <typename TCallable>
+        struct Manager<TCallable, false> { /* Oversized capture; spill to the heap like std::function. */
+            static R                            Invoke(const void* storage, Args&&... args) {
+                return (**(TCallable* const*)storage)(std::forward<Args>(args)...);
+            }
+            static void                         Copy(void* storage, const void* from) noexcept {
+                *(TCallable**)storage = new TCallable(**(TCallable* const*)from);
+            }
+            static void                         Move(void* storage, void* from) noexcept {
+                *(TCallable**)storage = *(TCallable**)from;
+                *(TCallable**)from = NULL;
+            }
+            static void                         Destroy(void* storage) noexcept {
+                delete *(TCallable**)storage;
+            }
+            template <typename F>
+            static const VirtualTable*          Construct(void* storage, F&& f) noexcept {
+                static const VirtualTable vtable = { &Invoke, &Copy, &Move, &Destroy };
+
+                *(TCallable**)storage = new TCallable(std::forward<F>(f));
+                return &vtable;
+            }
+        };
+
+    private:
+        inline void                             Release() noexcept {
+            const VirtualTable* vtable = vtable_;
+            vtable_ = NULL;
+            if (NULL != vtable) {
+                vtable->destroy_(&storage_);
+            }
+        }
+
+    private:
+        const VirtualTable*                     vtable_;
+        typename std::aligned_storage<EINPLACEFUNCTION_CSS, alignof(std::max_align_t)>::type storage_;
+    };
+}
@@ -110,4 +110,78 @@ namespace uds {
             return (int)((long long)(NextDouble() * (double)num) + minValue);
         }
     };
+
+    /* Bulk block generator (xoshiro256**): emits eight bytes per state step, so the
+     * handshake padding and keepalive junk are filled in whole words instead of a
+     * SeedArray rebuild per byte. Obfuscation quality only, never key material. */
+    struct RandomBlock {
+    private:
+        uint64_t                            s_[4];
+
+    public:
+        inline RandomBlock() noexcept {
+            Reset(GetTickCount() ^ (uint64_t)(uintptr_t)this);
+        }
+        inline RandomBlock(uint64_t seed) noexcept {
+            Reset(seed);
+        }
+
+    public:
+        inline void                         Reset(uint64_t seed) noexcept {
+            for (int i = 0; i < 4; i++) { /* SplitMix64 expands the seed into the full state. */
+                seed += 0x9E3779B97F4A7C15ULL;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                s_[i] = z ^ (z >> 31);
+            }
+        }
+        inline uint64_t                     Next() noexcept {
+            uint64_t result = RotL(s_[1] * 5, 7) * 9;
+            uint64_t t = s_[1] << 17;
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+            s_[2] ^= t;
+            s_[3] = RotL(s_[3], 45);
+            return result;
+        }
+        inline void                         NextBytes(void* buffer, int length) noexcept {
+            Byte* p = (Byte*)buffer;
+            if (!p || length < 1) {
+                return;
+            }
+
+            while (length >= (int)sizeof(uint64_t)) {
+                uint64_t w = Next();
+                memcpy(p, &w, sizeof(w));
+                p += sizeof(w);
+                length -= (int)sizeof(w);
+            }
+
+            if (length > 0) {
+                uint64_t w = Next();
+                memcpy(p, &w, length);
+            }
+        }
+        inline void                         NextAscii(void* buffer, int length) noexcept {
+            static const Char alphabet_[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+            Byte* p = (Byte*)buffer;
+            if (!p || length < 1) {
+                return;
+            }
+
+            NextBytes(p, length);
+            for (int i = 0; i < length; i++) { /* 256 % 62 keeps a small bias: irrelevant for padding. */
+                p[i] = alphabet_[p[i] % 62];
+            }
+        }
+
+    private:
+        inline static uint64_t              RotL(uint64_t x, int k) noexcept {
+            return (x << k) | (x >> (64 - k));
+        }
+    };
 }
\ No newline at end of file
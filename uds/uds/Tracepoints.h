@@ -0,0 +1,33 @@
+#pragma once
+
+/* USDT static tracepoints at the relay pipeline seams: a probe compiles to a
+ * single nop plus an ELF note, so bpftrace/perf can attach to a live process
+ * with no rebuild, and an unprobed relay pays nothing measurable. Platforms
+ * without <sys/sdt.h> compile every probe away entirely. */
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define UDS_TRACEPOINTS 1
+#endif
+#endif
+
+#if defined(UDS_TRACEPOINTS)
+#define UDS_TRACE1(name, a1)                    DTRACE_PROBE1(uds, name, a1)
+#define UDS_TRACE2(name, a1, a2)                DTRACE_PROBE2(uds, name, a1, a2)
+#define UDS_TRACE3(name, a1, a2, a3)            DTRACE_PROBE3(uds, name, a1, a2, a3)
+#define UDS_TRACE4(name, a1, a2, a3, a4)        DTRACE_PROBE4(uds, name, a1, a2, a3, a4)
+#else
+#define UDS_TRACE1(name, a1)                    ((void)0)
+#define UDS_TRACE2(name, a1, a2)                ((void)0)
+#define UDS_TRACE3(name, a1, a2, a3)            ((void)0)
+#define UDS_TRACE4(name, a1, a2, a3, a4)        ((void)0)
+#endif
+
+/* Probe map (provider "uds"):
+ *   accept(side, fd)                           a loopback or tunnel socket was accepted; side 0 RX, 1 TX, 2 client.
+ *   handshake(side, fd, success)               a transmission finished its protocol handshake.
+ *   channel_open(id)                           a paired channel started relaying.
+ *   channel_close(id, rx_bytes, tx_bytes, detached) a channel tore down; detached means its resume window lapsed.
+ *   frame_read(id, length, direction)          a relay read completed; direction 0 remote socket, 1 tunnel.
+ *   frame_queued(bytes, queued)                a frame entered a transmission write queue (queue depth after).
+ *   frame_written(success, drained, queued)    a transmission write batch completed (queue depth after). */
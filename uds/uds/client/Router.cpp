@@ -1,3 +1,4 @@
+#include <uds/Tracepoints.h>
 #include <uds/client/Router.h>
 #include <uds/collections/Dictionary.h>
 #include <uds/net/Ipep.h>
@@ -5,13 +6,19 @@
 #include <uds/net/IPEndPoint.h>
 #include <uds/threading/Timer.h>
 #include <uds/threading/Hosting.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/threading/Logger.h>
+#include <uds/ssl/SSL.h>
 #include <uds/transmission/Transmission.h>
 #include <uds/transmission/EncryptorTransmission.h>
+#include <uds/transmission/ChaCha20Poly1305Transmission.h>
 #include <uds/transmission/SslSocketTransmission.h>
 #include <uds/transmission/WebSocketTransmission.h>
 #include <uds/transmission/SslWebSocketTransmission.h>
+#include <uds/transmission/UdpTransmission.h>
 
 using uds::collections::Dictionary;
+using uds::threading::Logger;
 using uds::net::Ipep;
 using uds::net::Socket;
 using uds::net::IPEndPoint;
@@ -19,17 +26,68 @@ using uds::net::AddressFamily;
 
 namespace uds {
     namespace client {
+        /* A warm pair parked longer than this is re-dialed rather than trusted. */
+        static const int EPOOL_RECYCLE_TIMEOUT = 60 * 1000;
+
+        /* This many consecutive dial misses black a pop out for the window below;
+         * new channels (and its warm pairs) fail over to the other pops meanwhile. */
+        static const int EUPSTREAM_BLACKOUT_FAILURES = 3;
+        static const int EUPSTREAM_BLACKOUT_TIMEOUT  = 5 * 1000;
+
         Router::Router(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept
             : disposed_(false)
             , channel_(0)
             , hosting_(hosting)
-            , configuration_(configuration) {
+            , configuration_(configuration)
+            , accepts_(0)
+            , muxing_(false)
+            , pooling_(0)
+            , upstream_rotate_(0) {
             if (hosting) {
                 context_ = hosting->GetContext();
+                timewheel_ = hosting->GetTimingWheel();
+            }
+
+            if (configuration) {
+                Connection::FastHandshake = configuration->FastHandshake;
+                uds::net::Socket::ConcurrentAccepts = configuration->Accepts;
+                uds::net::Socket::Buffers.sndbuf = configuration->Buffers.Sndbuf;
+                uds::net::Socket::Buffers.rcvbuf = configuration->Buffers.Rcvbuf;
+                uds::net::Socket::Buffers.bandwidth = configuration->Buffers.Bandwidth;
+                uds::net::Socket::Buffers.notsent_lowat = configuration->Buffers.NotsentLowat;
+                uds::transmission::Transmission::Compression.enabled = configuration->Compression.Enabled;
+                uds::transmission::Transmission::Compression.threshold = configuration->Compression.Threshold;
+                uds::transmission::Transmission::Framing.version = configuration->Framing.Version;
+                uds::transmission::Transmission::Adaptive.enabled = configuration->Adaptive.Enabled;
+                uds::ssl::SSL::KernelTls = configuration->Protocols.Ssl.KernelTls;
+
+                BuildUpstreams(configuration, upstreams_);
             }
         }
 
-        bool Router::AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept {
+        void Router::BuildUpstreams(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration, std::vector<UpstreamPtr>& upstreams) noexcept {
+            /* Pop 0 is the primary Inbound/Outbound pair; the rest is the upstream list. */
+            UpstreamPtr primary = make_shared_object<UpstreamServer>();
+            if (primary) {
+                primary->endpoint_.Inbound.IP = configuration->Inbound.IP;
+                primary->endpoint_.Inbound.Port = configuration->Inbound.Port;
+                primary->endpoint_.Inbound.Domain = configuration->Inbound.Domain;
+                primary->endpoint_.Outbound.IP = configuration->Outbound.IP;
+                primary->endpoint_.Outbound.Port = configuration->Outbound.Port;
+                primary->endpoint_.Outbound.Domain = configuration->Outbound.Domain;
+                upstreams.push_back(std::move(primary));
+            }
+
+            for (const AppConfiguration::Upstream& endpoint : configuration->Upstreams) {
+                UpstreamPtr upstream = make_shared_object<UpstreamServer>();
+                if (upstream) {
+                    upstream->endpoint_ = endpoint;
+                    upstreams.push_back(std::move(upstream));
+                }
+            }
+        }
+
+        bool Router::AddTimeout(void* key, TimeoutPtr&& timeout) noexcept {
             if (!key || !timeout) {
                 return false;
             }
@@ -37,9 +95,12 @@ namespace uds {
                 ClearTimeout(key);
             }
 
-            bool success = Dictionary::TryAdd(timeouts_, key, timeout);
+            bool success = false; {
+                MutexScope scope(syncobj_);
+                success = Dictionary::TryAdd(timeouts_, key, timeout);
+            }
             if (!success) {
-                uds::threading::ClearTimeout(timeout);
+                TimingWheel::ClearTimeout(timeout);
             }
             return success;
         }
@@ -49,9 +110,11 @@ namespace uds {
                 return false;
             }
 
-            TimeoutPtr timeout;
-            Dictionary::TryRemove(timeouts_, key, timeout);
-            return uds::threading::ClearTimeout(timeout);
+            TimeoutPtr timeout; {
+                MutexScope scope(syncobj_);
+                Dictionary::TryRemove(timeouts_, key, timeout);
+            }
+            return TimingWheel::ClearTimeout(timeout);
         }
 
         void Router::Dispose() noexcept {
@@ -59,14 +122,45 @@ namespace uds {
                 /* Close the TCP socket acceptor function to prevent the system from continuously processing connections. */
                 CloseAcceptor();
 
-                /* Clear all timeouts. */
-                Dictionary::ReleaseAllPairs(timeouts_,
-                    [](TimeoutPtr& timeout) noexcept {
-                        uds::threading::Hosting::Cancel(timeout);
-                    });
+                std::shared_ptr<uds::net::MetricsServer> metrics = std::move(metrics_);
+                if (metrics) {
+                    metrics->Dispose();
+                }
 
-                /* Close all connection. */
-                Dictionary::ReleaseAllPairs(connections_);
+                MuxPtr mux;
+                std::list<MuxAsyncCallback> muxwaits;
+                std::list<PoolChannelPtr> pools; {
+                    MutexScope scope(syncobj_);
+
+                    /* Clear all timeouts. */
+                    Dictionary::ReleaseAllPairs(timeouts_,
+                        [](TimeoutPtr& timeout) noexcept {
+                            TimingWheel::ClearTimeout(timeout);
+                        });
+
+                    /* Close all connection. */
+                    Dictionary::ReleaseAllPairs(connections_);
+
+                    /* Detach the multiplexer: its disposal re-enters the lock to unregister. */
+                    mux = std::move(mux_);
+                    mux_.reset();
+                    muxwaits = std::move(muxwaits_);
+                    muxwaits_.clear();
+                    pools = std::move(pools_);
+                    pools_.clear();
+                }
+
+                if (mux) {
+                    mux->Close();
+                }
+
+                for (MuxAsyncCallback& callback : muxwaits) {
+                    callback(NULL);
+                }
+
+                for (PoolChannelPtr& pool : pools) {
+                    pool->Close();
+                }
             }
         }
 
@@ -89,7 +183,7 @@ namespace uds {
         }
 
         bool Router::Listen() noexcept {
-            if (disposed_ || !hosting_ || !context_ || !configuration_) {
+            if (disposed_ || !hosting_ || !context_ || !timewheel_ || !configuration_) {
                 return false;
             }
 
@@ -119,8 +213,11 @@ namespace uds {
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
                     return AcceptClient(context, socket);
                 });
-            if (acceptor_) {
+            if (acceptor_ && OpenMetrics()) {
                 resolver_ = make_shared_object<boost::asio::ip::tcp::resolver>(*context_);
+                if (configuration_->Pool > 0) {
+                    ReplenishPool(); /* Warm the pair pool before the first accept arrives. */
+                }
                 return true;
             }
 
@@ -128,6 +225,45 @@ namespace uds {
             return false;
         }
 
+        bool Router::Reload(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept {
+            if (disposed_ || AppConfiguration::IsInvalid(configuration)) {
+                return false;
+            }
+
+            std::vector<UpstreamPtr> upstreams;
+            BuildUpstreams(configuration, upstreams); {
+                MutexScope scope(syncobj_);
+                if (!AppConfiguration::IsHotSwappable(*configuration_, *configuration)) {
+                    return false;
+                }
+
+                /* Channels created from here on see the new snapshot; established ones
+                 * keep the one they were built with until they close. The outgoing
+                 * snapshot is pinned because dials already in flight still read it. */
+                reloads_.push_back(configuration_);
+                configuration_ = configuration;
+                upstreams_.swap(upstreams);
+            }
+
+            /* Process-wide knobs the next sockets and frames pick up directly. */
+            Connection::FastHandshake = configuration->FastHandshake;
+            uds::net::Socket::Buffers.sndbuf = configuration->Buffers.Sndbuf;
+            uds::net::Socket::Buffers.rcvbuf = configuration->Buffers.Rcvbuf;
+            uds::net::Socket::Buffers.bandwidth = configuration->Buffers.Bandwidth;
+            uds::net::Socket::Buffers.notsent_lowat = configuration->Buffers.NotsentLowat;
+            uds::transmission::Transmission::Compression.enabled = configuration->Compression.Enabled;
+            uds::transmission::Transmission::Compression.threshold = configuration->Compression.Threshold;
+            uds::ssl::SSL::KernelTls = configuration->Protocols.Ssl.KernelTls;
+
+            ReplenishPool(); /* A grown pool target or fresh pops warm up right away. */
+            return true;
+        }
+
+        std::shared_ptr<uds::configuration::AppConfiguration> Router::GetSnapshot() noexcept {
+            MutexScope scope(syncobj_);
+            return configuration_;
+        }
+
         bool Router::ResolveAddress(bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept {
             if (domain) {
                 std::shared_ptr<Reference> references = GetReference();
@@ -150,10 +286,69 @@ namespace uds {
             }
         }
 
+        bool Router::OpenMetrics() noexcept {
+            typedef uds::net::MetricsServer MetricsServer;
+
+            int port = configuration_->Metrics.Port;
+            if (port <= IPEndPoint::MinPort || port > IPEndPoint::MaxPort) {
+                return true; /* Unconfigured: nothing to listen on. */
+            }
+
+            boost::system::error_code ec;
+            boost::asio::ip::address interfaceIP = boost::asio::ip::address::from_string(configuration_->Metrics.IP, ec);
+            if (ec) {
+                return false;
+            }
+
+            std::shared_ptr<MetricsServer> metrics = NewReference<MetricsServer>(hosting_, interfaceIP, port);
+            if (!metrics) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            metrics->AddSource(
+                [references, this](std::string& body) noexcept {
+                    int connections = 0;
+                    int pools = 0;
+                    int muxs = 0; {
+                        MutexScope scope(syncobj_);
+                        connections = (int)connections_.size();
+                        pools = (int)pools_.size();
+                        muxs = mux_ ? 1 : 0;
+                    }
+
+                    char line[512];
+                    snprintf(line, sizeof(line),
+                        "# TYPE uds_connections gauge\n"
+                        "uds_connections %d\n"
+                        "# TYPE uds_pools gauge\n"
+                        "uds_pools %d\n"
+                        "# TYPE uds_muxs gauge\n"
+                        "uds_muxs %d\n"
+                        "# TYPE uds_accepts_total counter\n"
+                        "uds_accepts_total %llu\n",
+                        connections, pools, muxs,
+                        (unsigned long long)accepts_.load(std::memory_order_relaxed));
+                    body.append(line);
+                });
+
+            if (!metrics->Listen()) {
+                metrics->Dispose();
+                return false;
+            }
+
+            metrics_ = std::move(metrics);
+            return true;
+        }
+
         bool Router::AcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            accepts_.fetch_add(1, std::memory_order_relaxed);
+            UDS_TRACE2(accept, 2, Socket::GetHandle(*socket));
+            Logger::Write(Logger::LogEvent_Accept, 2, Socket::GetHandle(*socket));
+
             static const auto ClearTimeout = [](const TimeoutPtr& timeout) noexcept {
                 if (timeout) {
-                    uds::threading::ClearTimeout(constantof(timeout));
+                    TimingWheel::ClearTimeout(constantof(timeout));
                 }
             };
             static const auto CloseIfNotSuccess = [](bool success, const TimeoutPtr& timeout, const AsioTcpSocket& network, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
@@ -168,37 +363,60 @@ namespace uds {
                 return success;
             };
 
+            if (configuration_->Mux) {
+                return AcceptMuxClient(context, socket);
+            }
+            elif(configuration_->Bonding > 1) {
+                return AcceptBondClient(context, socket);
+            }
+            elif(configuration_->Pool > 0) {
+                /* Fast path: hand out a warm pair so tunnel setup costs no more
+                 * than the local accept; the cold dial below is the fallback. */
+                PoolChannelPtr pool = PopPool();
+                ReplenishPool();
+                if (pool) {
+                    /* A pooled pair has already read the hello: no deferral. */
+                    if (Accept(socket, pool->channel_, pool->writer_, pool->reader_, false, pool->upstream_, pool->token_)) {
+                        return true;
+                    }
+                    pool->Close();
+                }
+            }
+
             const std::shared_ptr<Reference> references = GetReference();
             const AsioTcpSocket network = socket;
             const AsioContext scontext = context;
-            const auto timeout = uds::threading::SetTimeout(hosting_,
+            const auto timeout = timewheel_->SetTimeout(
                 [network, references, this](void* key) noexcept {
                     Socket::Closesocket(network);
                 }, (UInt64)configuration_->Connect.Timeout * 1000);
 
-            return ResolveAddress(configuration_->Inbound.Domain, configuration_->Inbound.IP, configuration_->Inbound.Port,
-                [scontext, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
-                    if (!ConnectConnection(scontext, 0, remoteEP,
-                        [timeout, network, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+            const UpstreamPtr upstream = SelectUpstream();
+            const UInt64 token = configuration_->Resume ? Connection::NewResumeToken() : 0;
+            return ResolveAddress(upstream->endpoint_.Inbound.Domain, upstream->endpoint_.Inbound.IP, upstream->endpoint_.Inbound.Port,
+                [upstream, token, scontext, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    if (!ConnectConnection(scontext, upstream, 0, 0, remoteEP,
+                        [upstream, token, timeout, network, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
                             const ITransmissionPtr inbound = transmission;
-                            return ResolveAddress(configuration_->Outbound.Domain, configuration_->Outbound.IP, configuration_->Outbound.Port,
-                                [channelId, inbound, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
-                                    if (!ConnectConnection(inbound->GetContext(), channelId, remoteEP,
-                                        [inbound, timeout, network, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                            return ResolveAddress(upstream->endpoint_.Outbound.Domain, upstream->endpoint_.Outbound.IP, upstream->endpoint_.Outbound.Port,
+                                [upstream, token, channelId, inbound, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                                    if (!ConnectConnection(inbound->GetContext(), upstream, channelId, token, remoteEP,
+                                        [upstream, token, inbound, timeout, network, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
                                             ITransmissionPtr outbound = transmission;
-                                            return CloseIfNotSuccess(Connection::HelloAsync(outbound,
-                                                [channelId, inbound, outbound, timeout, network, references, this](bool success) noexcept {
-                                                    ClearTimeout(timeout);
-                                                    if (success) {
-                                                        if (channelId >> 31) {
-                                                            success = Accept(network, channelId, outbound, inbound);
-                                                        }
-                                                        else {
-                                                            success = Accept(network, channelId, inbound, outbound);
-                                                        }
-                                                    }
-                                                    CloseIfNotSuccess(success, timeout, network, inbound, outbound);
-                                                }), timeout, network, inbound, outbound);
+
+                                            /* 0-RTT: the server's hello is consumed by the connection's inbound
+                                             * loop instead of a dedicated wait, so the first payload rides in
+                                             * the same flight as the channel-id frame. */
+                                            ClearTimeout(timeout);
+
+                                            bool success = false;
+                                            if (channelId >> 31) {
+                                                success = Accept(network, channelId, outbound, inbound, true, upstream, token);
+                                            }
+                                            else {
+                                                success = Accept(network, channelId, inbound, outbound, true, upstream, token);
+                                            }
+                                            return CloseIfNotSuccess(success, timeout, network, inbound, outbound);
                                         })) {
                                         ClearTimeout(timeout);
                                         inbound->Close();
@@ -211,7 +429,7 @@ namespace uds {
                 });
         }
 
-        bool Router::Accept(const AsioTcpSocket& network, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+        bool Router::Accept(const AsioTcpSocket& network, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, bool early, const UpstreamPtr& upstream, UInt64 token) noexcept {
             if (!network || !inbound || !outbound || !channel) {
                 return false;
             }
@@ -219,11 +437,26 @@ namespace uds {
             /* CHANNEL: C <-> S: RX(outbound) <-> TX(inbound). */
             ConnectionPtr connection = CreateConnection(channel, outbound, inbound);
             if (connection) {
+                if (early) {
+                    connection->DeferHello();
+                }
+
                 std::shared_ptr<Reference> references = GetReference();
+                if (token != 0 && upstream && connection->SetResumable(token)) {
+                    /* A flap hands the channel back here: redial the pop that minted
+                     * the pairing - the token means nothing anywhere else. */
+                    const UpstreamPtr supstream = upstream;
+                    connection->ResumeEvent = [references, this, supstream, token](Connection* connection) noexcept {
+                        return ResumeConnection(connection->Id, supstream, token);
+                    };
+                }
+
                 connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                    MutexScope scope(syncobj_);
                     Dictionary::TryRemove(connections_, connection->Id);
                 };
                 if (connection->Listen(network)) {
+                    MutexScope scope(syncobj_);
                     if (Dictionary::TryAdd(connections_, channel, connection)) {
                         return true;
                     }
@@ -233,16 +466,699 @@ namespace uds {
             return false;
         }
 
-        bool Router::ConnectConnection(const AsioContext& context, int channelId, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept {
+        bool Router::AcceptMuxClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            /* Mux-fronted flows relay against the shared pipe, which always dials
+             * from context_: re-home the accepted socket there so channel reads and
+             * writes never leave the pipe's context (accepts land on the least
+             * loaded context, which is almost never the pipe's). */
+            AsioTcpSocket rehomed = socket;
+            AsioContext rcontext = context;
+            Socket::RehomeSocket(rcontext, rehomed, context_);
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioTcpSocket network = rehomed;
+            const auto timeout = timewheel_->SetTimeout(
+                [network, references, this](void* key) noexcept {
+                    Socket::Closesocket(network);
+                }, (UInt64)configuration_->Connect.Timeout * 1000);
+
+            return EstablishMux(
+                [timeout, network, references, this](const MuxPtr& mux) noexcept {
+                    if (timeout) {
+                        TimingWheel::ClearTimeout(constantof(timeout));
+                    }
+
+                    bool success = false;
+                    if (mux) {
+                        int channelId = 0;
+                        ITransmissionPtr channel = mux->OpenChannel(channelId);
+                        if (channel) {
+                            /* A logical channel is both halves of the pipe: the relay reads
+                             * and writes the same transmission facade. */
+                            ConnectionPtr connection = NewReference<Connection>(mux->GetConfiguration(), channelId, channel, channel);
+                            if (connection) {
+                                connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                                    MutexScope scope(syncobj_);
+                                    Dictionary::TryRemove(connections_, connection->Id);
+                                };
+                                if (connection->Listen(network)) {
+                                    MutexScope scope(syncobj_);
+                                    success = Dictionary::TryAdd(connections_, channelId, connection);
+                                }
+
+                                if (!success) {
+                                    connection->Close();
+                                }
+                            }
+
+                            if (!success) {
+                                channel->Close();
+                            }
+                        }
+                    }
+
+                    if (!success) {
+                        Socket::Closesocket(network);
+                    }
+                });
+        }
+
+        bool Router::EstablishMux(MuxAsyncCallback&& callback) noexcept {
+            MuxPtr mux; {
+                MutexScope scope(syncobj_);
+                mux = mux_;
+                if (!mux || !mux->Available()) {
+                    mux = NULL;
+                    muxwaits_.push_back(std::move(callback));
+                    if (muxing_) {
+                        return true;
+                    }
+                    muxing_ = true;
+                }
+            }
+
+            if (mux) {
+                callback(mux);
+                return true;
+            }
+
+            if (ConnectMux()) {
+                return true;
+            }
+
+            FlushMuxWaits(NULL);
+            return false;
+        }
+
+        bool Router::ConnectMux() noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const UpstreamPtr upstream = SelectUpstream();
+            return ResolveAddress(upstream->endpoint_.Inbound.Domain, upstream->endpoint_.Inbound.IP, upstream->endpoint_.Inbound.Port,
+                [upstream, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    if (!ConnectConnection(context_, upstream, 0, 0, remoteEP,
+                        [upstream, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                            const ITransmissionPtr inbound = transmission;
+                            return ResolveAddress(upstream->endpoint_.Outbound.Domain, upstream->endpoint_.Outbound.IP, upstream->endpoint_.Outbound.Port,
+                                [upstream, channelId, inbound, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                                    if (!ConnectConnection(inbound->GetContext(), upstream, channelId, 0, remoteEP,
+                                        [inbound, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                                            const ITransmissionPtr outbound = transmission;
+                                            bool success = Connection::HelloAsync(outbound,
+                                                [channelId, inbound, outbound, references, this](bool success) noexcept {
+                                                    if (success) {
+                                                        if (channelId >> 31) {
+                                                            success = OnMuxEstablished(inbound, outbound);
+                                                        }
+                                                        else {
+                                                            success = OnMuxEstablished(outbound, inbound);
+                                                        }
+                                                    }
+
+                                                    if (!success) {
+                                                        inbound->Close();
+                                                        outbound->Close();
+                                                        FlushMuxWaits(NULL);
+                                                    }
+                                                });
+                                            if (!success) {
+                                                inbound->Close();
+                                                FlushMuxWaits(NULL);
+                                            }
+                                            return success;
+                                        })) {
+                                        inbound->Close();
+                                        FlushMuxWaits(NULL);
+                                    }
+                                });
+                        })) {
+                        FlushMuxWaits(NULL);
+                    }
+                });
+        }
+
+        bool Router::OnMuxEstablished(const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            MuxPtr mux = NewReference<Mux>(GetSnapshot(), reader, writer);
+            if (!mux) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            mux->DisposedEvent = [references, this](Mux* mux) noexcept {
+                MutexScope scope(syncobj_);
+                if (mux_.get() == mux) {
+                    mux_.reset(); /* The next accepted socket redials the pipe. */
+                }
+            };
+
+            if (!mux->Run()) {
+                mux->Close();
+                return false;
+            }
+
+            {
+                MutexScope scope(syncobj_);
+                mux_ = mux;
+            }
+
+            FlushMuxWaits(mux);
+            return true;
+        }
+
+        bool Router::AcceptBondClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            class BondContext final {
+            public:
+                Mutex                           syncobj_;
+                int                             completed_ = 0;
+                bool                            failed_    = false;
+                int                             gid_       = 0;
+                std::vector<ITransmissionPtr>   readers_;
+                std::vector<ITransmissionPtr>   writers_;
+            };
+
+            const int bonding = configuration_->Bonding;
+            const std::shared_ptr<BondContext> bond = make_shared_object<BondContext>();
+            if (!bond) {
+                return false;
+            }
+
+            bond->readers_.resize(bonding);
+            bond->writers_.resize(bonding);
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioTcpSocket network = socket;
+            const AsioContext scontext = context;
+            const auto timeout = timewheel_->SetTimeout(
+                [network, references, this](void* key) noexcept {
+                    Socket::Closesocket(network);
+                }, (UInt64)configuration_->Connect.Timeout * 1000);
+
+            /* Every member pair lands here; the last one to arrive welds the bond. */
+            const auto complete = make_shared_object<std::function<void(int, const ITransmissionPtr&, const ITransmissionPtr&)>>(
+                [bond, bonding, timeout, network, references, this](int index, const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept {
+                    bool finished = false;
+                    bool failed = false; {
+                        MutexScope scope(bond->syncobj_);
+                        if (reader && writer) {
+                            bond->readers_[index] = reader;
+                            bond->writers_[index] = writer;
+                        }
+                        else {
+                            bond->failed_ = true;
+                        }
+
+                        if (++bond->completed_ >= bonding) {
+                            finished = true;
+                            failed = bond->failed_;
+                        }
+                    }
+
+                    if (!finished) {
+                        return;
+                    }
+
+                    if (timeout) {
+                        TimingWheel::ClearTimeout(constantof(timeout));
+                    }
+
+                    bool success = false;
+                    if (!failed) {
+                        /* CHANNEL: C <-> S: RX(bonded readers) <-> TX(bonded writers). */
+                        ITransmissionPtr rx = NewReference2<ITransmission, Bond>(bond->readers_, configuration_->Alignment);
+                        ITransmissionPtr tx = NewReference2<ITransmission, Bond>(bond->writers_, configuration_->Alignment);
+                        if (rx && tx) {
+                            rx = rx->Constructor(rx);
+                            tx = tx->Constructor(tx);
+
+                            int gid = bond->gid_;
+                            ConnectionPtr connection = NewReference<Connection>(GetSnapshot(), gid, rx, tx);
+                            if (connection) {
+                                connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                                    MutexScope scope(syncobj_);
+                                    Dictionary::TryRemove(connections_, connection->Id);
+                                };
+                                if (connection->Listen(network)) {
+                                    MutexScope scope(syncobj_);
+                                    success = Dictionary::TryAdd(connections_, gid, connection);
+                                }
+
+                                if (!success) {
+                                    connection->Close();
+                                }
+                            }
+                        }
+                    }
+
+                    if (!success) {
+                        for (int i = 0; i < bonding; i++) {
+                            const ITransmissionPtr& reader = bond->readers_[i];
+                            if (reader) {
+                                reader->Close();
+                            }
+
+                            const ITransmissionPtr& writer = bond->writers_[i];
+                            if (writer) {
+                                writer->Close();
+                            }
+                        }
+                        Socket::Closesocket(network);
+                    }
+                });
+
+            /* The leader pair fixes the group id; the remaining members dial in
+             * parallel once it is known and join the group by echoing it. Every
+             * member targets the leader's pop: the group id is only known there. */
+            const UpstreamPtr upstream = SelectUpstream();
+            return EstablishBondPair(scontext, upstream, 0,
+                [upstream, bond, bonding, complete, scontext, references, this](const ITransmissionPtr& reader, const ITransmissionPtr& writer, int channelId) noexcept {
+                    if (!reader || !writer) {
+                        for (int i = 1; i < bonding; i++) {
+                            (*complete)(i, NULL, NULL);
+                        }
+                        (*complete)(0, NULL, NULL);
+                        return;
+                    }
+
+                    {
+                        MutexScope scope(bond->syncobj_);
+                        bond->gid_ = channelId;
+                    }
+
+                    for (int i = 1; i < bonding; i++) {
+                        const int index = i;
+                        if (!EstablishBondPair(scontext, upstream, channelId,
+                            [index, complete](const ITransmissionPtr& reader, const ITransmissionPtr& writer, int channelId) noexcept {
+                                (*complete)(index, reader, writer);
+                            })) {
+                            (*complete)(index, NULL, NULL);
+                        }
+                    }
+                    (*complete)(0, reader, writer);
+                });
+        }
+
+        bool Router::EstablishPair(const AsioContext& context, EstablishPairAsyncCallback&& callback) noexcept {
+            return EstablishPair(context, SelectUpstream(), std::forward<EstablishPairAsyncCallback>(callback));
+        }
+
+        bool Router::EstablishPair(const AsioContext& context, const UpstreamPtr& upstream, EstablishPairAsyncCallback&& callback) noexcept {
+            return EstablishPair(context, upstream, 0, std::forward<EstablishPairAsyncCallback>(callback));
+        }
+
+        bool Router::EstablishPair(const AsioContext& context, const UpstreamPtr& upstream, UInt64 token, EstablishPairAsyncCallback&& callback) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const EstablishPairAsyncCallback scallback = callback;
+            const UpstreamPtr supstream = upstream;
+
+            return ResolveAddress(supstream->endpoint_.Inbound.Domain, supstream->endpoint_.Inbound.IP, supstream->endpoint_.Inbound.Port,
+                [supstream, scallback, token, context, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    if (!ConnectConnection(context, supstream, 0, 0, remoteEP,
+                        [supstream, scallback, token, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                            const ITransmissionPtr inbound = transmission;
+                            return ResolveAddress(supstream->endpoint_.Outbound.Domain, supstream->endpoint_.Outbound.IP, supstream->endpoint_.Outbound.Port,
+                                [supstream, scallback, token, channelId, inbound, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                                    if (!ConnectConnection(inbound->GetContext(), supstream, channelId, token, remoteEP,
+                                        [scallback, inbound, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                                            const ITransmissionPtr outbound = transmission;
+                                            bool success = Connection::HelloAsync(outbound,
+                                                [scallback, channelId, inbound, outbound, references, this](bool success) noexcept {
+                                                    if (success) {
+                                                        /* CHANNEL: C <-> S: RX(reader) <-> TX(writer). */
+                                                        if (channelId >> 31) {
+                                                            scallback(inbound, outbound, channelId);
+                                                        }
+                                                        else {
+                                                            scallback(outbound, inbound, channelId);
+                                                        }
+                                                    }
+                                                    else {
+                                                        inbound->Close();
+                                                        outbound->Close();
+                                                        scallback(NULL, NULL, 0);
+                                                    }
+                                                });
+                                            if (!success) {
+                                                inbound->Close();
+                                                scallback(NULL, NULL, 0);
+                                            }
+                                            return success;
+                                        })) {
+                                        inbound->Close();
+                                        scallback(NULL, NULL, 0);
+                                    }
+                                });
+                        })) {
+                        scallback(NULL, NULL, 0);
+                    }
+                });
+        }
+
+        bool Router::EstablishBondPair(const AsioContext& context, const UpstreamPtr& upstream, int gid, EstablishPairAsyncCallback&& callback) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const EstablishPairAsyncCallback scallback = callback;
+            const int sgid = gid;
+
+            return EstablishPair(context, upstream,
+                [sgid, scallback, references, this](const ITransmissionPtr& reader, const ITransmissionPtr& writer, int channelId) noexcept {
+                    if (!reader || !writer) {
+                        scallback(NULL, NULL, 0);
+                        return;
+                    }
+
+                    /* Joining frame: every member (the leader included) tells the
+                     * peer which group it belongs to over its write side. */
+                    int gid = sgid ? sgid : channelId;
+                    if (!Connection::ConnectAsync(writer, configuration_->Alignment, gid,
+                        [scallback, reader, writer, gid](bool success, int) noexcept {
+                            if (success) {
+                                scallback(reader, writer, gid);
+                            }
+                            else {
+                                reader->Close();
+                                writer->Close();
+                                scallback(NULL, NULL, 0);
+                            }
+                        })) {
+                        reader->Close();
+                        writer->Close();
+                        scallback(NULL, NULL, 0);
+                    }
+                });
+        }
+
+        void Router::PoolChannel::Close() noexcept {
+            ITransmissionPtr reader = std::move(reader_);
+            reader_.reset();
+            if (reader) {
+                reader->Close();
+            }
+
+            ITransmissionPtr writer = std::move(writer_);
+            writer_.reset();
+            if (writer) {
+                writer->Close();
+            }
+        }
+
+        Router::UpstreamPtr Router::SelectUpstream() noexcept {
+            MutexScope scope(syncobj_); /* A reload may swap the pop list underneath. */
+            std::size_t concurrent = upstreams_.size();
+            if (concurrent < 2) {
+                return concurrent > 0 ? upstreams_[0] : NULL;
+            }
+
+            /* Lowest dial latency wins, each pending failure weighing in as an extra
+             * 100ms; a rotating scan origin breaks ties round-robin so even pops
+             * share the channels instead of the first one taking them all. */
+            uint64_t now = hosting_->CurrentMillisec();
+            std::size_t offset = upstream_rotate_++;
+            UpstreamPtr best;
+            uint64_t    score = UINT64_MAX;
+            for (std::size_t i = 0; i < concurrent; i++) {
+                const UpstreamPtr& upstream = upstreams_[(offset + i) % concurrent];
+                if (now < upstream->blackout_.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+
+                uint64_t latency = upstream->latency_.load(std::memory_order_relaxed);
+                uint64_t penalty = (uint64_t)upstream->failures_.load(std::memory_order_relaxed) * 100;
+                if (latency + penalty < score) {
+                    score = latency + penalty;
+                    best = upstream;
+                }
+            }
+
+            if (!best) {
+                best = upstreams_[offset % concurrent]; /* Every pop is blacked out: probe them round-robin. */
+            }
+            return best;
+        }
+
+        void Router::ReportUpstream(const UpstreamPtr& upstream, uint64_t startedAt, bool success) noexcept {
+            if (!upstream) {
+                return;
+            }
+
+            if (success) {
+                uint64_t now = hosting_->CurrentMillisec();
+                uint64_t sample = now > startedAt ? now - startedAt : 0;
+                uint64_t latency = upstream->latency_.load(std::memory_order_relaxed);
+                if (latency) {
+                    latency = (latency - (latency >> 3)) + (sample >> 3); /* EWMA, alpha 1/8. */
+                }
+                else {
+                    latency = sample;
+                }
+
+                upstream->latency_.store(latency, std::memory_order_relaxed);
+                upstream->failures_.store(0, std::memory_order_relaxed);
+                upstream->blackout_.store(0, std::memory_order_relaxed);
+                return;
+            }
+
+            uint32_t failures = upstream->failures_.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (failures < EUPSTREAM_BLACKOUT_FAILURES) {
+                return;
+            }
+
+            upstream->blackout_.store(hosting_->CurrentMillisec() + EUPSTREAM_BLACKOUT_TIMEOUT, std::memory_order_relaxed);
+
+            /* Fast failover: warm pairs parked on a blacked-out pop are dead weight,
+             * so recycle them now and let the replenish dial a healthy pop instead. */
+            std::vector<PoolChannelPtr> closes; {
+                MutexScope scope(syncobj_);
+                if (upstreams_.size() < 2) {
+                    return; /* Nowhere to fail over to: keep the pool dialing the only pop. */
+                }
+
+                for (auto tail = pools_.begin(); tail != pools_.end();) {
+                    PoolChannelPtr& pool = *tail;
+                    if (pool->upstream_ == upstream) {
+                        closes.push_back(std::move(pool));
+                        tail = pools_.erase(tail);
+                    }
+                    else {
+                        ++tail;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0, len = closes.size(); i < len; i++) {
+                const PoolChannelPtr& pool = closes[i];
+                ClearTimeout(pool.get());
+                ClearTimeout(pool->reader_.get());
+                pool->Close();
+            }
+
+            if (closes.size() > 0) {
+                ReplenishPool();
+            }
+        }
+
+        bool Router::ReplenishPool() noexcept {
+            if (disposed_ || configuration_->Mux || configuration_->Bonding > 1) {
+                return false;
+            }
+
+            int need = 0; {
+                MutexScope scope(syncobj_);
+                need = configuration_->Pool - pooling_ - (int)pools_.size();
+                if (need < 1) {
+                    return false;
+                }
+                pooling_ += need;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            for (int i = 0; i < need; i++) {
+                const UpstreamPtr upstream = SelectUpstream();
+                const UInt64 token = configuration_->Resume ? Connection::NewResumeToken() : 0;
+                if (!EstablishPair(context_, upstream, token,
+                    [upstream, token, references, this](const ITransmissionPtr& reader, const ITransmissionPtr& writer, int channelId) noexcept {
+                        PoolChannelPtr pool;
+                        if (reader && writer) {
+                            pool = make_shared_object<PoolChannel>();
+                            if (pool) {
+                                pool->channel_ = channelId;
+                                pool->reader_ = reader;
+                                pool->writer_ = writer;
+                                pool->upstream_ = upstream;
+                                pool->token_ = token;
+                            }
+                        }
+
+                        bool success = false; {
+                            MutexScope scope(syncobj_);
+                            pooling_--;
+                            if (pool && !disposed_) {
+                                pools_.push_back(pool);
+                                success = true;
+                            }
+                        }
+
+                        if (!success) {
+                            if (reader) {
+                                reader->Close();
+                            }
+
+                            if (writer) {
+                                writer->Close();
+                            }
+
+                            /* The dial failed: retry with a breather instead of hammering the switches. */
+                            AddTimeout(this, timewheel_->SetTimeout(
+                                [references, this](void* key) noexcept {
+                                    ClearTimeout(key);
+                                    ReplenishPool();
+                                }, 1000));
+                            return;
+                        }
+
+                        /* A parked pair goes stale behind NATs and middleboxes: recycle
+                         * it before the peer's silence limits are reached. */
+                        AddTimeout(pool.get(), timewheel_->SetTimeout(
+                            [pool, references, this](void* key) noexcept {
+                                ClearTimeout(key);
+                                if (ClosePool(pool)) {
+                                    ReplenishPool();
+                                }
+                            }, (UInt64)EPOOL_RECYCLE_TIMEOUT));
+
+                        if (configuration_->KeepAlived) {
+                            PoolKeepAlivedSendCycle(pool);
+                        }
+                    })) {
+                    MutexScope scope(syncobj_);
+                    pooling_--;
+                }
+            }
+            return true;
+        }
+
+        Router::PoolChannelPtr Router::PopPool() noexcept {
+            PoolChannelPtr pool; {
+                MutexScope scope(syncobj_);
+                auto tail = pools_.begin();
+                if (tail != pools_.end()) {
+                    pool = std::move(*tail);
+                    pools_.erase(tail);
+                }
+            }
+
+            if (pool) {
+                /* Both pool timers stop here: the connection owns the pair's keep-alive from now on. */
+                ClearTimeout(pool.get());
+                ClearTimeout(pool->reader_.get());
+            }
+            return pool;
+        }
+
+        bool Router::ClosePool(const PoolChannelPtr& pool) noexcept {
+            if (!pool) {
+                return false;
+            }
+
+            bool removed = false; {
+                MutexScope scope(syncobj_);
+                for (auto tail = pools_.begin(); tail != pools_.end(); ++tail) {
+                    if (*tail == pool) {
+                        pools_.erase(tail);
+                        removed = true;
+                        break;
+                    }
+                }
+            }
+
+            if (removed) {
+                /* A popped pair belongs to a connection now: never close it from here. */
+                ClearTimeout(pool.get());
+                ClearTimeout(pool->reader_.get());
+                pool->Close();
+            }
+            return removed;
+        }
+
+        bool Router::PoolKeepAlivedSendCycle(const PoolChannelPtr& pool) noexcept {
+            if (disposed_ || !pool) {
+                return false;
+            }
+
+            bool pooled = false; {
+                MutexScope scope(syncobj_);
+                for (PoolChannelPtr& i : pools_) {
+                    if (i == pool) {
+                        pooled = true;
+                        break;
+                    }
+                }
+            }
+
+            if (!pooled) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const PoolChannelPtr spool = pool;
+            return AddTimeout(pool->reader_.get(), timewheel_->SetTimeout(
+                [references, this, spool](void* key) noexcept {
+                    ClearTimeout(key);
+
+                    std::shared_ptr<Byte> messages = uds::threading::BufferslabPool::Alloc(64);
+                    if (!messages) {
+                        if (ClosePool(spool)) {
+                            ReplenishPool();
+                        }
+                        return;
+                    }
+
+                    int packet_size = RandomNext(8, 64);
+                    RandomAsciiFill(messages.get(), packet_size);
+
+                    /* Junk flows on the pair's read side, exactly as the connection
+                     * will run it after the hand-out; the peer drains and discards it. */
+                    if (!spool->reader_->WriteAsync(messages, 0, packet_size,
+                        [references, this, spool](bool success) noexcept {
+                            if (success) {
+                                success = PoolKeepAlivedSendCycle(spool);
+                            }
+
+                            if (!success && ClosePool(spool)) {
+                                ReplenishPool();
+                            }
+                        })) {
+                        if (ClosePool(spool)) {
+                            ReplenishPool();
+                        }
+                    }
+                }, (UInt64)RandomNext(100, 500)));
+        }
+
+        void Router::FlushMuxWaits(const MuxPtr& mux) noexcept {
+            std::list<MuxAsyncCallback> muxwaits; {
+                MutexScope scope(syncobj_);
+                muxing_ = false;
+                muxwaits = std::move(muxwaits_);
+                muxwaits_.clear();
+            }
+
+            for (MuxAsyncCallback& callback : muxwaits) {
+                callback(mux);
+            }
+        }
+
+        bool Router::ConnectConnection(const AsioContext& context, const UpstreamPtr& upstream, int channelId, UInt64 token, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept {
             const std::shared_ptr<Reference> references = GetReference();
             const ConnectConnectionAsyncCallback scallback = callback;
 
-            return ConnectTransmission(context, remoteEP,
-                [channelId, scallback, references, this](const ITransmissionPtr& transmission) noexcept {
+            return ConnectTransmission(context, upstream, remoteEP,
+                [channelId, token, scallback, references, this](const ITransmissionPtr& transmission) noexcept {
                     using ConnectAsyncCallback = Connection::ConnectAsyncCallback;
 
                     ITransmissionPtr transmission_ = transmission;
-                    if (!AddTimeout(transmission_.get(), uds::threading::SetTimeout(hosting_,
+                    if (!AddTimeout(transmission_.get(), timewheel_->SetTimeout(
                         [references, this, transmission_](void* key) noexcept {
                             ClearTimeout(key);
                             transmission_->Close();
@@ -263,7 +1179,7 @@ namespace uds {
 
                     bool success = false;
                     if (channelId) {
-                        success = Connection::ConnectAsync(transmission, configuration_->Alignment, channelId, std::forward<ConnectAsyncCallback>(f));
+                        success = Connection::ConnectAsync(transmission, configuration_->Alignment, channelId, token, std::forward<ConnectAsyncCallback>(f));
                     }
                     else {
                         success = Connection::ConnectAsync(transmission, std::forward<ConnectAsyncCallback>(f));
@@ -276,23 +1192,182 @@ namespace uds {
                 });
         }
 
-        bool Router::ConnectTransmission(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectTransmissionAsyncCallback&& callback) noexcept {
+        bool Router::ResumeConnection(int channel, const UpstreamPtr& upstream, UInt64 token) noexcept {
+            if (disposed_ || !upstream || !token) {
+                return false;
+            }
+
+            ConnectionPtr connection; {
+                MutexScope scope(syncobj_);
+                Dictionary::TryGetValue(connections_, channel, connection);
+            }
+
+            if (!connection || !connection->Detached()) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const ConnectionPtr sconnection = connection;
+            const UpstreamPtr supstream = upstream;
+
+            /* The redial mirrors EstablishPair, but the joining frame is a takeover
+             * naming the token, and the hello is chased by the switches' received
+             * acknowledgement; any miss backs off and dials again until the
+             * channel's own resume window gives up. */
+            const auto retry = [references, this, channel, supstream, token]() noexcept {
+                RetryResumeConnection(channel, supstream, token);
+            };
+
+            return ResolveAddress(supstream->endpoint_.Inbound.Domain, supstream->endpoint_.Inbound.IP, supstream->endpoint_.Inbound.Port,
+                [sconnection, supstream, token, retry, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    if (!ConnectConnection(context_, supstream, 0, 0, remoteEP,
+                        [sconnection, supstream, token, retry, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                            const ITransmissionPtr inbound = transmission;
+                            return ResolveAddress(supstream->endpoint_.Outbound.Domain, supstream->endpoint_.Outbound.IP, supstream->endpoint_.Outbound.Port,
+                                [sconnection, supstream, token, channelId, inbound, retry, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                                    if (!ConnectTransmission(inbound->GetContext(), supstream, remoteEP,
+                                        [sconnection, token, channelId, inbound, retry, references, this](const ITransmissionPtr& transmission) noexcept {
+                                            const ITransmissionPtr outbound = transmission;
+                                            if (!AddTimeout(outbound.get(), timewheel_->SetTimeout(
+                                                [references, this, outbound](void* key) noexcept {
+                                                    ClearTimeout(key);
+                                                    outbound->Close();
+                                                }, (UInt64)configuration_->Connect.Timeout * 1000))) {
+                                                return false;
+                                            }
+
+                                            bool success = Connection::ConnectResumeAsync(outbound, configuration_->Alignment, channelId, token, sconnection->GetInboundBytes(),
+                                                [sconnection, channelId, inbound, outbound, retry, references, this](bool handshaked, int) noexcept {
+                                                    ClearTimeout(outbound.get());
+                                                    if (handshaked) {
+                                                        handshaked = Connection::HelloAsync(outbound,
+                                                            [sconnection, channelId, inbound, outbound, retry, references, this](bool success) noexcept {
+                                                                /* CHANNEL: C <-> S: RX(reader) <-> TX(writer). */
+                                                                ITransmissionPtr reader = outbound;
+                                                                ITransmissionPtr writer = inbound;
+                                                                if (channelId >> 31) {
+                                                                    reader = inbound;
+                                                                    writer = outbound;
+                                                                }
+
+                                                                if (success) {
+                                                                    const ITransmissionPtr sreader = reader;
+                                                                    const ITransmissionPtr swriter = writer;
+                                                                    success = Connection::AcceptResumeAsync(sreader,
+                                                                        [sconnection, sreader, swriter, retry, references, this](bool success, UInt64 received) noexcept {
+                                                                            if (success) {
+                                                                                success = sconnection->Reattach(sreader, swriter, received, false);
+                                                                            }
+
+                                                                            if (!success) {
+                                                                                sreader->Close();
+                                                                                swriter->Close();
+                                                                                retry();
+                                                                            }
+                                                                        });
+                                                                }
+
+                                                                if (!success) {
+                                                                    reader->Close();
+                                                                    writer->Close();
+                                                                    retry();
+                                                                }
+                                                            });
+                                                    }
+
+                                                    if (!handshaked) {
+                                                        inbound->Close();
+                                                        outbound->Close();
+                                                        retry();
+                                                    }
+                                                });
+                                            if (!success) {
+                                                ClearTimeout(outbound.get());
+                                            }
+                                            return success;
+                                        })) {
+                                        inbound->Close();
+                                        retry();
+                                    }
+                                });
+                        })) {
+                        retry();
+                    }
+                });
+        }
+
+        bool Router::RetryResumeConnection(int channel, const UpstreamPtr& upstream, UInt64 token) noexcept {
+            static const int ERESUME_RETRY_INTERVAL = 500;
+
+            if (disposed_) {
+                return false;
+            }
+
+            ConnectionPtr connection; {
+                MutexScope scope(syncobj_);
+                Dictionary::TryGetValue(connections_, channel, connection);
+            }
+
+            if (!connection || !connection->Detached()) { /* Already resumed or reclaimed. */
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const UpstreamPtr supstream = upstream;
+            return AddTimeout(connection.get(), timewheel_->SetTimeout(
+                [references, this, channel, supstream, token](void* key) noexcept {
+                    ClearTimeout(key);
+                    if (!ResumeConnection(channel, supstream, token)) {
+                        RetryResumeConnection(channel, supstream, token);
+                    }
+                }, ERESUME_RETRY_INTERVAL));
+        }
+
+        bool Router::ConnectTransmission(const AsioContext& context, const UpstreamPtr& upstream, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectTransmissionAsyncCallback&& callback) noexcept {
             const std::shared_ptr<Reference> references = GetReference();
             const AsioContext scontext = context;
             const ConnectTransmissionAsyncCallback scallback = callback;
+            const UpstreamPtr supstream = upstream;
 
-            return ConnectClient(context, remoteEP,
-                [scallback, scontext, references, this](const std::shared_ptr<boost::asio::ip::tcp::socket>& network, bool success) noexcept {
+            if (configuration_->Protocol == AppConfiguration::ProtocolType_UDP) {
+                /* Datagram mode dials no stream at all: the transmission opens its own
+                 * udp socket and the SYN exchange is the whole transport handshake. */
+                const uint64_t startedAt = hosting_->CurrentMillisec();
+                boost::asio::ip::udp::endpoint datagramEP(remoteEP.address(), remoteEP.port());
+                ITransmissionPtr transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::UdpTransmission>(hosting_, context, datagramEP, configuration_->Alignment);
+                transmission = transmission->Constructor(transmission);
+                return HandshakeTransmission(transmission,
+                    [supstream, startedAt, scallback, references, this](const ITransmissionPtr& transmission, bool handshaked) noexcept {
+                        ReportUpstream(supstream, startedAt, handshaked);
+                        if (handshaked) {
+                            handshaked = scallback(transmission);
+                        }
+
+                        if (!handshaked) {
+                            if (transmission) {
+                                transmission->Close();
+                            }
+                        }
+                    });
+            }
+
+            return ConnectClient(context, upstream, remoteEP,
+                [supstream, scallback, scontext, references, this](const std::shared_ptr<boost::asio::ip::tcp::socket>& network, bool success) noexcept {
                     if (!success) {
                         return false;
                     }
 
                     const std::shared_ptr<boost::asio::ip::tcp::socket> snetwork = network;
                     return HandshakeTransmission(scontext, network,
-                        [snetwork, scallback, references, this](const ITransmissionPtr& transmission, bool handshaked) noexcept {
+                        [supstream, snetwork, scallback, references, this](const ITransmissionPtr& transmission, bool handshaked) noexcept {
                             if (handshaked) {
                                 handshaked = scallback(transmission);
                             }
+                            else {
+                                /* The stream connected but the protocol never came up: that
+                                 * is the pop degrading, not the path - count it against it. */
+                                ReportUpstream(supstream, hosting_->CurrentMillisec(), false);
+                            }
 
                             if (!handshaked) {
                                 if (transmission) {
@@ -304,7 +1379,7 @@ namespace uds {
                 });
         }
 
-        bool Router::ConnectClient(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectClientAsyncCallback&& callback) noexcept {
+        bool Router::ConnectClient(const AsioContext& context, const UpstreamPtr& upstream, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectClientAsyncCallback&& callback) noexcept {
             const std::shared_ptr<boost::asio::ip::tcp::socket> network = Connection::NewRemoteSocket(configuration_, context, remoteEP);
             if (!network) {
                 return false;
@@ -312,8 +1387,10 @@ namespace uds {
 
             const std::shared_ptr<Reference> references = GetReference();
             const ConnectClientAsyncCallback scallback = callback;
+            const UpstreamPtr supstream = upstream;
+            const uint64_t startedAt = hosting_->CurrentMillisec();
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), timewheel_->SetTimeout(
                 [references, this, network](void* key) noexcept {
                     ClearTimeout(key);
                     Socket::Closesocket(*network);
@@ -323,11 +1400,17 @@ namespace uds {
             }
 
             network->async_connect(remoteEP,
-                [references, this, network, scallback](const boost::system::error_code& ec) noexcept {
+                [references, this, network, scallback, supstream, startedAt](const boost::system::error_code& ec) noexcept {
                     Router::ClearTimeout(network.get());
 
+                    /* The dial outcome and its latency feed the pop's health record;
+                     * what the layers above make of the socket is not held against it. */
+                    ReportUpstream(supstream, startedAt, ec ? false : true);
+
                     bool success = ec ? false : true;
                     if (success) {
+                        /* The connect handshake measured an RTT: resize toward the BDP. */
+                        Socket::AdjustSocketBuffers(Socket::GetHandle(*network));
                         success = scallback(network, success);
                     }
 
@@ -388,7 +1471,7 @@ namespace uds {
             const std::shared_ptr<uds::transmission::ITransmission> network = transmission;
             const HandshakeAsyncCallback scallback = callback;
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), timewheel_->SetTimeout(
                 [reference, this, network, scallback](void* key) noexcept {
                     ClearTimeout(key);
                     network->Close();
@@ -400,6 +1483,7 @@ namespace uds {
             return transmission->HandshakeAsync(uds::transmission::ITransmission::HandshakeType_Client, /* In order to extend the transport layer medium. */
                 [reference, this, network, scallback](bool handshaked) noexcept {
                     ClearTimeout(network.get());
+                    UDS_TRACE3(handshake, 2, 0, handshaked);
                     if (handshaked) {
                         scallback(network, handshaked);
                     }
@@ -428,7 +1512,7 @@ namespace uds {
                 return NULL;
             }
 
-            return NewReference<Connection>(configuration_, channel, inbound, outbound);
+            return NewReference<Connection>(GetSnapshot(), channel, inbound, outbound);
         }
 
         Router::ITransmissionPtr Router::CreateTransmission(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
@@ -448,12 +1532,21 @@ namespace uds {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::EncryptorTransmission>(hosting_, context, socket,
                     configuration_->Protocols.Encryptor.Method,
                     configuration_->Protocols.Encryptor.Password,
-                    configuration_->Alignment);
+                    configuration_->Alignment,
+                    configuration_->Protocols.Encryptor.Offload);
+            }
+            elif(configuration_->Protocol == AppConfiguration::ProtocolType_ChaCha20Poly1305) {
+                transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::ChaCha20Poly1305Transmission>(hosting_, context, socket,
+                    configuration_->Protocols.Encryptor.Password,
+                    configuration_->Alignment,
+                    configuration_->Protocols.Encryptor.Offload);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::WebSocketTransmission>(hosting_, context, socket,
                     configuration_->Protocols.WebSocket.Host,
                     configuration_->Protocols.WebSocket.Path,
+                    configuration_->Protocols.WebSocket.Compression,
+                    configuration_->Protocols.WebSocket.CompressionThreshold,
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket_SSL ||
@@ -461,6 +1554,8 @@ namespace uds {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::SslWebSocketTransmission>(hosting_, context, socket,
                     configuration_->Protocols.WebSocket.Host,
                     configuration_->Protocols.WebSocket.Path,
+                    configuration_->Protocols.WebSocket.Compression,
+                    configuration_->Protocols.WebSocket.CompressionThreshold,
                     configuration_->Protocols.Ssl.CertificateFile,
                     configuration_->Protocols.Ssl.CertificateKeyFile,
                     configuration_->Protocols.Ssl.CertificateChainFile,
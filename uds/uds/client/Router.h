@@ -5,8 +5,12 @@
 #include <uds/configuration/AppConfiguration.h>
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
+#include <uds/net/MetricsServer.h>
 #include <uds/tunnel/Connection.h>
+#include <uds/tunnel/Mux.h>
+#include <uds/tunnel/Bond.h>
 #include <uds/transmission/ITransmission.h>
+#include <uds/collections/FlatHashMap.h>
 
 namespace uds {
     namespace client {
@@ -18,15 +22,52 @@ namespace uds {
             using ITransmissionPtr                                              = std::shared_ptr<ITransmission>;
             using AppConfiguration                                              = uds::configuration::AppConfiguration;
             using HandshakeAsyncCallback                                        = std::function<void(const ITransmissionPtr&, bool)>;
-            using TimeoutPtr                                                    = std::shared_ptr<boost::asio::deadline_timer>;
-            using TimeoutTable                                                  = std::unordered_map<void*, TimeoutPtr>;
+            using TimingWheel                                                   = uds::threading::TimingWheel;
+            using TimeoutPtr                                                    = TimingWheel::TimeoutPtr;
+            using TimeoutTable                                                  = uds::collections::FlatHashMap<void*, TimeoutPtr>;
             using Connection                                                    = uds::tunnel::Connection;
             using ConnectionPtr                                                 = std::shared_ptr<Connection>;
-            using ConnectionTable                                               = std::unordered_map<int, ConnectionPtr>;
+            using ConnectionTable                                               = uds::collections::FlatHashMap<int, ConnectionPtr>;
+            using Mux                                                           = uds::tunnel::Mux;
+            using MuxPtr                                                        = std::shared_ptr<Mux>;
+            using MuxAsyncCallback                                              = std::function<void(const MuxPtr&)>;
+            using Bond                                                          = uds::tunnel::Bond;
+            using EstablishPairAsyncCallback                                    = std::function<void(const ITransmissionPtr&, const ITransmissionPtr&, int)>;
+
+        private:
+            /* One server pop with its dial health: latency is an EWMA over completed
+             * dials, failures count consecutive misses, and a pop past the failure
+             * threshold is blacked out for a spell so new channels go elsewhere. */
+            class UpstreamServer final {
+            public:
+                AppConfiguration::Upstream                                      endpoint_;
+                std::atomic<uint64_t>                                           latency_;  /* Milliseconds. */
+                std::atomic<uint32_t>                                           failures_;
+                std::atomic<uint64_t>                                           blackout_; /* Hosting millisecond the blackout ends. */
+
+            public:
+                UpstreamServer() noexcept : latency_(0), failures_(0), blackout_(0) {}
+            };
+            using UpstreamPtr                                                   = std::shared_ptr<UpstreamServer>;
+
+            class PoolChannel final {
+            public:
+                int                                                             channel_;
+                ITransmissionPtr                                                reader_;
+                ITransmissionPtr                                                writer_;
+                UpstreamPtr                                                     upstream_;
+                UInt64                                                          token_; /* Resume token the pair joined with, zero when resume is off. */
+
+            public:
+                void                                                            Close() noexcept;
+            };
+            using PoolChannelPtr                                                = std::shared_ptr<PoolChannel>;
             using ConnectClientAsyncCallback                                    = std::function<bool(const std::shared_ptr<boost::asio::ip::tcp::socket>&, bool)>;
             using ConnectTransmissionAsyncCallback                              = std::function<bool(const ITransmissionPtr&)>;
             using ConnectConnectionAsyncCallback                                = std::function<bool(const ITransmissionPtr&, int)>;
             using ResolveAddressAsyncCallback                                   = std::function<void(const boost::asio::ip::tcp::endpoint&)>;
+            using Mutex                                                         = std::mutex;
+            using MutexScope                                                    = std::lock_guard<Mutex>;
 
         public:
             Router(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
@@ -43,7 +84,7 @@ namespace uds {
 
         private:
             bool                                                                ClearTimeout(void* key) noexcept;
-            bool                                                                AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept;
+            bool                                                                AddTimeout(void* key, TimeoutPtr&& timeout) noexcept;
 
         private:
             std::shared_ptr<boost::asio::ip::tcp::acceptor>                     OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
@@ -51,30 +92,66 @@ namespace uds {
 
         private:
             bool                                                                AcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
-            bool                                                                ConnectClient(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectClientAsyncCallback&& callback) noexcept;
-            bool                                                                ConnectTransmission(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectTransmissionAsyncCallback&& callback) noexcept;
-            bool                                                                ConnectConnection(const AsioContext& context, int channelId, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept;
+            bool                                                                AcceptMuxClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                AcceptBondClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                EstablishPair(const AsioContext& context, EstablishPairAsyncCallback&& callback) noexcept;
+            bool                                                                EstablishPair(const AsioContext& context, const UpstreamPtr& upstream, EstablishPairAsyncCallback&& callback) noexcept;
+            bool                                                                EstablishPair(const AsioContext& context, const UpstreamPtr& upstream, UInt64 token, EstablishPairAsyncCallback&& callback) noexcept;
+            bool                                                                EstablishBondPair(const AsioContext& context, const UpstreamPtr& upstream, int gid, EstablishPairAsyncCallback&& callback) noexcept;
+
+        private:
+            bool                                                                ReplenishPool() noexcept;
+            PoolChannelPtr                                                      PopPool() noexcept;
+            bool                                                                ClosePool(const PoolChannelPtr& pool) noexcept;
+            bool                                                                PoolKeepAlivedSendCycle(const PoolChannelPtr& pool) noexcept;
+            bool                                                                EstablishMux(MuxAsyncCallback&& callback) noexcept;
+            bool                                                                ConnectMux() noexcept;
+            bool                                                                OnMuxEstablished(const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept;
+            void                                                                FlushMuxWaits(const MuxPtr& mux) noexcept;
+            bool                                                                ConnectClient(const AsioContext& context, const UpstreamPtr& upstream, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectClientAsyncCallback&& callback) noexcept;
+            bool                                                                ConnectTransmission(const AsioContext& context, const UpstreamPtr& upstream, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectTransmissionAsyncCallback&& callback) noexcept;
+            bool                                                                ConnectConnection(const AsioContext& context, const UpstreamPtr& upstream, int channelId, UInt64 token, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept;
+            bool                                                                ResumeConnection(int channel, const UpstreamPtr& upstream, UInt64 token) noexcept;
+            bool                                                                RetryResumeConnection(int channel, const UpstreamPtr& upstream, UInt64 token) noexcept;
+            std::shared_ptr<uds::configuration::AppConfiguration>               GetSnapshot() noexcept;
+            void                                                                BuildUpstreams(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration, std::vector<UpstreamPtr>& upstreams) noexcept;
+            UpstreamPtr                                                         SelectUpstream() noexcept;
+            void                                                                ReportUpstream(const UpstreamPtr& upstream, uint64_t startedAt, bool success) noexcept;
             bool                                                                ResolveAddress(bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept;
+            bool                                                                OpenMetrics() noexcept;
 
         public:
             virtual bool                                                        Listen() noexcept;
+            virtual bool                                                        Reload(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
             virtual void                                                        Dispose() noexcept override;
 
         protected:
             virtual ITransmissionPtr                                            CreateTransmission(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
             virtual ConnectionPtr                                               CreateConnection(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
-            virtual bool                                                        Accept(const AsioTcpSocket& network, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+            virtual bool                                                        Accept(const AsioTcpSocket& network, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, bool early, const UpstreamPtr& upstream, UInt64 token) noexcept;
 
         private:
             std::atomic<bool>                                                   disposed_;
             std::atomic<int>                                                    channel_;
             std::shared_ptr<uds::threading::Hosting>                            hosting_;
+            std::shared_ptr<uds::threading::TimingWheel>                        timewheel_;
             std::shared_ptr<uds::configuration::AppConfiguration>               configuration_;
+            std::vector<std::shared_ptr<uds::configuration::AppConfiguration>>  reloads_; /* Superseded snapshots, pinned so unlocked field reads stay valid. */
             std::shared_ptr<boost::asio::io_context>                            context_;
             std::shared_ptr<boost::asio::ip::tcp::acceptor>                     acceptor_;
             std::shared_ptr<boost::asio::ip::tcp::resolver>                     resolver_;
+            std::shared_ptr<uds::net::MetricsServer>                            metrics_;
+            std::atomic<uint64_t>                                               accepts_; /* Loopback sockets accepted for relaying. */
+            Mutex                                                               syncobj_;
             TimeoutTable                                                        timeouts_;
             ConnectionTable                                                     connections_;
+            bool                                                                muxing_;
+            MuxPtr                                                              mux_;
+            std::list<MuxAsyncCallback>                                         muxwaits_;
+            int                                                                 pooling_; /* Warm pairs still being dialed. */
+            std::list<PoolChannelPtr>                                           pools_;
+            std::atomic<unsigned int>                                           upstream_rotate_;
+            std::vector<UpstreamPtr>                                            upstreams_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace collections {
+        /* Open-addressing hash map (robin-hood probing, backward-shift deletion) over
+         * one contiguous slot array: lookups walk adjacent cache lines instead of
+         * chasing heap nodes, and inserts only allocate when the table grows. The
+         * interface is the std::unordered_map subset the Dictionary helpers drive,
+         * so the hot tables swap in by changing their using-declaration. */
+        template<typename TKey, typename TValue, typename THash = std::hash<TKey> >
+        class FlatHashMap final {
+        public:
+            using key_type                      = TKey;
+            using mapped_type                   = TValue;
+            using value_type                    = std::pair<TKey, TValue>;
+
+        private:
+            struct Slot {
+                int16_t                         dist_ = 0; /* Probe distance from the home bucket plus one; zero marks a free slot. */
+                value_type                      kv_;
+            };
+            using SlotTable                     = std::vector<Slot>;
+
+        public:
+            class iterator {
+                friend class FlatHashMap;
+
+            public:
+                iterator() noexcept
+                    : slots_(NULL)
+                    , index_(0) {
+
+                }
+                iterator(SlotTable* slots, std::size_t index) noexcept
+                    : slots_(slots)
+                    , index_(index) {
+                    Skip();
+                }
+
+            public:
+                inline value_type&              operator*() const noexcept {
+                    return (*slots_)[index_].kv_;
+                }
+                inline value_type*              operator->() const noexcept {
+                    return addressof((*slots_)[index_].kv_);
+                }
+                inline iterator&                operator++() noexcept {
+                    index_++;
+                    Skip();
+                    return *this;
+                }
+                inline iterator                 operator++(int) noexcept {
+                    iterator i = *this;
+                    ++*this;
+                    return i;
+                }
+                inline bool                     operator==(const iterator& right) const noexcept {
+                    return index_ == right.index_;
+                }
+                inline bool                     operator!=(const iterator& right) const noexcept {
+                    return index_ != right.index_;
+                }
+
+            private:
+                inline void                     Skip() noexcept {
+                    while (index_ < slots_->size() && !(*slots_)[index_].dist_) {
+                        index_++;
+                    }
+                }
+
+            private:
+                SlotTable*                      slots_;
+                std::size_t                     index_;
+            };
+
+        public:
+            FlatHashMap() noexcept
+                : count_(0) {
+
+            }
+
+        public:
+            inline std::size_t                  size() const noexcept {
+                return count_;
+            }
+            inline bool                         empty() const noexcept {
+                return count_ == 0;
+            }
+            inline iterator                     begin() noexcept {
+                return iterator(addressof(slots_), 0);
+            }
+            inline iterator                     end() noexcept {
+                return iterator(addressof(slots_), slots_.size());
+            }
+            inline void                         clear() noexcept {
+                SlotTable().swap(slots_);
+                count_ = 0;
+            }
+
+        public:
+            inline iterator                     find(const TKey& key) noexcept {
+                std::size_t capacity = slots_.size();
+                if (!capacity) {
+                    return end();
+                }
+
+                std::size_t mask = capacity - 1;
+                std::size_t i = Mix(key) & mask;
+                for (int16_t dist = 1;; i = (i + 1) & mask, dist++) {
+                    Slot& slot = slots_[i];
+                    if (slot.dist_ < dist) { /* A free slot, or one nearer its home than we are: the key cannot sit past it. */
+                        return end();
+                    }
+                    elif(slot.dist_ == dist && slot.kv_.first == key) {
+                        return iterator(addressof(slots_), i);
+                    }
+                }
+            }
+            inline std::pair<iterator, bool>    insert(const value_type& kv) noexcept {
+                return insert(value_type(kv));
+            }
+            inline std::pair<iterator, bool>    insert(value_type&& kv) noexcept {
+                iterator tail = find(kv.first);
+                if (tail != end()) {
+                    return std::make_pair(tail, false);
+                }
+
+                std::size_t capacity = slots_.size();
+                if ((count_ + 1) * 8 >= capacity * 7) { /* Keep the load below 7/8: robin-hood probe chains stay short. */
+                    Rehash(std::max<std::size_t>(16, capacity << 1));
+                }
+
+                std::size_t i = Place(std::move(kv));
+                count_++;
+                return std::make_pair(iterator(addressof(slots_), i), true);
+            }
+            inline mapped_type&                 operator[](const TKey& key) noexcept {
+                iterator tail = find(key);
+                if (tail == end()) {
+                    tail = insert(value_type(key, mapped_type())).first;
+                }
+                return tail->second;
+            }
+            inline void                         erase(const iterator& tail) noexcept {
+                std::size_t mask = slots_.size() - 1;
+                std::size_t i = tail.index_;
+                count_--;
+
+                /* Backward shift instead of a tombstone: pull every displaced follower
+                 * one slot toward its home, then free the last slot of the chain. */
+                for (;;) {
+                    std::size_t j = (i + 1) & mask;
+                    Slot& next = slots_[j];
+                    if (next.dist_ <= 1) {
+                        break;
+                    }
+
+                    slots_[i].kv_ = std::move(next.kv_);
+                    slots_[i].dist_ = next.dist_ - 1;
+                    i = j;
+                }
+
+                slots_[i].dist_ = 0;
+                slots_[i].kv_ = value_type();
+            }
+
+        private:
+            inline std::size_t                  Mix(const TKey& key) noexcept {
+                std::size_t h = THash()(key); /* std::hash is identity for ints and pointers: fold the entropy down into the mask bits. */
+                h ^= h >> 33;
+                h *= 0xFF51AFD7ED558CCDULL;
+                h ^= h >> 33;
+                return h;
+            }
+            inline std::size_t                  Place(value_type&& kv) noexcept {
+                std::size_t mask = slots_.size() - 1;
+                std::size_t i = Mix(kv.first) & mask;
+                std::size_t home = (std::size_t)~0;
+
+                value_type carry = std::move(kv);
+                for (int16_t dist = 1;; i = (i + 1) & mask, dist++) {
+                    Slot& slot = slots_[i];
+                    if (!slot.dist_) {
+                        slot.kv_ = std::move(carry);
+                        slot.dist_ = dist;
+                        return home != (std::size_t)~0 ? home : i;
+                    }
+                    elif(slot.dist_ < dist) { /* The slot holder is richer: take its place and keep pushing it forward. */
+                        std::swap(slot.kv_, carry);
+                        std::swap(slot.dist_, dist);
+                        if (home == (std::size_t)~0) {
+                            home = i;
+                        }
+                    }
+                }
+            }
+            inline void                         Rehash(std::size_t capacity) noexcept {
+                SlotTable slots(capacity);
+                slots.swap(slots_);
+
+                for (Slot& slot : slots) {
+                    if (slot.dist_) {
+                        Place(std::move(slot.kv_));
+                    }
+                }
+            }
+
+        private:
+            std::size_t                         count_;
+            SlotTable                           slots_;
+        };
+    }
+}
@@ -0,0 +1,202 @@
+#include <uds/compression/Lz4Codec.h>
+
+namespace uds {
+    namespace compression {
+        static const int ELZ4_HASH_BITS                 = 12;
+        static const int ELZ4_HASH_SIZE                 = 1 << ELZ4_HASH_BITS;
+        static const int ELZ4_MIN_MATCH                 = 4;
+        static const int ELZ4_LAST_LITERALS             = 5;  /* The block must end in at least this many literals. */
+        static const int ELZ4_MFLIMIT                   = 12; /* No match may start closer than this to the end. */
+
+        static inline uint32_t Lz4Codec_Read32(const Byte* p) noexcept {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        static inline int Lz4Codec_Hash(uint32_t sequence) noexcept {
+            return (int)((sequence * 2654435761u) >> (32 - ELZ4_HASH_BITS));
+        }
+
+        int Lz4Codec::Compress(const Byte* in, int inlen, Byte* out, int outcap) noexcept {
+            if (!in || !out || inlen < (ELZ4_MFLIMIT + 1) || inlen > UINT16_MAX || outcap < 1) {
+                return 0;
+            }
+
+            uint32_t table[ELZ4_HASH_SIZE]; /* Position + 1; zero marks an empty slot. */
+            memset(table, 0, sizeof(table));
+
+            const Byte* ip = in;
+            const Byte* anchor = in;
+            const Byte* iend = in + inlen;
+            const Byte* mflimit = iend - ELZ4_MFLIMIT;
+            Byte* op = out;
+            Byte* oend = out + outcap;
+
+            while (ip < mflimit) {
+                uint32_t sequence = Lz4Codec_Read32(ip);
+                int h = Lz4Codec_Hash(sequence);
+
+                const Byte* match = in + table[h] - 1;
+                bool mismatch = !table[h] || Lz4Codec_Read32(match) != sequence;
+
+                table[h] = (uint32_t)(ip - in) + 1;
+                if (mismatch) {
+                    ip++;
+                    continue;
+                }
+
+                /* Extend the match forward; backward extension is skipped to keep
+                 * the encoder one pass, which costs a few bytes of ratio at most. */
+                const Byte* mp = match + ELZ4_MIN_MATCH;
+                const Byte* cp = ip + ELZ4_MIN_MATCH;
+                const Byte* climit = iend - ELZ4_LAST_LITERALS;
+                while (cp < climit && *cp == *mp) {
+                    cp++;
+                    mp++;
+                }
+
+                int literals = (int)(ip - anchor);
+                int matchlen = (int)(cp - ip) - ELZ4_MIN_MATCH;
+                int offset = (int)(ip - match);
+
+                /* Worst-case sequence size: token, literal length bytes, literals,
+                 * offset and match length bytes; bail out rather than overrun. */
+                if ((op + 1 + literals + (literals / 255) + 1 + 2 + (matchlen / 255) + 1) > oend) {
+                    return 0;
+                }
+
+                Byte* token = op++;
+                int remaining = literals;
+                if (remaining >= 15) {
+                    *token = (Byte)(15 << 4);
+                    for (remaining -= 15; remaining >= 255; remaining -= 255) {
+                        *op++ = 255;
+                    }
+                    *op++ = (Byte)remaining;
+                }
+                else {
+                    *token = (Byte)(remaining << 4);
+                }
+
+                memcpy(op, anchor, literals);
+                op += literals;
+
+                *op++ = (Byte)(offset);
+                *op++ = (Byte)(offset >> 8);
+
+                remaining = matchlen;
+                if (remaining >= 15) {
+                    *token |= 15;
+                    for (remaining -= 15; remaining >= 255; remaining -= 255) {
+                        *op++ = 255;
+                    }
+                    *op++ = (Byte)remaining;
+                }
+                else {
+                    *token |= (Byte)remaining;
+                }
+
+                ip = cp;
+                anchor = cp;
+            }
+
+            /* The trailing literal run closes the block. */
+            int literals = (int)(iend - anchor);
+            if ((op + 1 + literals + (literals / 255) + 1) > oend) {
+                return 0;
+            }
+
+            Byte* token = op++;
+            int remaining = literals;
+            if (remaining >= 15) {
+                *token = (Byte)(15 << 4);
+                for (remaining -= 15; remaining >= 255; remaining -= 255) {
+                    *op++ = 255;
+                }
+                *op++ = (Byte)remaining;
+            }
+            else {
+                *token = (Byte)(remaining << 4);
+            }
+
+            memcpy(op, anchor, literals);
+            op += literals;
+
+            int outlen = (int)(op - out);
+            return outlen < inlen ? outlen : 0; /* Never ship a block that grew. */
+        }
+
+        int Lz4Codec::Decompress(const Byte* in, int inlen, Byte* out, int outcap) noexcept {
+            if (!in || !out || inlen < 1 || outcap < 1) {
+                return -1;
+            }
+
+            const Byte* ip = in;
+            const Byte* iend = in + inlen;
+            Byte* op = out;
+            Byte* oend = out + outcap;
+
+            for (;;) {
+                if (ip >= iend) {
+                    return -1; /* A legal block ends on a literal run, never on a match. */
+                }
+
+                int token = *ip++;
+                int literals = token >> 4;
+                if (literals == 15) {
+                    int v;
+                    do {
+                        if (ip >= iend) {
+                            return -1;
+                        }
+                        v = *ip++;
+                        literals += v;
+                    } while (v == 255);
+                }
+
+                if ((ip + literals) > iend || (op + literals) > oend) {
+                    return -1;
+                }
+
+                memcpy(op, ip, literals);
+                ip += literals;
+                op += literals;
+                if (ip >= iend) {
+                    return ip == iend ? (int)(op - out) : -1; /* A block ends exactly on its final literal run. */
+                }
+
+                if ((ip + 2) > iend) {
+                    return -1;
+                }
+
+                int offset = ip[0] | (ip[1] << 8);
+                ip += 2;
+                if (offset < 1 || offset > (int)(op - out)) {
+                    return -1;
+                }
+
+                int matchlen = (token & 15) + ELZ4_MIN_MATCH;
+                if ((token & 15) == 15) {
+                    int v;
+                    do {
+                        if (ip >= iend) {
+                            return -1;
+                        }
+                        v = *ip++;
+                        matchlen += v;
+                    } while (v == 255);
+                }
+
+                if ((op + matchlen) > oend) {
+                    return -1;
+                }
+
+                const Byte* match = op - offset;
+                for (int i = 0; i < matchlen; i++) { /* Byte-wise: overlapping copies are the common case. */
+                    *op++ = *match++;
+                }
+            }
+        }
+    }
+}
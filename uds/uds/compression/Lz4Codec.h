@@ -0,0 +1,22 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace compression {
+        /* Self-contained LZ4 block-format codec (greedy match search, 64KB window)
+         * for the optional transmission compression stage. Both tunnel ends run
+         * this implementation, but the emitted blocks follow the published LZ4
+         * block layout, so captures stay inspectable with stock tooling. */
+        class Lz4Codec final {
+        public:
+            /* Compresses inlen bytes into out and returns the block size, or zero
+             * when the input is too small, does not shrink, or outcap is tight. */
+            static int                                  Compress(const Byte* in, int inlen, Byte* out, int outcap) noexcept;
+
+            /* Expands an LZ4 block into out and returns the decompressed size, or
+             * -1 when the block is malformed or would overrun outcap. */
+            static int                                  Decompress(const Byte* in, int inlen, Byte* out, int outcap) noexcept;
+        };
+    }
+}
@@ -69,12 +69,53 @@ namespace uds {
             return true;
         }
 
+        /* Expands a listen-port list such as "10080,10100-10103" into every port it
+         * names: commas separate the entries and a dash marks an inclusive range.
+         * Tokens outside the port space and duplicates are dropped silently. */
+        static void AppConfiguration_ExpandPorts(const std::string& text, std::vector<int>& ports) noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            std::size_t offset = 0;
+            while (offset <= text.size()) {
+                std::size_t index = text.find(',', offset);
+                if (index == std::string::npos) {
+                    index = text.size();
+                }
+
+                std::string token = text.substr(offset, index - offset);
+                offset = index + 1;
+
+                char* endptr = NULL;
+                long left = strtol(token.data(), &endptr, 10);
+                long reft = left;
+                if (NULL != endptr && *endptr == '-') {
+                    reft = strtol(endptr + 1, NULL, 10);
+                }
+
+                if (left > reft) {
+                    std::swap(left, reft);
+                }
+
+                for (long port = left; port <= reft; port++) {
+                    if (port <= IPEndPoint::MinPort || port > IPEndPoint::MaxPort) {
+                        continue;
+                    }
+
+                    if (std::find(ports.begin(), ports.end(), (int)port) == ports.end()) {
+                        ports.push_back((int)port);
+                    }
+                }
+            }
+        }
+
         static bool AppConfiguration_LoadEncryptorConfiguration(std::shared_ptr<AppConfiguration>& configuration, Ini::Section& section) noexcept {
             std::string& evp_method = configuration->Protocols.Encryptor.Method;
             std::string& evp_passwd = configuration->Protocols.Encryptor.Password;
 
             evp_method = section["protocol.encryptor.method"];
             evp_passwd = section["protocol.encryptor.password"];
+            configuration->Protocols.Encryptor.Benchmark = section.GetValue<bool>("protocol.encryptor.benchmark");
+            configuration->Protocols.Encryptor.Offload = section.GetValue<bool>("protocol.encryptor.offload");
 
             if (evp_method.empty()) {
                 return false;
@@ -86,6 +127,21 @@ namespace uds {
             return true;
         }
 
+        static bool AppConfiguration_LoadChaCha20Poly1305Configuration(std::shared_ptr<AppConfiguration>& configuration, Ini::Section& section) noexcept {
+            std::string& evp_method = configuration->Protocols.Encryptor.Method;
+            std::string& evp_passwd = configuration->Protocols.Encryptor.Password;
+
+            /* The method is pinned by the protocol: both ends only share the password. */
+            evp_method = "chacha20-poly1305";
+            evp_passwd = section["protocol.encryptor.password"];
+            configuration->Protocols.Encryptor.Offload = section.GetValue<bool>("protocol.encryptor.offload");
+
+            if (evp_passwd.empty()) {
+                return false;
+            }
+            return true;
+        }
+
         static bool AppConfiguration_LoadSslConfiguration(std::shared_ptr<AppConfiguration>& configuration, Ini::Section& section) noexcept {
             typedef AppConfiguration::ProtocolType ProtocolType;
 
@@ -106,6 +162,7 @@ namespace uds {
                 ssl_certificate_chain_file = section["protocol.ssl.certificate-chain-file"];
                 ssl_certificate_key_password = section["protocol.ssl.certificate-key-password"];
                 ssl_ciphersuites = section["protocol.ssl.ciphersuites"];
+                configuration->Protocols.Ssl.KernelTls = section.GetValue<bool>("protocol.ssl.ktls");
             }
             else {
                 ssl_verify_peer = section.GetValue<bool>("protocol.tls.verify-peer");
@@ -115,6 +172,7 @@ namespace uds {
                 ssl_certificate_chain_file = section["protocol.tls.certificate-chain-file"];
                 ssl_certificate_key_password = section["protocol.tls.certificate-key-password"];
                 ssl_ciphersuites = section["protocol.tls.ciphersuites"];
+                configuration->Protocols.Ssl.KernelTls = section.GetValue<bool>("protocol.tls.ktls");
             }
 
             if (ssl_ciphersuites.empty()) {
@@ -134,6 +192,14 @@ namespace uds {
             websocket_host = section["protocol.websocket.host"];
             websocket_path = section["protocol.websocket.path"];
 
+            configuration->Protocols.WebSocket.Compression = section.GetValue<bool>("protocol.websocket.compression");
+            configuration->Protocols.WebSocket.CompressionThreshold = section.GetValue<int>("protocol.websocket.compression-threshold");
+
+            int& compressionThreshold = configuration->Protocols.WebSocket.CompressionThreshold;
+            if (compressionThreshold < 0) {
+                compressionThreshold = 0; /* Zero lets every message through the deflate stage. */
+            }
+
             if (websocket_host.empty()) {
                 return false;
             }
@@ -177,10 +243,15 @@ namespace uds {
                 configuration->Mode = LoopbackMode::LoopbackMode_Client;
                 configuration->Alignment = section.GetValue<int>("alignment");
                 configuration->Backlog = section.GetValue<int>("backlog");
+                configuration->Accepts = section.GetValue<int>("accepts");
+                configuration->Concurrent = section.GetValue<int>("concurrent");
+                configuration->Affinity = section.GetValue<bool>("cpu-affinity");
+                configuration->Window = section.GetValue<int>("window");
                 configuration->IP = section["ip"];
                 configuration->Port = section.GetValue<int>("port");
                 configuration->Inbound.IP = section["inbound-ip"];
-                configuration->Inbound.Port = section.GetValue<int>("inbound-port");
+                AppConfiguration_ExpandPorts(section["inbound-port"], configuration->Inbound.Ports);
+                configuration->Inbound.Port = configuration->Inbound.Ports.empty() ? 0 : configuration->Inbound.Ports[0];
                 configuration->Outbound.IP = section["outbound-ip"];
                 configuration->Outbound.Port = section.GetValue<int>("outbound-port");
                 configuration->FastOpen = section.GetValue<bool>("fast-open");
@@ -191,6 +262,24 @@ namespace uds {
                 configuration->Inbound.Domain = false;
                 configuration->Outbound.Domain = false;
                 configuration->KeepAlived = section.GetValue<bool>("keep-alived");
+                configuration->Mux = section.GetValue<bool>("mux");
+                configuration->FastHandshake = section.GetValue<bool>("fast-handshake");
+                configuration->Resume = section.GetValue<bool>("resume");
+                configuration->Bonding = section.GetValue<int>("bonding");
+                configuration->Pool = section.GetValue<int>("pool");
+                configuration->Buffers.Sndbuf = section.GetValue<int>("buffer.sndbuf");
+                configuration->Buffers.Rcvbuf = section.GetValue<int>("buffer.rcvbuf");
+                configuration->Buffers.Bandwidth = section.GetValue<int>("buffer.bandwidth");
+                configuration->Buffers.NotsentLowat = section.GetValue<int>("buffer.notsent-lowat");
+                configuration->Compression.Enabled = section.GetValue<bool>("compression");
+                configuration->Compression.Threshold = section.GetValue<int>("compression-threshold");
+                configuration->Framing.Version = section.GetValue<int>("framing");
+                configuration->Priority.Enabled = section.GetValue<bool>("priority");
+                configuration->Priority.Threshold = section.GetValue<int>("priority-threshold");
+                configuration->Adaptive.Enabled = section.GetValue<bool>("adaptive");
+                configuration->Metrics.IP = section["metrics.ip"];
+                configuration->Metrics.Port = section.GetValue<int>("metrics.port");
+                configuration->LogFile = section["log.file"];
 
                 IPEndPoint ip(configuration->IP.data(), configuration->Port);
                 if (IPEndPoint::IsInvalid(ip)) {
@@ -225,6 +314,59 @@ namespace uds {
                     configuration->Outbound.IP = outboundIP.ToAddressString();
                 }
 
+                /* Reading the upstream server list: upstream.N.* names pop N, numbered
+                 * from 1; the list ends at the first missing inbound-ip. Entries that
+                 * fail address or port validation are dropped rather than dialed. */
+                for (int i = 1;; i++) {
+                    std::string prefix = "upstream." + std::to_string(i) + ".";
+                    AppConfiguration::Upstream upstream;
+                    upstream.Inbound.IP = section[prefix + "inbound-ip"];
+                    upstream.Inbound.Port = section.GetValue<int>(prefix + "inbound-port");
+                    upstream.Outbound.IP = section[prefix + "outbound-ip"];
+                    upstream.Outbound.Port = section.GetValue<int>(prefix + "outbound-port");
+                    if (upstream.Inbound.IP.empty()) {
+                        break;
+                    }
+
+                    if (upstream.Inbound.Port <= IPEndPoint::MinPort || upstream.Inbound.Port > IPEndPoint::MaxPort) {
+                        continue;
+                    }
+
+                    if (upstream.Outbound.Port <= IPEndPoint::MinPort || upstream.Outbound.Port > IPEndPoint::MaxPort) {
+                        continue;
+                    }
+
+                    IPEndPoint upstreamInbound(upstream.Inbound.IP.data(), upstream.Inbound.Port);
+                    if (IPEndPoint::IsInvalid(upstreamInbound)) {
+                        upstream.Inbound.Domain = Ipep::IsDomainAddress(upstream.Inbound.IP);
+                        if (!upstream.Inbound.Domain) {
+                            continue;
+                        }
+                    }
+                    else {
+                        upstream.Inbound.IP = upstreamInbound.ToAddressString();
+                    }
+
+                    if (upstream.Outbound.IP.empty()) {
+                        upstream.Outbound.IP = upstream.Inbound.IP; /* One pop, one host: only the ports differ. */
+                        upstream.Outbound.Domain = upstream.Inbound.Domain;
+                    }
+                    else {
+                        IPEndPoint upstreamOutbound(upstream.Outbound.IP.data(), upstream.Outbound.Port);
+                        if (IPEndPoint::IsInvalid(upstreamOutbound)) {
+                            upstream.Outbound.Domain = Ipep::IsDomainAddress(upstream.Outbound.IP);
+                            if (!upstream.Outbound.Domain) {
+                                continue;
+                            }
+                        }
+                        else {
+                            upstream.Outbound.IP = upstreamOutbound.ToAddressString();
+                        }
+                    }
+
+                    configuration->Upstreams.push_back(std::move(upstream));
+                }
+
                 int& connectTimeout = configuration->Connect.Timeout;
                 if (connectTimeout < 1) {
                     connectTimeout = 10;
@@ -240,6 +382,106 @@ namespace uds {
                     alignment = (UINT8_MAX << 1);
                 }
 
+                if (configuration->Compression.Enabled && alignment > INT16_MAX) {
+                    alignment = INT16_MAX; /* Bit 15 of the frame length header carries the compressed flag. */
+                }
+
+                int& compressionThreshold = configuration->Compression.Threshold;
+                if (compressionThreshold < 1) {
+                    compressionThreshold = 128; /* Frames below this many bytes skip the codec. */
+                }
+
+                int& framing = configuration->Framing.Version;
+                if (framing < 1) {
+                    framing = 1;
+                }
+                elif(framing > 2) {
+                    framing = 2;
+                }
+
+                if (framing >= 2 && alignment > UINT16_MAX - 3) {
+                    alignment = UINT16_MAX - 3; /* The longest payload varint must still fit beside its payload in one frame body. */
+                }
+
+                int& priorityThreshold = configuration->Priority.Threshold;
+                if (priorityThreshold < 1) {
+                    priorityThreshold = 512; /* Channels whose frame-size EWMA stays at or below this count as interactive. */
+                }
+
+                if (framing < 2) {
+                    configuration->Adaptive.Enabled = false; /* Chunk announcements ride the v2 payload escape; v1 peers would read them as a breach. */
+                }
+
+                int& concurrent = configuration->Concurrent;
+                if (concurrent < 0) {
+                    concurrent = 0; /* Zero means one hosting context per hardware thread. */
+                }
+
+                int& bonding = configuration->Bonding;
+                if (bonding < 2) {
+                    bonding = 0; /* A bond of one member is just the plain path. */
+                }
+                elif(bonding > 8) {
+                    bonding = 8;
+                }
+
+                int& pool = configuration->Pool;
+                if (pool < 0) {
+                    pool = 0; /* Warm channel pairs the router keeps established in advance. */
+                }
+                elif(pool > 64) {
+                    pool = 64;
+                }
+
+                IPEndPoint metricsIP(configuration->Metrics.IP.data(), configuration->Metrics.Port);
+                if (IPEndPoint::IsInvalid(metricsIP)) {
+                    configuration->Metrics.IP = boost::asio::ip::address_v6::any().to_string();
+                }
+                else {
+                    configuration->Metrics.IP = metricsIP.ToAddressString();
+                }
+
+                int& metricsPort = configuration->Metrics.Port;
+                if (metricsPort < IPEndPoint::MinPort || metricsPort > IPEndPoint::MaxPort) {
+                    metricsPort = IPEndPoint::MinPort; /* MinPort leaves the /metrics listener closed. */
+                }
+
+                int& accepts = configuration->Accepts;
+                if (accepts < 1) {
+                    accepts = 1; /* async_accept operations kept outstanding per acceptor. */
+                }
+                elif(accepts > 64) {
+                    accepts = 64;
+                }
+
+                int& sndbuf = configuration->Buffers.Sndbuf;
+                if (sndbuf < 0) {
+                    sndbuf = 0; /* Zero leaves the size to the RTT-derived BDP, or the kernel. */
+                }
+
+                int& rcvbuf = configuration->Buffers.Rcvbuf;
+                if (rcvbuf < 0) {
+                    rcvbuf = 0;
+                }
+
+                int& bandwidth = configuration->Buffers.Bandwidth;
+                if (bandwidth < 0) {
+                    bandwidth = 0; /* Assumed path rate in mbps: zero disables BDP sizing. */
+                }
+
+                int& notsentLowat = configuration->Buffers.NotsentLowat;
+                if (notsentLowat < 0) {
+                    notsentLowat = 0;
+                }
+
+                int& window = configuration->Window;
+                if (window < 1) {
+                    window = 4; /* Relay buffers allowed in flight per channel direction. */
+                }
+                elif(window > 64) {
+                    window = 64;
+                }
+
                 int& port = configuration->Port;
                 if (port < IPEndPoint::MinPort || port > IPEndPoint::MaxPort) {
                     port = IPEndPoint::MinPort;
@@ -298,9 +540,15 @@ namespace uds {
                     elif(pch[0] == 'e') { // EVP
                         configuration->Protocol = ProtocolType::ProtocolType_Encryptor;
                     }
+                    elif(pch[0] == 'c') { // ChaCha20-Poly1305
+                        configuration->Protocol = ProtocolType::ProtocolType_ChaCha20Poly1305;
+                    }
                     elif(pch[0] == 's') { // SSL
                         configuration->Protocol = ProtocolType::ProtocolType_SSL;
                     }
+                    elif(pch[0] == 'u') { // UDP
+                        configuration->Protocol = ProtocolType::ProtocolType_UDP;
+                    }
                     elif(pch[0] == 't' && pch[1] == 'l') { // TLS
                         configuration->Protocol = ProtocolType::ProtocolType_TLS;
                     }
@@ -336,12 +584,69 @@ namespace uds {
                     }
                 }
 
+                /* Loading protocol chacha20-poly1305 settings. */
+                if (configuration->Protocol == ProtocolType::ProtocolType_ChaCha20Poly1305) {
+                    if (!AppConfiguration_LoadChaCha20Poly1305Configuration(configuration, section)) {
+                        return NULL;
+                    }
+                }
+
                 /* Remove app sections. */
                 ini.Remove(section.Name);
             }
+
+            configuration->Path = iniFile;
             return IsInvalid(configuration) ? NULL : std::move(configuration);
         }
 
+        bool AppConfiguration::IsHotSwappable(const AppConfiguration& running, const AppConfiguration& next) noexcept {
+            /* Settings baked into running listeners or hosting threads cannot be
+             * swapped under a live process; a reload that touches them is rejected
+             * so the operator restarts deliberately instead of half-applying. */
+            if (running.Mode != next.Mode || running.Concurrent != next.Concurrent || running.Affinity != next.Affinity) {
+                return false;
+            }
+
+            if (running.Mux != next.Mux || running.Bonding != next.Bonding) {
+                return false; /* Channel layering is negotiated per process, not per channel. */
+            }
+
+            if (running.Framing.Version != next.Framing.Version) {
+                return false; /* The peer's frame reader state spans reloads. */
+            }
+
+            if (running.Adaptive.Enabled != next.Adaptive.Enabled) {
+                return false; /* Live transmissions may already sit above the configured alignment. */
+            }
+
+            if (running.Backlog != next.Backlog || running.Accepts != next.Accepts) {
+                return false;
+            }
+
+            if (running.Metrics.IP != next.Metrics.IP || running.Metrics.Port != next.Metrics.Port) {
+                return false;
+            }
+
+            if (running.Mode == LoopbackMode::LoopbackMode_Server) {
+                /* Both tunnel sides are bound listeners on the server. */
+                if (running.Inbound.IP != next.Inbound.IP || running.Inbound.Ports != next.Inbound.Ports || running.Inbound.Domain != next.Inbound.Domain) {
+                    return false;
+                }
+
+                if (running.Outbound.IP != next.Outbound.IP || running.Outbound.Port != next.Outbound.Port || running.Outbound.Domain != next.Outbound.Domain) {
+                    return false;
+                }
+            }
+            else {
+                /* Only the loopback listener is pinned on the client; the tunnel
+                 * endpoints are dial targets new channels pick up from the snapshot. */
+                if (running.IP != next.IP || running.Port != next.Port || running.Domain != next.Domain) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         bool AppConfiguration::IsInvalid(const std::shared_ptr<AppConfiguration>& config) noexcept {
             if (NULL == config) {
                 return true;
@@ -409,7 +714,8 @@ namespace uds {
                     return true;
                 }
             }
-            elif(config.Protocol == ProtocolType::ProtocolType_Encryptor) {
+            elif(config.Protocol == ProtocolType::ProtocolType_Encryptor ||
+                config.Protocol == ProtocolType::ProtocolType_ChaCha20Poly1305) {
                 if (!AppConfiguration_VerityEncryptorConfiguration(config)) {
                     return true;
                 }
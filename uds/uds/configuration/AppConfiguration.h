@@ -20,20 +20,64 @@ namespace uds {
             struct {
                 std::string                             IP;
                 int                                     Port = 0;
+                std::vector<int>                        Ports; /* Every listen port the ini list/range syntax expands to; Port is the first. */
                 bool                                    Domain = false;
             }                                           Inbound, Outbound;
+            struct Upstream {
+                struct {
+                    std::string                         IP;
+                    int                                 Port = 0;
+                    bool                                Domain = false;
+                }                                       Inbound, Outbound;
+            };
+            std::vector<Upstream>                       Upstreams; /* Server pops beyond the primary Inbound/Outbound pair (client mode). */
             int                                         Alignment = 0;
             int                                         Backlog = 511;
+            int                                         Accepts = 1;
+            int                                         Concurrent = 0;
+            bool                                        Affinity = false; /* Pin hosting threads to CPUs and keep flows on their RX processor. */
+            int                                         Window = 4;
             bool                                        Inversion = false;
             bool                                        FastOpen = false;
             bool                                        Turbo = false;
             bool                                        KeepAlived = false;
+            bool                                        Mux = false;
+            bool                                        FastHandshake = false;
+            bool                                        Resume = false; /* Detached channels replay unacknowledged frames over a replacement pair. */
+            int                                         Bonding = 0;
+            int                                         Pool = 0;
             struct {
                 int                                     Timeout = 10;
             }                                           Connect;
             struct {
                 int                                     Timeout = 5;
             }                                           Handshake;
+            struct {
+                int                                     Sndbuf = 0;
+                int                                     Rcvbuf = 0;
+                int                                     Bandwidth = 0;
+                int                                     NotsentLowat = 0;
+            }                                           Buffers;
+            struct {
+                bool                                    Enabled = false;
+                int                                     Threshold = 128; /* Frames below this many bytes skip the codec. */
+            }                                           Compression;
+            struct {
+                int                                     Version = 1; /* 2 = varint multi-payload frames; both tunnel ends must agree. */
+            }                                           Framing;
+            struct {
+                bool                                    Enabled = false;
+                int                                     Threshold = 512; /* Channels whose frame-size EWMA stays at or below this count as interactive. */
+            }                                           Priority;
+            struct {
+                bool                                    Enabled = false; /* Retune each connection's chunk from path RTT, MTU and goodput; needs framing version 2. */
+            }                                           Adaptive;
+            struct {
+                std::string                             IP;
+                int                                     Port = 0;
+            }                                           Metrics;
+            std::string                                 LogFile;
+            std::string                                 Path; /* Ini file this snapshot was loaded from; reloads re-read it. */
             enum ProtocolType {
                 ProtocolType_None,
                 ProtocolType_TCP = LoopbackMode_None,
@@ -43,6 +87,8 @@ namespace uds {
                 ProtocolType_WebSocket,
                 ProtocolType_WebSocket_SSL,
                 ProtocolType_WebSocket_TLS,
+                ProtocolType_ChaCha20Poly1305,
+                ProtocolType_UDP,
                 ProtocolType_MaxType,
             };
             ProtocolType                                Protocol = ProtocolType::ProtocolType_TCP;
@@ -52,12 +98,15 @@ namespace uds {
                 struct {
                     std::string                         Method;
                     std::string                         Password;
+                    bool                                Benchmark = false;
+                    bool                                Offload = false;
                 }                                       Encryptor;
             }                                           Protocols;
 
         public:
             static bool                                 IsInvalid(const std::shared_ptr<AppConfiguration>& config) noexcept;
             static bool                                 IsInvalid(const AppConfiguration& config) noexcept;
+            static bool                                 IsHotSwappable(const AppConfiguration& running, const AppConfiguration& next) noexcept;
             static std::shared_ptr<AppConfiguration>    LoadIniFile(const std::string& iniFile) noexcept;
         };
     }
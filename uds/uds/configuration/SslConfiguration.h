@@ -13,6 +13,7 @@ namespace uds {
             std::string                         CertificateChainFile;
             std::string                         CertificateKeyPassword;
             std::string                         Ciphersuites;
+            bool                                KernelTls = false; /* Push negotiated keys into the socket on Linux; elsewhere a no-op. */
 
         public:
             void                                ReleaseAllPairs() noexcept;
@@ -7,6 +7,8 @@ namespace uds {
         struct WebSocketConfiguration {
             std::string                         Host;
             std::string                         Path;
+            bool                                Compression = false;        /* RFC 7692 permessage-deflate on both roles. */
+            int                                 CompressionThreshold = 0;   /* Messages below this many bytes ship uncompressed. */
         };
     }
 }
\ No newline at end of file
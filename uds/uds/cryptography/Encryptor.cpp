@@ -1,9 +1,35 @@
 #include <uds/cryptography/Encryptor.h>
+#include <uds/threading/BufferslabPool.h>
+
+#include <openssl/kdf.h>
 
 namespace uds {
     namespace cryptography {
+        static bool Encryptor_Hkdf(const Byte* ikm, int ikmlen, const Byte* salt, int saltlen, Byte* out, int outlen) noexcept {
+            EVP_PKEY_CTX* context = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+            if (NULL == context) {
+                return false;
+            }
+
+            size_t feedbacklen = (size_t)outlen;
+            bool success =
+                EVP_PKEY_derive_init(context) > 0 &&
+                EVP_PKEY_CTX_set_hkdf_md(context, EVP_sha256()) > 0 &&
+                EVP_PKEY_CTX_set1_hkdf_salt(context, salt, saltlen) > 0 &&
+                EVP_PKEY_CTX_set1_hkdf_key(context, ikm, ikmlen) > 0 &&
+                EVP_PKEY_CTX_add1_hkdf_info(context, (const Byte*)"uds-encryptor-session", 21) > 0 &&
+                EVP_PKEY_derive(context, out, &feedbacklen) > 0 &&
+                feedbacklen == (size_t)outlen;
+
+            EVP_PKEY_CTX_free(context);
+            return success;
+        }
+
         Encryptor::Encryptor(const std::string& method, const std::string& password) noexcept
             : _cipher(NULL)
+            , _aead(false)
+            , _encryptCounter(0)
+            , _decryptCounter(0)
             , _method(method)
             , _password(password) {
             initKey(method, password);
@@ -30,6 +56,15 @@ namespace uds {
             if (EVP_BytesToKey(_cipher, EVP_md5(), NULL, (Byte*)password.data(), (int)password.length(), 1, _key.get(), _iv.get()) < 1) {
                 throw std::runtime_error("Bytes to key calculations cannot be performed using cipher with md5(md) key password iv key etc");
             }
+
+            /* The password-derived key and IV are deterministic: every transport is
+             * expected to call SessionKey with fresh salts before traffic flows. */
+            _encryptIV = _iv;
+            _decryptIV = _iv;
+
+            int mode = EVP_CIPHER_mode(_cipher);
+            _aead = mode == EVP_CIPH_GCM_MODE || mode == EVP_CIPH_OCB_MODE ||
+                (EVP_CIPHER_flags(_cipher) & EVP_CIPH_FLAG_AEAD_CIPHER) != 0; /* chacha20-poly1305 is AEAD but not a GCM/OCB mode. */
         }
 
         bool Encryptor::initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc, int raise) {
@@ -52,6 +87,12 @@ namespace uds {
                     if ((exception = EVP_CIPHER_CTX_set_padding(context.get(), 1) < 1)) {
                         break;
                     }
+                    /* Key the context exactly once: packets then stream through
+                     * EVP_CipherUpdate without rescheduling the key per frame. AEAD
+                     * contexts leave the IV unset and take a fresh nonce per frame. */
+                    if ((exception = EVP_CipherInit_ex(context.get(), NULL, NULL, _key.get(), _aead ? NULL : _iv.get(), enc) < 1)) {
+                        break;
+                    }
                 }
             } while (0);
             if (exception) {
@@ -75,25 +116,22 @@ namespace uds {
                 return NULL;
             }
 
-            std::shared_ptr<EVP_CIPHER_CTX>& context = _decryptCTX;
-            if (EVP_CipherInit_ex(context.get(), _cipher, NULL, _key.get(), _iv.get(), 0) < 1) { // INIT-CTX
-                return NULL;
-            }
-
             // DECR-DATA
             int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
-            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(feedbacklen);
+            std::shared_ptr<Byte> cipherText = uds::threading::BufferslabPool::Alloc(feedbacklen);
             if (NULL == cipherText) {
                 return NULL;
             }
 
-            if (EVP_CipherUpdate(context.get(),
-                cipherText.get(), &feedbacklen, data, datalen) < 1) {
-                feedbacklen = ~0;
+            if (_aead) {
+                if (!Open(data, datalen, cipherText.get(), outlen)) {
+                    outlen = ~0;
+                    return NULL;
+                }
+            }
+            elif(!Transform(_decryptCTX, data, datalen, cipherText.get(), outlen)) {
                 return NULL;
             }
-
-            outlen = feedbacklen;
             return cipherText;
         }
 
@@ -108,26 +146,178 @@ namespace uds {
                 return NULL;
             }
 
-            std::shared_ptr<EVP_CIPHER_CTX>& context = _encryptCTX;
-            if (EVP_CipherInit_ex(context.get(), _cipher, NULL, _key.get(), _iv.get(), 1) < 1) { // INIT-CTX
+            // ENCR-DATA
+            int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher) + Overhead();
+            std::shared_ptr<Byte> cipherText = uds::threading::BufferslabPool::Alloc(feedbacklen);
+            if (NULL == cipherText) {
                 return NULL;
             }
 
-            // ENCR-DATA
-            int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
-            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(feedbacklen);
-            if (NULL == cipherText) {
+            if (_aead) {
+                if (!Seal(data, datalen, cipherText.get(), outlen)) {
+                    outlen = ~0;
+                    return NULL;
+                }
+            }
+            elif(!Transform(_encryptCTX, data, datalen, cipherText.get(), outlen)) {
                 return NULL;
             }
+            return cipherText;
+        }
 
-            if (EVP_CipherUpdate(context.get(),
-                cipherText.get(), &feedbacklen, data, datalen) < 1) {
+        bool Encryptor::Encrypt(Byte* data, int datalen, Byte* destination, int& outlen) noexcept {
+            outlen = 0;
+            if (NULL == data || datalen < 1) {
                 outlen = ~0;
-                return NULL;
+                return false;
             }
 
-            outlen = feedbacklen;
-            return cipherText;
+            if (_aead) {
+                return Seal(data, datalen, destination, outlen);
+            }
+            return Transform(_encryptCTX, data, datalen, destination, outlen);
+        }
+
+        bool Encryptor::Decrypt(Byte* data, int datalen, Byte* destination, int& outlen) noexcept {
+            outlen = 0;
+            if (NULL == data || datalen < 1) {
+                outlen = ~0;
+                return false;
+            }
+
+            if (_aead) {
+                return Open(data, datalen, destination, outlen);
+            }
+            return Transform(_decryptCTX, data, datalen, destination, outlen);
+        }
+
+        bool Encryptor::SessionKey(const Byte* localSalt, const Byte* remoteSalt, int saltlen) noexcept {
+            if (NULL == _cipher || NULL == localSalt || NULL == remoteSalt || saltlen < 1) {
+                return false;
+            }
+
+            int keylen = EVP_CIPHER_key_length(_cipher);
+            int ivlen = EVP_CIPHER_iv_length(_cipher);
+
+            /* HKDF expands the password key under each direction's salt into a
+             * session key followed by a session base IV, so both peers derive the
+             * same material from the two salts without shipping keys on the wire. */
+            std::shared_ptr<Byte> sendBlock = make_shared_alloc<Byte>(keylen + ivlen);
+            std::shared_ptr<Byte> recvBlock = make_shared_alloc<Byte>(keylen + ivlen);
+            if (NULL == sendBlock || NULL == recvBlock) {
+                return false;
+            }
+
+            if (!Encryptor_Hkdf(_key.get(), keylen, localSalt, saltlen, sendBlock.get(), keylen + ivlen) ||
+                !Encryptor_Hkdf(_key.get(), keylen, remoteSalt, saltlen, recvBlock.get(), keylen + ivlen)) {
+                return false;
+            }
+
+            std::shared_ptr<Byte> sendIV = make_shared_alloc<Byte>(ivlen);
+            std::shared_ptr<Byte> recvIV = make_shared_alloc<Byte>(ivlen);
+            if (NULL == sendIV || NULL == recvIV) {
+                return false;
+            }
+
+            memcpy(sendIV.get(), sendBlock.get() + keylen, ivlen);
+            memcpy(recvIV.get(), recvBlock.get() + keylen, ivlen);
+
+            /* Re-key the long-lived contexts in place; AEAD contexts still take a
+             * fresh nonce per frame, now counted from the session base IV. */
+            if (EVP_CipherInit_ex(_encryptCTX.get(), NULL, NULL, sendBlock.get(), _aead ? NULL : sendIV.get(), 1) < 1 ||
+                EVP_CipherInit_ex(_decryptCTX.get(), NULL, NULL, recvBlock.get(), _aead ? NULL : recvIV.get(), 0) < 1) {
+                return false;
+            }
+
+            _encryptIV = sendIV;
+            _decryptIV = recvIV;
+            _encryptCounter = 0;
+            _decryptCounter = 0;
+            return true;
+        }
+
+        void Encryptor::NextNonce(Byte* nonce, uint64_t counter, const Byte* iv) noexcept {
+            int ivlen = EVP_CIPHER_iv_length(_cipher);
+            memcpy(nonce, iv, ivlen);
+
+            /* Both peers derive the frame nonce from the direction's session IV and
+             * the frame sequence, so no nonce bytes ever travel on the wire. */
+            for (int i = 0; i < 8 && i < ivlen; i++) {
+                nonce[ivlen - 1 - i] ^= (Byte)(counter >> (i << 3));
+            }
+        }
+
+        bool Encryptor::Seal(Byte* data, int datalen, Byte* destination, int& outlen) noexcept {
+            Byte nonce[EVP_MAX_IV_LENGTH];
+            NextNonce(nonce, _encryptCounter++, _encryptIV.get());
+
+            EVP_CIPHER_CTX* context = _encryptCTX.get();
+            if (EVP_CipherInit_ex(context, NULL, NULL, NULL, nonce, 1) < 1) {
+                return false;
+            }
+
+            int feedbacklen = 0;
+            if (EVP_CipherUpdate(context, destination, &feedbacklen, data, datalen) < 1) {
+                return false;
+            }
+
+            int finallen = 0;
+            if (EVP_CipherFinal_ex(context, destination + feedbacklen, &finallen) < 1) {
+                return false;
+            }
+
+            feedbacklen += finallen;
+            if (EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_GET_TAG, AEAD_TAG_SIZE, destination + feedbacklen) < 1) {
+                return false;
+            }
+
+            outlen = feedbacklen + AEAD_TAG_SIZE;
+            return true;
+        }
+
+        bool Encryptor::Open(Byte* data, int datalen, Byte* destination, int& outlen) noexcept {
+            if (datalen <= AEAD_TAG_SIZE) {
+                return false;
+            }
+
+            Byte nonce[EVP_MAX_IV_LENGTH];
+            NextNonce(nonce, _decryptCounter++, _decryptIV.get());
+
+            EVP_CIPHER_CTX* context = _decryptCTX.get();
+            if (EVP_CipherInit_ex(context, NULL, NULL, NULL, nonce, 0) < 1) {
+                return false;
+            }
+
+            if (EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_SET_TAG, AEAD_TAG_SIZE, data + datalen - AEAD_TAG_SIZE) < 1) {
+                return false;
+            }
+
+            int feedbacklen = 0;
+            if (EVP_CipherUpdate(context, destination, &feedbacklen, data, datalen - AEAD_TAG_SIZE) < 1) {
+                return false;
+            }
+
+            int finallen = 0;
+            if (EVP_CipherFinal_ex(context, destination + feedbacklen, &finallen) < 1) {
+                return false; /* The tag did not authenticate: drop the frame. */
+            }
+
+            outlen = feedbacklen + finallen;
+            return true;
+        }
+
+        bool Encryptor::Transform(const std::shared_ptr<EVP_CIPHER_CTX>& context, Byte* data, int datalen, Byte* destination, int& outlen) noexcept {
+            outlen = 0;
+            if (NULL == context || NULL == destination) {
+                outlen = ~0;
+                return false;
+            }
+
+            if (EVP_CipherUpdate(context.get(), destination, &outlen, data, datalen) < 1) {
+                outlen = ~0;
+                return false;
+            }
+            return true;
         }
 
         void Encryptor::Initialize() noexcept {
@@ -144,5 +334,44 @@ namespace uds {
             }
             return NULL != EVP_get_cipherbyname(method.data());
         }
+
+        double Encryptor::Throughput(const std::string& method, const std::string& password, int milliseconds) noexcept {
+            static const int EBENCHMARK_MSS = 65536;
+
+            if (milliseconds < 1 || password.empty() || !Support(method)) {
+                return 0;
+            }
+
+            std::shared_ptr<Byte> plainText = make_shared_alloc<Byte>(EBENCHMARK_MSS);
+            if (NULL == plainText) {
+                return 0;
+            }
+
+            Byte* p = plainText.get();
+            for (int i = 0; i < EBENCHMARK_MSS; i++) {
+                p[i] = (Byte)RandomNext(0x00, 0xff);
+            }
+
+            /* Sealed frames per wall-clock slice: the fastest method on a given box is
+             * whatever OpenSSL dispatches to the local hardware (AES-NI, NEON, ...). */
+            try {
+                Encryptor encryptor(method, password);
+                uint64_t bytes = 0;
+                uint64_t deadline = GetTickCount() + milliseconds;
+
+                while (GetTickCount() < deadline) {
+                    int outlen;
+                    std::shared_ptr<Byte> cipherText = encryptor.Encrypt(p, EBENCHMARK_MSS, outlen);
+                    if (NULL == cipherText || outlen < 1) {
+                        return 0;
+                    }
+                    bytes += EBENCHMARK_MSS;
+                }
+                return bytes * (1000.0 / milliseconds);
+            }
+            catch (std::exception&) {
+                return 0;
+            }
+        }
     }
 }
\ No newline at end of file
@@ -5,25 +5,66 @@
 namespace uds {
     namespace cryptography {
         class Encryptor final {
+        public:
+            static const int                                    AEAD_TAG_SIZE = 16;
+            static const int                                    SESSION_SALT_SIZE = 16;
+
         public:
             Encryptor(const std::string& method, const std::string& password) noexcept;
 
         public:
             static void                                         Initialize() noexcept;
             static bool                                         Support(const std::string& method) noexcept;
+            static double                                       Throughput(const std::string& method, const std::string& password, int milliseconds) noexcept;
+
+        public:
+            /* Re-key both directions from per-session random salts: the send
+             * direction from the locally drawn salt, the receive direction from
+             * the peer's. Without this every connection built from the same
+             * password counts AEAD nonces from the same base IV and zero. */
+            bool                                                SessionKey(const Byte* localSalt, const Byte* remoteSalt, int saltlen) noexcept;
 
         public:
             std::shared_ptr<Byte>                               Encrypt(Byte* data, int datalen, int& outlen) noexcept;
             std::shared_ptr<Byte>                               Decrypt(Byte* data, int datalen, int& outlen) noexcept;
 
+        public:
+            /* Streaming transforms into a caller owned buffer; destination may alias
+             * data, and must leave BlockSize() - 1 bytes of headroom behind datalen. */
+            bool                                                Encrypt(Byte* data, int datalen, Byte* destination, int& outlen) noexcept;
+            bool                                                Decrypt(Byte* data, int datalen, Byte* destination, int& outlen) noexcept;
+            inline int                                          BlockSize() noexcept {
+                return _cipher ? EVP_CIPHER_block_size(_cipher) : 0;
+            }
+            inline bool                                         Aead() noexcept {
+                return _aead;
+            }
+            inline int                                          Overhead() noexcept {
+                return _aead ? AEAD_TAG_SIZE : 0;
+            }
+            inline bool                                         Streaming() noexcept {
+                return !_aead && BlockSize() == 1;
+            }
+
+        private:
+            bool                                                Transform(const std::shared_ptr<EVP_CIPHER_CTX>& context, Byte* data, int datalen, Byte* destination, int& outlen) noexcept;
+            bool                                                Seal(Byte* data, int datalen, Byte* destination, int& outlen) noexcept;
+            bool                                                Open(Byte* data, int datalen, Byte* destination, int& outlen) noexcept;
+            void                                                NextNonce(Byte* nonce, uint64_t counter, const Byte* iv) noexcept;
+
         private:
             bool                                                initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc, int raise);
             void                                                initKey(const std::string& method, const std::string password);
 
         private:
             const EVP_CIPHER*                                   _cipher;
+            bool                                                _aead;
+            uint64_t                                            _encryptCounter;
+            uint64_t                                            _decryptCounter;
             std::shared_ptr<Byte>                               _key; // _cipher->key_len
             std::shared_ptr<Byte>                               _iv;
+            std::shared_ptr<Byte>                               _encryptIV; /* Per-session direction IVs; alias _iv until SessionKey runs. */
+            std::shared_ptr<Byte>                               _decryptIV;
             std::string                                         _method;
             std::string                                         _password;
             std::shared_ptr<EVP_CIPHER_CTX>                     _encryptCTX;
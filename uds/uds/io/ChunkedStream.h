@@ -0,0 +1,259 @@
+#pragma once
+
+#include <string.h>
+#include <uds/stdafx.h>
+#include <uds/io/Stream.h>
+#include <uds/threading/BufferslabPool.h>
+
+namespace uds {
+    namespace io {
+        /* Rope-backed stream built from fixed-size slab segments. Growing never re-copies
+         * previously written bytes the way MemoryStream's doubling does: a new segment is
+         * appended and older segments stay where they are. Segments come from the per-thread
+         * BufferslabPool, so message assembly recycles the same blocks the transmission
+         * stack already pools instead of taking fresh heap allocations. */
+        class ChunkedStream : public Stream {
+        public:
+            const int                           ECHUNKEDSTREAM_CSS = 8192; /* Segment payload size; an exact slab clazz so segments recycle through the pool. */
+
+        public:
+            inline ChunkedStream() noexcept
+                : _disposed(false)
+                , _position(0)
+                , _length(0) {
+
+            }
+
+        public:
+            virtual bool                        CanSeek() noexcept override { return true; }
+            virtual bool                        CanRead() noexcept override { return true; }
+            virtual bool                        CanWrite() noexcept override { return true; }
+
+        public:
+            virtual int                         GetPosition() noexcept override { return this->_position; }
+            virtual int                         GetLength() noexcept override { return this->_length; }
+
+        public:
+            virtual bool                        Seek(int offset, SeekOrigin loc) noexcept override {
+                if (this->_disposed) {
+                    return false;
+                }
+                switch (loc) {
+                case SeekOrigin::Begin: {
+                    int now = offset;
+                    if (now < 0 || now > this->_length) {
+                        return false;
+                    }
+                    this->_position = offset;
+                    break;
+                }
+                case SeekOrigin::Current: {
+                    int now = this->_position + offset;
+                    if (now < 0 || now > this->_length) {
+                        return false;
+                    }
+                    this->_position = now;
+                    break;
+                }
+                case SeekOrigin::End: {
+                    int now = this->_length + offset;
+                    if (now < 0 || now > this->_length) {
+                        return false;
+                    }
+                    this->_position = now;
+                    break;
+                }
+                default:
+                    return false;
+                }
+                return true;
+            }
+            virtual bool                        SetPosition(int position) noexcept override { return this->Seek(position, SeekOrigin::Begin); }
+            virtual bool                        SetLength(int value) noexcept override {
+                if (this->_disposed) {
+                    return false;
+                }
+                if (value < 0) {
+                    return false;
+                }
+                if (!this->EnsureLength(value)) {
+                    return false;
+                }
+                this->_length = value;
+                if (this->_position > value) {
+                    this->_position = value;
+                }
+                return true;
+            }
+            virtual void                        Dispose() noexcept override {
+                if (!this->_disposed) {
+                    this->_position = 0;
+                    this->_length = 0;
+                    this->_segments.clear();
+                    this->_disposed = true;
+                }
+            }
+
+        public:
+            virtual bool                        WriteByte(Byte value) noexcept override { return this->Write(&value, 0, 1); }
+            virtual bool                        Write(const void* buffer, int offset, int count) noexcept override {
+                if (this->_disposed) {
+                    return false;
+                }
+                if (NULL == buffer) {
+                    if (offset == 0 && count == 0) {
+                        return true;
+                    }
+                    return false;
+                }
+                if (offset < 0) {
+                    return false;
+                }
+                if (count < 0) {
+                    return false;
+                }
+                if (count == 0) {
+                    return true;
+                }
+                int num = this->_position + count;
+                if (num < 0) {
+                    return false;
+                }
+                if (!this->EnsureLength(num)) {
+                    return false;
+                }
+                char* data = (char*)buffer + offset;
+                while (count > 0) {
+                    int index = this->_position / this->ECHUNKEDSTREAM_CSS;
+                    int inner = this->_position % this->ECHUNKEDSTREAM_CSS;
+                    int bytes = this->ECHUNKEDSTREAM_CSS - inner;
+                    if (bytes > count) {
+                        bytes = count;
+                    }
+                    memcpy(this->_segments[index].get() + inner, data, bytes);
+                    data += bytes;
+                    count -= bytes;
+                    this->_position += bytes;
+                }
+                if (num > this->_length) {
+                    this->_length = num;
+                }
+                return true;
+            }
+
+        public:
+            virtual int                         ReadByte() noexcept override {
+                Byte value;
+                if (this->Read(&value, 0, 1) != 1) {
+                    return -1;
+                }
+                return value;
+            }
+            virtual int                         Read(const void* buffer, int offset, int count) noexcept override {
+                if (this->_disposed) {
+                    return -1;
+                }
+                if (NULL == buffer) {
+                    if (offset == 0 && count == 0) {
+                        return 0;
+                    }
+                    return -1;
+                }
+                if (offset < 0) {
+                    return -1;
+                }
+                if (count < 0) {
+                    return -1;
+                }
+                elif (count == 0) {
+                    return 0;
+                }
+                int num = this->_length - this->_position;
+                if (num > count) {
+                    num = count;
+                }
+                if (num < 1) {
+                    return 0;
+                }
+                char* data = (char*)buffer + offset;
+                for (int left = num; left > 0;) {
+                    int index = this->_position / this->ECHUNKEDSTREAM_CSS;
+                    int inner = this->_position % this->ECHUNKEDSTREAM_CSS;
+                    int bytes = this->ECHUNKEDSTREAM_CSS - inner;
+                    if (bytes > left) {
+                        bytes = left;
+                    }
+                    memcpy(data, this->_segments[index].get() + inner, bytes);
+                    data += bytes;
+                    left -= bytes;
+                    this->_position += bytes;
+                }
+                return num;
+            }
+
+        public:
+            /* Iovec-style view of the written bytes for the asio gather-write path; the
+             * stream keeps ownership, so it must outlive the write it backs. */
+            inline int                          GetBuffers(std::vector<boost::asio::const_buffer>& buffers) noexcept {
+                if (this->_disposed) {
+                    return 0;
+                }
+                int length = this->_length;
+                for (int position = 0; position < length;) {
+                    int index = position / this->ECHUNKEDSTREAM_CSS;
+                    int bytes = length - position;
+                    if (bytes > this->ECHUNKEDSTREAM_CSS) {
+                        bytes = this->ECHUNKEDSTREAM_CSS;
+                    }
+                    buffers.push_back(boost::asio::const_buffer(this->_segments[index].get(), bytes));
+                    position += bytes;
+                }
+                return length;
+            }
+            inline std::shared_ptr<Byte>        ToArray(int& length) noexcept {
+                length = this->_length;
+                if (length < 1) {
+                    length = 0;
+                    return NULL;
+                }
+                if (length <= this->ECHUNKEDSTREAM_CSS) { /* Single-segment ropes hand back the segment itself without a copy. */
+                    return this->_segments[0];
+                }
+                std::shared_ptr<Byte> dest = uds::threading::BufferslabPool::Alloc(length);
+                if (NULL == dest) {
+                    length = 0;
+                    return NULL;
+                }
+                for (int position = 0; position < length;) {
+                    int index = position / this->ECHUNKEDSTREAM_CSS;
+                    int bytes = length - position;
+                    if (bytes > this->ECHUNKEDSTREAM_CSS) {
+                        bytes = this->ECHUNKEDSTREAM_CSS;
+                    }
+                    memcpy(dest.get() + position, this->_segments[index].get(), bytes);
+                    position += bytes;
+                }
+                return dest;
+            }
+
+        private:
+            inline bool                         EnsureLength(int value) noexcept {
+                int segments = (value + this->ECHUNKEDSTREAM_CSS - 1) / this->ECHUNKEDSTREAM_CSS;
+                while ((int)this->_segments.size() < segments) {
+                    std::shared_ptr<Byte> segment = uds::threading::BufferslabPool::Alloc(this->ECHUNKEDSTREAM_CSS);
+                    if (NULL == segment) {
+                        return false;
+                    }
+                    this->_segments.emplace_back(segment);
+                }
+                return true;
+            }
+
+        private:
+            bool                                _disposed;
+            int                                 _position;
+            int                                 _length;
+            std::vector<std::shared_ptr<Byte>>  _segments;
+        };
+    }
+}
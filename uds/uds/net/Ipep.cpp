@@ -8,9 +8,68 @@
 #endif
 
 #include <uds/net/Ipep.h>
+#include <uds/threading/Hosting.h>
 
 namespace uds {
     namespace net {
+        /* Resolver cache: answers are reused for a fixed TTL (the asio resolver does not
+         * surface record TTLs) and refreshed in the background once half of it has
+         * elapsed; failures are pinned briefly so a dead name cannot hammer the resolver. */
+        static const UInt64 EDNS_CACHE_TTL          = 120 * 1000;
+        static const UInt64 EDNS_CACHE_NEGATIVE_TTL = 5 * 1000;
+
+        class DnsCacheEntry final {
+        public:
+            std::vector<IPEndPoint>                             addresses_;
+            UInt64                                              expired_ = 0;
+        };
+
+        static std::mutex                                       dns_syncobj_;
+        static std::unordered_map<std::string, DnsCacheEntry>   dns_entries_;
+
+        int Ipep::QueryCache(const std::string& hostname, int port, std::vector<IPEndPoint>& addresses) noexcept {
+            UInt64 now = uds::threading::Hosting::CachedMillisec();
+            std::lock_guard<std::mutex> scope(dns_syncobj_);
+
+            auto tail = dns_entries_.find(hostname);
+            if (tail == dns_entries_.end()) {
+                return 0;
+            }
+
+            DnsCacheEntry& entry = tail->second;
+            if (now >= entry.expired_) {
+                dns_entries_.erase(tail);
+                return 0;
+            }
+
+            for (const IPEndPoint& i : entry.addresses_) {
+                IPEndPoint localEP = i;
+                constantof(localEP.Port) = port;
+                addresses.push_back(localEP);
+            }
+
+            UInt64 ttl = entry.addresses_.empty() ? EDNS_CACHE_NEGATIVE_TTL : EDNS_CACHE_TTL;
+            return (entry.expired_ - now) <= (ttl >> 1) ? 2 : 1;
+        }
+
+        void Ipep::UpdateCache(const std::string& hostname, const std::vector<IPEndPoint>& addresses) noexcept {
+            UInt64 now = uds::threading::Hosting::CachedMillisec();
+            std::lock_guard<std::mutex> scope(dns_syncobj_);
+
+            DnsCacheEntry& entry = dns_entries_[hostname];
+            if (addresses.empty()) {
+                /* A transient refresh failure must not evict a good answer. */
+                if (!entry.addresses_.empty() && now < entry.expired_) {
+                    return;
+                }
+                entry.expired_ = now + EDNS_CACHE_NEGATIVE_TTL;
+            }
+            else {
+                entry.expired_ = now + EDNS_CACHE_TTL;
+            }
+            entry.addresses_ = addresses;
+        }
+
         IPEndPoint Ipep::GetEndPoint(const std::string& address, bool resolver) noexcept {
             if (address.empty()) {
                 return Ipep::GetEndPoint(address, 0);
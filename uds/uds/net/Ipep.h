@@ -20,6 +20,12 @@ namespace uds {
             static bool                                                         ToEndPoint(const std::string& addresses, std::vector<std::string>& out) noexcept;
             static bool                                                         IsDomainAddress(const std::string& domain) noexcept;
 
+        public:
+            /* Resolver cache: 0 is a miss, 1 a fresh hit, 2 a hit whose entry is past
+             * half of its TTL and should be refreshed in the background. */
+            static int                                                          QueryCache(const std::string& hostname, int port, std::vector<IPEndPoint>& addresses) noexcept;
+            static void                                                         UpdateCache(const std::string& hostname, const std::vector<IPEndPoint>& addresses) noexcept;
+
         public:
             template<class TProtocol>
             inline static void                                                  GetAddressByHostName(const std::shared_ptr<boost::asio::ip::basic_resolver<TProtocol> >& resolver, const std::string& hostname, int port, const std::shared_ptr<GetAddressByHostNameCallback>& callback) {
@@ -81,15 +87,36 @@ namespace uds {
                     return;
                 }
 
-                std::shared_ptr<GetAddressesByHostNameCallback> callback_ = callback;
+                std::shared_ptr<GetAddressesByHostNameCallback> callback_ = callback; {
+                    std::vector<IPEndPoint> addresses;
+                    int status = QueryCache(hostname, port, addresses);
+                    if (status) {
+                        (*callback_)(addresses);
+                        if (status < 2) {
+                            return;
+                        }
+
+                        /* Served from the cache: the resolve below only refreshes the entry. */
+                        callback_ = make_shared_object<GetAddressesByHostNameCallback>([](std::vector<IPEndPoint>&) noexcept {});
+                        if (NULL == callback_) {
+                            return;
+                        }
+                    }
+                }
+
+                const std::string shostname = hostname;
                 auto completion_resolve = [](
                     std::vector<IPEndPoint>& addresses,
                     typename protocol_resolver::iterator& i,
                     typename protocol_resolver::iterator& l,
                     const std::shared_ptr<GetAddressesByHostNameCallback>& callback) noexcept {
                         for (; i != l; ++i) {
+                            /* Both families survive resolution: connect racing needs the
+                             * v6 candidates, and GetAddressByHostName still prefers v4 for
+                             * the single-address callers. */
                             boost::asio::ip::basic_endpoint<TProtocol> localEP = std::move(*i);
-                            if (!localEP.address().is_v4()) {
+                            boost::asio::ip::address address = localEP.address();
+                            if (!address.is_v4() && !address.is_v6()) {
                                 continue;
                             }
                             addresses.push_back(IPEndPoint::ToEndPoint<TProtocol>(localEP));
@@ -99,7 +126,7 @@ namespace uds {
                 typename protocol_resolver::query q(hostname.c_str(), std::to_string(port).c_str());
 #ifndef _WIN32
                 resolver.async_resolve(q,
-                    [completion_resolve, callback_](const boost::system::error_code& ec, typename protocol_resolver::iterator results) noexcept {
+                    [completion_resolve, callback_, shostname](const boost::system::error_code& ec, typename protocol_resolver::iterator results) noexcept {
                         std::vector<IPEndPoint> addresses;
                         if (!ec) {
                             typename protocol_resolver::iterator i = std::move(results);
@@ -107,11 +134,12 @@ namespace uds {
 
                             completion_resolve(addresses, i, l, callback_);
                         }
+                        UpdateCache(shostname, addresses);
                         (*callback_)(addresses);
                     });
 #else
                 resolver.async_resolve(q,
-                    [completion_resolve, callback_](const boost::system::error_code& ec, typename protocol_resolver::results_type results) noexcept {
+                    [completion_resolve, callback_, shostname](const boost::system::error_code& ec, typename protocol_resolver::results_type results) noexcept {
                         std::vector<IPEndPoint> addresses;
                         if (!ec) {
                             if (!results.empty()) {
@@ -121,6 +149,7 @@ namespace uds {
                                 completion_resolve(addresses, i, l, callback_);
                             }
                         }
+                        UpdateCache(shostname, addresses);
                         (*callback_)(addresses);
                     });
 #endif
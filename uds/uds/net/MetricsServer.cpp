@@ -0,0 +1,161 @@
+#include <uds/net/MetricsServer.h>
+#include <uds/threading/Statistics.h>
+#include <uds/threading/BufferslabPool.h>
+
+namespace uds {
+    namespace net {
+        MetricsServer::MetricsServer(const HostingPtr& hosting, const boost::asio::ip::address& interfaceIP, int port) noexcept
+            : disposed_(false)
+            , hosting_(hosting)
+            , interface_(interfaceIP)
+            , port_(port) {
+
+        }
+
+        bool MetricsServer::Listen() noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            if (disposed_ || !hosting_) {
+                return false;
+            }
+
+            if (port_ <= IPEndPoint::MinPort || port_ > IPEndPoint::MaxPort) {
+                return false;
+            }
+
+            const std::shared_ptr<boost::asio::io_context> context = hosting_->GetContext();
+            if (!context) {
+                return false;
+            }
+
+            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = NewReference<boost::asio::ip::tcp::acceptor>(*context);
+            if (!Socket::OpenAcceptor(*acceptor, interface_, port_, 16, false, true)) {
+                Socket::Closesocket(*acceptor);
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            if (!Socket::AcceptLoopbackAsync(hosting_, acceptor,
+                [references, this](const std::shared_ptr<boost::asio::io_context>& context, const AsioTcpSocket& socket) noexcept {
+                    return ServeClient(socket);
+                })) {
+                Socket::Closesocket(*acceptor);
+                return false;
+            }
+
+            acceptor_ = std::move(acceptor);
+            return true;
+        }
+
+        void MetricsServer::AddSource(const BOOST_ASIO_MOVE_ARG(MetricsSource) source) noexcept {
+            MetricsSource source_ = BOOST_ASIO_MOVE_CAST(MetricsSource)(constantof(source));
+            if (source_) {
+                MutexScope scope(syncobj_);
+                sources_.push_back(std::move(source_));
+            }
+        }
+
+        void MetricsServer::Dispose() noexcept {
+            if (!disposed_.exchange(true)) {
+                Socket::Closesocket(acceptor_);
+            }
+        }
+
+        bool MetricsServer::ServeClient(const AsioTcpSocket& socket) noexcept {
+            if (disposed_ || !socket) {
+                return false;
+            }
+
+            /* The request line is consumed and ignored: whatever the path, the
+             * scraper gets the whole exposition and the connection is closed. */
+            const std::shared_ptr<Byte> request = uds::threading::BufferslabPool::Alloc(512);
+            if (!request) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            socket->async_read_some(boost::asio::buffer(request.get(), 512),
+                [references, this, socket, request](const boost::system::error_code& ec, size_t sz) noexcept {
+                    if (ec) {
+                        Socket::Closesocket(socket);
+                        return;
+                    }
+
+                    std::string body = RenderExposition();
+
+                    char headers[160];
+                    int headers_size = snprintf(headers, sizeof(headers),
+                        "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: text/plain; version=0.0.4\r\n"
+                        "Content-Length: %d\r\n"
+                        "Connection: close\r\n\r\n", (int)body.size());
+                    if (headers_size < 1) {
+                        Socket::Closesocket(socket);
+                        return;
+                    }
+
+                    const std::shared_ptr<std::string> response = make_shared_object<std::string>(std::string(headers, headers_size) + body);
+                    boost::asio::async_write(*socket, boost::asio::buffer(response->data(), response->size()),
+                        [socket, response](const boost::system::error_code& ec, size_t sz) noexcept {
+                            Socket::Closesocket(socket);
+                        });
+                });
+            return true;
+        }
+
+        std::string MetricsServer::RenderExposition() noexcept {
+            typedef uds::threading::Statistics Statistics;
+
+            Statistics::Counters counters;
+            Statistics::Collect(counters);
+
+            char line[256];
+            std::string body;
+            body.reserve(2048);
+
+            snprintf(line, sizeof(line),
+                "# TYPE uds_inbound_bytes_total counter\n"
+                "uds_inbound_bytes_total %llu\n"
+                "# TYPE uds_inbound_frames_total counter\n"
+                "uds_inbound_frames_total %llu\n"
+                "# TYPE uds_outbound_bytes_total counter\n"
+                "uds_outbound_bytes_total %llu\n"
+                "# TYPE uds_outbound_frames_total counter\n"
+                "uds_outbound_frames_total %llu\n",
+                (unsigned long long)counters.inbound_bytes_,
+                (unsigned long long)counters.inbound_frames_,
+                (unsigned long long)counters.outbound_bytes_,
+                (unsigned long long)counters.outbound_frames_);
+            body.append(line);
+
+            snprintf(line, sizeof(line),
+                "# TYPE uds_write_queue_bytes gauge\n"
+                "uds_write_queue_bytes %lld\n",
+                (long long)counters.queued_bytes_);
+            body.append(line);
+
+            /* Cumulative log2 buckets in the histogram convention. */
+            body.append("# TYPE uds_write_latency_ms histogram\n");
+
+            uint64_t cumulative = 0;
+            for (int i = 0; i < Statistics::ESTATISTICS_BUCKETS; i++) {
+                cumulative += counters.latency_[i];
+                snprintf(line, sizeof(line), "uds_write_latency_ms_bucket{le=\"%llu\"} %llu\n",
+                    (unsigned long long)(1ull << i), (unsigned long long)cumulative);
+                body.append(line);
+            }
+
+            snprintf(line, sizeof(line),
+                "uds_write_latency_ms_bucket{le=\"+Inf\"} %llu\n"
+                "uds_write_latency_ms_count %llu\n",
+                (unsigned long long)cumulative, (unsigned long long)cumulative);
+            body.append(line);
+
+            MutexScope scope(syncobj_);
+            for (MetricsSource& source : sources_) {
+                source(body);
+            }
+            return body;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <uds/net/Socket.h>
+#include <uds/net/IPEndPoint.h>
+
+namespace uds {
+    namespace net {
+        /* Tiny plaintext /metrics listener in the Prometheus text exposition
+         * format. Scrapes read the pre-aggregated Statistics shards plus any
+         * sources the owner registered at startup; the data path is never
+         * touched, so a scrape costs the scraped box nothing but one accept. */
+        class MetricsServer final : public Reference {
+            typedef std::mutex                                      Mutex;
+            typedef std::lock_guard<Mutex>                          MutexScope;
+
+        public:
+            typedef std::shared_ptr<uds::threading::Hosting>        HostingPtr;
+            typedef std::shared_ptr<boost::asio::ip::tcp::socket>   AsioTcpSocket;
+            typedef std::function<void(std::string&)>               MetricsSource;
+
+        public:
+            MetricsServer(const HostingPtr& hosting, const boost::asio::ip::address& interfaceIP, int port) noexcept;
+
+        public:
+            bool                                                    Listen() noexcept;
+            void                                                    AddSource(const BOOST_ASIO_MOVE_ARG(MetricsSource) source) noexcept;
+            void                                                    Dispose() noexcept;
+
+        private:
+            std::string                                             RenderExposition() noexcept;
+            bool                                                    ServeClient(const AsioTcpSocket& socket) noexcept;
+
+        private:
+            std::atomic<bool>                                       disposed_;
+            HostingPtr                                              hosting_;
+            boost::asio::ip::address                                interface_;
+            int                                                     port_;
+            Mutex                                                   syncobj_;
+            std::vector<MetricsSource>                              sources_;
+            std::shared_ptr<boost::asio::ip::tcp::acceptor>         acceptor_;
+        };
+    }
+}
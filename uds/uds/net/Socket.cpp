@@ -209,7 +209,7 @@ namespace uds {
             static int defaultTtl = 0;
             static UInt64 lastTime = 0;
 
-            UInt64 nowTime = GetTickCount();
+            UInt64 nowTime = uds::threading::Hosting::CachedMillisec();
             if (defaultTtl < 1 || (nowTime - lastTime) >= 1000 || lastTime > nowTime) {
                 int ttl = 32;
                 int fd = socket(AF_INET, SOCK_DGRAM, 0);
@@ -268,6 +268,23 @@ namespace uds {
             return err == 0;
         }
 
+        bool Socket::SetFastOpenConnect(int fd, bool fastOpen) noexcept {
+            if (fd == -1) {
+                return false;
+            }
+
+            int err = -1;
+#ifdef TCP_FASTOPEN_CONNECT
+            /* Client-side fast open: connect() returns at once and the first write
+             * rides in the SYN payload (Linux 4.11+). Against a peer that handed out
+             * a TFO cookie on an earlier dial, the handshake frame reaches it a full
+             * RTT before a plain connect would have finished. */
+            int flag = fastOpen ? 1 : 0;
+            err = ::setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, (char*)&flag, sizeof(flag));
+#endif
+            return err == 0;
+        }
+
         bool Socket::ReuseSocketAddress(int fd, bool reuse) noexcept {
             if (fd == -1) {
                 return false;
@@ -276,6 +293,118 @@ namespace uds {
             return ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (char*)&flag, sizeof(flag)) == 0;
         }
 
+        bool Socket::ReuseSocketPort(int fd, bool reuse) noexcept {
+            if (fd == -1) {
+                return false;
+            }
+
+            int err = -1;
+#ifdef SO_REUSEPORT
+            int flag = reuse ? 1 : 0;
+            err = ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char*)&flag, sizeof(flag));
+#endif
+            return err == 0;
+        }
+
+        Socket::BufferTuning Socket::Buffers;
+        int                  Socket::ConcurrentAccepts = 1;
+
+        bool Socket::SetSendBufferSize(int fd, int size) noexcept {
+            if (fd == -1 || size < 1) {
+                return false;
+            }
+            return ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, (char*)&size, sizeof(size)) == 0;
+        }
+
+        bool Socket::SetReceiveBufferSize(int fd, int size) noexcept {
+            if (fd == -1 || size < 1) {
+                return false;
+            }
+            return ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, (char*)&size, sizeof(size)) == 0;
+        }
+
+        bool Socket::SetNotsentLowat(int fd, int bytes) noexcept {
+            if (fd == -1 || bytes < 1) {
+                return false;
+            }
+
+            int err = -1;
+#ifdef TCP_NOTSENT_LOWAT
+            err = ::setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (char*)&bytes, sizeof(bytes));
+#endif
+            return err == 0;
+        }
+
+        int Socket::GetRoundTripTime(int fd) noexcept {
+            if (fd == -1) {
+                return 0;
+            }
+
+#if defined(__linux__)
+            struct tcp_info ti;
+            socklen_t len = sizeof(ti);
+            if (::getsockopt(fd, IPPROTO_TCP, TCP_INFO, (char*)&ti, &len) < 0) {
+                return 0;
+            }
+            return (int)ti.tcpi_rtt; /* Smoothed RTT in microseconds; zero before the handshake measured one. */
+#else
+            return 0;
+#endif
+        }
+
+        int Socket::GetPathMtu(int fd) noexcept {
+            if (fd == -1) {
+                return 0;
+            }
+
+            int mtu = 0;
+#if defined(__linux__)
+            socklen_t len = sizeof(mtu);
+            if (::getsockopt(fd, IPPROTO_IP, IP_MTU, (char*)&mtu, &len) < 0) {
+#if defined(IPV6_MTU)
+                len = sizeof(mtu);
+                if (::getsockopt(fd, IPPROTO_IPV6, IPV6_MTU, (char*)&mtu, &len) < 0) {
+                    mtu = 0;
+                }
+#else
+                mtu = 0;
+#endif
+            }
+#endif
+            return mtu; /* Discovered path MTU of the connected socket; zero when unknown. */
+        }
+
+        void Socket::AdjustSocketBuffers(int fd) noexcept {
+            if (fd == -1) {
+                return;
+            }
+
+            int sndbuf = Buffers.sndbuf;
+            int rcvbuf = Buffers.rcvbuf;
+            if (Buffers.bandwidth > 0) {
+                int rtt = GetRoundTripTime(fd);
+                if (rtt > 0) {
+                    /* Two BDPs of headroom: one in flight, one queued behind it. A LAN
+                     * hop sizes small and stays shallow, a long-RTT link sizes deep. */
+                    int64_t bdp = ((int64_t)Buffers.bandwidth * 125000) * rtt / 1000000 * 2;
+                    bdp = std::max<int64_t>(bdp, 64 * 1024);
+                    bdp = std::min<int64_t>(bdp, 16 * 1024 * 1024);
+
+                    if (sndbuf < 1) {
+                        sndbuf = (int)bdp;
+                    }
+
+                    if (rcvbuf < 1) {
+                        rcvbuf = (int)bdp;
+                    }
+                }
+            }
+
+            SetSendBufferSize(fd, sndbuf);
+            SetReceiveBufferSize(fd, rcvbuf);
+            SetNotsentLowat(fd, Buffers.notsent_lowat);
+        }
+
         void Socket::AdjustDefaultSocketOptional(int sockfd, bool in4) noexcept {
             if (sockfd != -1) {
                 uint8_t tos = 0x68;
@@ -432,15 +561,99 @@ namespace uds {
                 return false;
             }
 
-            const AsioContext context_ = hosting->GetContext();
+            /* Prime the accept pipeline: every outstanding accept re-arms itself on
+             * completion, so the depth chosen here is held for the acceptor lifetime. */
+            const AcceptLoopbackCallback accept_ = BOOST_ASIO_MOVE_CAST(AcceptLoopbackCallback)(constantof(callback));
+
+            int concurrent = ConcurrentAccepts;
+            if (concurrent < 1) {
+                concurrent = 1;
+            }
+
+            for (int i = 0; i < concurrent; i++) {
+                if (!AcceptLoopbackOnce(hosting, acceptor, accept_)) {
+                    if (i < 1) { /* Not a single accept could be posted. */
+                        Closesocket(acceptor);
+                        return false;
+                    }
+                    break;
+                }
+            }
+            return true;
+        }
+
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+        /* With cpu-affinity on, re-home an accepted flow onto the hosting context whose
+         * thread is pinned to the CPU that received its packets (the NIC RSS queue), so
+         * frames are read, processed and re-sent without crossing cores or NUMA nodes. */
+        static void Socket_AlignIncomingCpu(
+            const std::shared_ptr<uds::threading::Hosting>&         hosting,
+            std::shared_ptr<boost::asio::io_context>&               context,
+            std::shared_ptr<boost::asio::ip::tcp::socket>&          socket) noexcept {
+            if (!uds::threading::Hosting::Affinity) {
+                return;
+            }
+
+            int cpu = -1;
+            socklen_t size = sizeof(cpu);
+            if (getsockopt(socket->native_handle(), SOL_SOCKET, SO_INCOMING_CPU, (char*)&cpu, &size) < 0 || cpu < 0) {
+                return;
+            }
+
+            const std::shared_ptr<boost::asio::io_context> preferred = hosting->GetContext(cpu);
+            if (preferred) {
+                Socket::RehomeSocket(context, socket, preferred);
+            }
+        }
+#endif
+
+        bool Socket::RehomeSocket(
+            std::shared_ptr<boost::asio::io_context>&               context,
+            std::shared_ptr<boost::asio::ip::tcp::socket>&          socket,
+            const std::shared_ptr<boost::asio::io_context>&         preferred) noexcept {
+            if (!preferred || !socket || preferred == context) {
+                return false;
+            }
+
+            boost::system::error_code ec;
+            boost::asio::ip::tcp protocol = socket->local_endpoint(ec).protocol();
+            if (ec) {
+                return false;
+            }
+
+            boost::asio::ip::tcp::socket::native_handle_type handle = socket->release(ec);
+            if (ec) {
+                return false;
+            }
+
+            const std::shared_ptr<boost::asio::ip::tcp::socket> rehomed = make_shared_object<boost::asio::ip::tcp::socket>(*preferred);
+            rehomed->assign(protocol, handle, ec);
+            if (ec) {
+                Closesocket((int)handle); /* The original socket already let go of the descriptor. */
+                return false;
+            }
+
+            context = preferred;
+            socket = rehomed;
+            return true;
+        }
+
+        bool Socket::AcceptLoopbackOnce(
+            const Hosting&                                          hosting,
+            const boost::asio::ip::tcp::acceptor&                   acceptor,
+            const AcceptLoopbackCallback&                           callback) noexcept {
+            if (!acceptor.is_open()) {
+                return false;
+            }
+
+            const AsioContext context_ = hosting->LeastContext(); /* Place the next accepted flow on the context doing the least relay work. */
             if (!context_) {
-                Closesocket(acceptor);
                 return false;
             }
 
             boost::asio::ip::tcp::acceptor* const acceptor_ = addressof(acceptor);
             const Hosting                         hosting_ = hosting;
-            const AcceptLoopbackCallback          accept_ = BOOST_ASIO_MOVE_CAST(AcceptLoopbackCallback)(constantof(callback));
+            const AcceptLoopbackCallback          accept_ = callback;
             const AsioTcpSocket                   socket_ = make_shared_object<boost::asio::ip::tcp::socket>(*context_);
 
             acceptor_->async_accept(*socket_,
@@ -451,6 +664,7 @@ namespace uds {
                     }
 
                     bool success = false;
+                    AsioTcpSocket accepted_ = socket_;
                     do { /* boost::system::errc::connection_aborted */
                         if (ec) { /* ECONNABORTED */
                             break;
@@ -462,15 +676,20 @@ namespace uds {
                         Socket::SetSignalPipeline(handle_, false);
                         Socket::SetDontFragment(handle_, false);
                         Socket::ReuseSocketAddress(handle_, true);
+                        Socket::AdjustSocketBuffers(handle_); /* The accept handshake already measured an RTT to size against. */
 
                         /* Accept Socket?? */
-                        success = accept_(context_, socket_);
+                        AsioContext accepted_context_ = context_;
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+                        Socket_AlignIncomingCpu(hosting_, accepted_context_, accepted_);
+#endif
+                        success = accept_(accepted_context_, accepted_);
                     } while (0);
                     if (!success) {
-                        Closesocket(socket_);
+                        Closesocket(accepted_); /* When the flow was re-homed the original socket released its descriptor. */
                     }
 
-                    success = AcceptLoopbackAsync(hosting_, *acceptor_, forward0f(accept_));
+                    success = AcceptLoopbackOnce(hosting_, *acceptor_, accept_); /* Re-arm this pipeline stage only. */
                     if (!success) {
                         Closesocket(*acceptor_);
                     }
@@ -484,7 +703,8 @@ namespace uds {
             int                                                     listenPort,
             int                                                     backlog,
             bool                                                    fastOpen,
-            bool                                                    noDelay) noexcept {
+            bool                                                    noDelay,
+            bool                                                    reusePort) noexcept {
             typedef uds::net::IPEndPoint IPEndPoint;
 
             if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
@@ -519,6 +739,9 @@ namespace uds {
             uds::net::Socket::SetSignalPipeline(handle, false);
             uds::net::Socket::SetDontFragment(handle, false);
             uds::net::Socket::ReuseSocketAddress(handle, listenPort);
+            if (reusePort) { /* Allow the kernel to spread connections across several acceptors bound to the same port. */
+                uds::net::Socket::ReuseSocketPort(handle, true);
+            }
 
             acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(listenPort), ec);
             if (ec) {
@@ -618,6 +841,8 @@ namespace uds {
             boost::system::error_code ec;
             s.set_option(boost::asio::ip::tcp::no_delay(noDealy), ec);
             s.set_option(boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_FASTOPEN>(fastOpen), ec);
+
+            AdjustSocketBuffers(handle);
         }
 
         void Socket::AdjustSocketOptional(const boost::asio::ip::udp::socket& socket) noexcept {
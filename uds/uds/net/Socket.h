@@ -36,13 +36,21 @@ namespace uds {
                 const Hosting&                                                          hosting,
                 const boost::asio::ip::tcp::acceptor&                                   acceptor,
                 const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)                       callback) noexcept;
+            /* Re-home an idle accepted socket onto another hosting context: the
+             * descriptor is released and re-assigned, so the caller must drop every
+             * reference to the old socket in favour of the one written back here. */
+            static bool                                                                 RehomeSocket(
+                std::shared_ptr<boost::asio::io_context>&                               context,
+                std::shared_ptr<boost::asio::ip::tcp::socket>&                          socket,
+                const std::shared_ptr<boost::asio::io_context>&                         preferred) noexcept;
             static bool                                                                 OpenAcceptor(
                 const boost::asio::ip::tcp::acceptor&                                   acceptor,
                 const boost::asio::ip::address&                                         listenIP,
                 int                                                                     listenPort,
                 int                                                                     backlog,
                 bool                                                                    fastOpen,
-                bool                                                                    noDelay) noexcept;
+                bool                                                                    noDelay,
+                bool                                                                    reusePort = false) noexcept;
             static bool                                                                 OpenSocket(
                 const boost::asio::ip::udp::socket&                                     socket,
                 const boost::asio::ip::address&                                         listenIP,
@@ -87,7 +95,35 @@ namespace uds {
             static bool                                                                 SetTypeOfService(int fd, int tos = ~0) noexcept;
             static bool                                                                 SetSignalPipeline(int fd, bool sigpipe) noexcept;
             static bool                                                                 SetDontFragment(int fd, bool dontFragment) noexcept;
+            static bool                                                                 SetFastOpenConnect(int fd, bool fastOpen) noexcept;
             static bool                                                                 ReuseSocketAddress(int fd, bool reuse) noexcept;
+            static bool                                                                 ReuseSocketPort(int fd, bool reuse) noexcept;
+
+        public:
+            /* Process-wide socket buffer tuning, copied from the configuration at
+             * startup: explicit SO_SNDBUF/SO_RCVBUF sizes, an assumed path rate in
+             * mbps that turns each connection's measured RTT into a bandwidth-delay
+             * product, and a TCP_NOTSENT_LOWAT bound that keeps unsent bytes in the
+             * userspace queues where prioritization can still reorder them. */
+            struct BufferTuning {
+                int                                                                     sndbuf = 0;
+                int                                                                     rcvbuf = 0;
+                int                                                                     bandwidth = 0;
+                int                                                                     notsent_lowat = 0;
+            };
+            static BufferTuning                                                         Buffers;
+
+            /* Number of async_accept operations kept outstanding per acceptor, each
+             * with its own pre-created socket, so a connection burst drains at kernel
+             * backlog speed instead of being serialized behind per-accept setup. */
+            static int                                                                  ConcurrentAccepts;
+
+            static bool                                                                 SetSendBufferSize(int fd, int size) noexcept;
+            static bool                                                                 SetReceiveBufferSize(int fd, int size) noexcept;
+            static bool                                                                 SetNotsentLowat(int fd, int bytes) noexcept;
+            static int                                                                  GetRoundTripTime(int fd) noexcept;
+            static int                                                                  GetPathMtu(int fd) noexcept;
+            static void                                                                 AdjustSocketBuffers(int fd) noexcept;
 
         public:
             static int                                                                  GetHandle(const boost::asio::ip::tcp::acceptor& acceptor) noexcept;
@@ -98,6 +134,12 @@ namespace uds {
             static void                                                                 Closesocket(const boost::asio::ip::tcp::acceptor& acceptor) noexcept;
             static void                                                                 Closesocket(const boost::asio::ip::tcp::socket& socket) noexcept;
             static void                                                                 Closesocket(const boost::asio::ip::udp::socket& socket) noexcept;
+
+        private:
+            static bool                                                                 AcceptLoopbackOnce(
+                const Hosting&                                                          hosting,
+                const boost::asio::ip::tcp::acceptor&                                   acceptor,
+                const AcceptLoopbackCallback&                                           callback) noexcept;
         };
     }
 }
\ No newline at end of file
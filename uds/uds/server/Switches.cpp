@@ -1,3 +1,4 @@
+#include <uds/Tracepoints.h>
 #include <uds/server/Switches.h>
 #include <uds/collections/Dictionary.h>
 #include <uds/net/Ipep.h>
@@ -5,13 +6,17 @@
 #include <uds/net/IPEndPoint.h>
 #include <uds/threading/Timer.h>
 #include <uds/threading/Hosting.h>
+#include <uds/threading/Logger.h>
+#include <uds/ssl/SSL.h>
 #include <uds/transmission/Transmission.h>
 #include <uds/transmission/EncryptorTransmission.h>
+#include <uds/transmission/ChaCha20Poly1305Transmission.h>
 #include <uds/transmission/SslSocketTransmission.h>
 #include <uds/transmission/WebSocketTransmission.h>
 #include <uds/transmission/SslWebSocketTransmission.h>
 
 using uds::collections::Dictionary;
+using uds::threading::Logger;
 using uds::net::Socket;
 using uds::net::IPEndPoint;
 using uds::net::AddressFamily;
@@ -20,16 +25,32 @@ namespace uds {
     namespace server {
         Switches::Switches(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept
             : disposed_(false)
-            , channel_(RandomNext(1, INT_MAX))
             , hosting_(hosting)
-            , configuration_(configuration) {
+            , configuration_(configuration)
+            , accepts_(0)
+            , handshake_failures_(0) {
             if (hosting) {
                 context_ = hosting->GetContext();
+                timewheel_ = hosting->GetTimingWheel();
+            }
+
+            if (configuration) {
+                Connection::FastHandshake = configuration->FastHandshake;
+                uds::net::Socket::ConcurrentAccepts = configuration->Accepts;
+                uds::net::Socket::Buffers.sndbuf = configuration->Buffers.Sndbuf;
+                uds::net::Socket::Buffers.rcvbuf = configuration->Buffers.Rcvbuf;
+                uds::net::Socket::Buffers.bandwidth = configuration->Buffers.Bandwidth;
+                uds::net::Socket::Buffers.notsent_lowat = configuration->Buffers.NotsentLowat;
+                uds::transmission::Transmission::Compression.enabled = configuration->Compression.Enabled;
+                uds::transmission::Transmission::Compression.threshold = configuration->Compression.Threshold;
+                uds::transmission::Transmission::Framing.version = configuration->Framing.Version;
+                uds::transmission::Transmission::Adaptive.enabled = configuration->Adaptive.Enabled;
+                uds::ssl::SSL::KernelTls = configuration->Protocols.Ssl.KernelTls;
             }
         }
 
         bool Switches::Listen() noexcept {
-            if (disposed_ || !hosting_ || !context_ || !configuration_) {
+            if (disposed_ || !hosting_ || !context_ || !timewheel_ || !configuration_) {
                 return false;
             }
 
@@ -40,38 +61,186 @@ namespace uds {
             }
 
             std::shared_ptr<Reference> references = GetReference();
-            acceptor_[0] = OpenAcceptor(inboundEP,
+            if (configuration_->Protocol == AppConfiguration::ProtocolType_UDP) {
+                /* Datagram mode: one demultiplexing listener per side replaces the
+                 * acceptors, and every tunnel link runs the ARQ over its segments. */
+                datagrams_[0] = OpenDatagramListener(inboundEP, 0);
+                datagrams_[1] = OpenDatagramListener(outboundEP, 1);
+                if (datagrams_[0] && datagrams_[1]) {
+                    if (OpenAcceptorPorts() && SweepChannelsCycle() && OpenMetrics()) {
+                        return true;
+                    }
+                }
+
+                CloseAcceptor();
+                return false;
+            }
+
+            bool sharded = hosting_->GetConcurrency() > 1;
+            acceptor_[0] = OpenAcceptor(inboundEP, context_, sharded,
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
                     return InboundAcceptClient(context, socket);
                 });
-            acceptor_[1] = OpenAcceptor(outboundEP,
+            acceptor_[1] = OpenAcceptor(outboundEP, context_, sharded,
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
                     return OutboundAcceptClient(context, socket);
                 });
             if (acceptor_[0] && acceptor_[1]) {
-                return true;
+                if (!sharded || OpenAcceptorShards(inboundEP, outboundEP)) {
+                    if (OpenAcceptorPorts() && SweepChannelsCycle() && OpenMetrics()) {
+                        return true;
+                    }
+                }
             }
 
             CloseAcceptor();
             return false;
         }
 
+        bool Switches::Reload(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept {
+            if (disposed_ || AppConfiguration::IsInvalid(configuration)) {
+                return false;
+            }
+
+            {
+                MutexScope scope(syncobj_);
+                if (!AppConfiguration::IsHotSwappable(*configuration_, *configuration)) {
+                    return false;
+                }
+
+                /* Channels paired from here on see the new snapshot; established ones
+                 * keep the one they were built with until they close. The outgoing
+                 * snapshot is pinned because accepts already in flight still read it. */
+                reloads_.push_back(configuration_);
+                configuration_ = configuration;
+            }
+
+            /* Process-wide knobs the next sockets and frames pick up directly. */
+            Connection::FastHandshake = configuration->FastHandshake;
+            uds::net::Socket::Buffers.sndbuf = configuration->Buffers.Sndbuf;
+            uds::net::Socket::Buffers.rcvbuf = configuration->Buffers.Rcvbuf;
+            uds::net::Socket::Buffers.bandwidth = configuration->Buffers.Bandwidth;
+            uds::net::Socket::Buffers.notsent_lowat = configuration->Buffers.NotsentLowat;
+            uds::transmission::Transmission::Compression.enabled = configuration->Compression.Enabled;
+            uds::transmission::Transmission::Compression.threshold = configuration->Compression.Threshold;
+            uds::ssl::SSL::KernelTls = configuration->Protocols.Ssl.KernelTls;
+            return true;
+        }
+
+        std::shared_ptr<uds::configuration::AppConfiguration> Switches::GetSnapshot() noexcept {
+            MutexScope scope(syncobj_);
+            return configuration_;
+        }
+
+        bool Switches::OpenAcceptorShards(const uds::net::IPEndPoint& inboundEP, const uds::net::IPEndPoint& outboundEP) noexcept {
+            std::shared_ptr<Reference> references = GetReference();
+            for (int i = 1, max = hosting_->GetConcurrency(); i < max; i++) {
+                const AsioContext context = hosting_->NextContext();
+                std::shared_ptr<boost::asio::ip::tcp::acceptor> inbound = OpenAcceptor(inboundEP, context, true,
+                    [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                        return InboundAcceptClient(context, socket);
+                    });
+                if (!inbound) {
+                    return false;
+                }
+                shards_.push_back(std::move(inbound));
+
+                std::shared_ptr<boost::asio::ip::tcp::acceptor> outbound = OpenAcceptor(outboundEP, context, true,
+                    [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                        return OutboundAcceptClient(context, socket);
+                    });
+                if (!outbound) {
+                    return false;
+                }
+                shards_.push_back(std::move(outbound));
+            }
+            return true;
+        }
+
+        bool Switches::OpenAcceptorPorts() noexcept {
+            /* Every inbound port past the first gets its own listen point on the same
+             * address, feeding the same accept path, buffer pool and timing wheel -
+             * one process covers a whole port range. */
+            const std::vector<int>& ports = configuration_->Inbound.Ports;
+            std::shared_ptr<Reference> references = GetReference();
+            for (std::size_t i = 1, len = ports.size(); i < len; i++) {
+                IPEndPoint bindEP(configuration_->Inbound.IP.data(), ports[i]);
+                if (configuration_->Protocol == AppConfiguration::ProtocolType_UDP) {
+                    std::shared_ptr<uds::transmission::UdpListener> listener = OpenDatagramListener(bindEP, 0);
+                    if (!listener) {
+                        return false;
+                    }
+
+                    datagram_shards_.push_back(std::move(listener));
+                    continue;
+                }
+
+                bool sharded = hosting_->GetConcurrency() > 1;
+                for (int j = 0, max = sharded ? hosting_->GetConcurrency() : 1; j < max; j++) {
+                    const AsioContext context = j > 0 ? hosting_->NextContext() : context_;
+                    std::shared_ptr<boost::asio::ip::tcp::acceptor> inbound = OpenAcceptor(bindEP, context, sharded,
+                        [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                            return InboundAcceptClient(context, socket);
+                        });
+                    if (!inbound) {
+                        return false;
+                    }
+                    shards_.push_back(std::move(inbound));
+                }
+            }
+            return true;
+        }
+
         void Switches::Dispose() noexcept {
             if (!disposed_.exchange(true)) {
                 /* Close the TCP socket acceptor function to prevent the system from continuously processing connections. */
                 CloseAcceptor();
 
-                /* Clear all timeouts. */
-                Dictionary::ReleaseAllPairs(timeouts_,
-                    [](TimeoutPtr& timeout) noexcept {
-                        uds::threading::Hosting::Cancel(timeout);
-                    });
+                std::shared_ptr<uds::net::MetricsServer> metrics = std::move(metrics_);
+                if (metrics) {
+                    metrics->Dispose();
+                }
+
+                MuxTable muxs;
+                std::vector<std::pair<ITransmissionPtr, AsioTcpSocket> > links; {
+                    MutexScope scope(syncobj_);
+
+                    /* Clear all timeouts. */
+                    Dictionary::ReleaseAllPairs(timeouts_,
+                        [](TimeoutPtr& timeout) noexcept {
+                            TimingWheel::ClearTimeout(timeout);
+                        });
+
+                    /* Detach all half-open connection-channels. */
+                    channels_.Sweep(UINT64_MAX, links);
 
-                /* Close all connection-channels. */
-                Dictionary::ReleaseAllPairs(channels_);
+                    /* Close all connection. */
+                    Dictionary::ReleaseAllPairs(connections_);
+                    resumes_.clear();
 
-                /* Close all connection. */
-                Dictionary::ReleaseAllPairs(connections_);
+                    /* Close all incomplete bond groups. */
+                    Dictionary::ReleaseAllPairs(bonds_);
+
+                    /* Detach all multiplexers: their disposal re-enters the lock to unregister. */
+                    muxs = std::move(muxs_);
+                    muxs_.clear();
+                }
+
+                /* Close all multiplexers. */
+                Dictionary::ReleaseAllPairs(muxs);
+
+                /* Close all half-open connection-channels. */
+                for (std::size_t i = 0, len = links.size(); i < len; i++) {
+                    ITransmissionPtr& inbound = links[i].first;
+                    if (inbound) {
+                        inbound->Close();
+                    }
+
+                    AsioTcpSocket& network = links[i].second;
+                    if (network) {
+                        Socket::Closesocket(network);
+                    }
+                }
             }
         }
 
@@ -83,42 +252,72 @@ namespace uds {
                 }
                 acceptor.reset();
             }
+
+            for (int i = 0, len = arraysizeof(datagrams_); i < len; i++) {
+                std::shared_ptr<uds::transmission::UdpListener>& listener = datagrams_[i];
+                if (listener) {
+                    listener->Dispose();
+                }
+                listener.reset();
+            }
+
+            for (std::size_t i = 0, len = datagram_shards_.size(); i < len; i++) {
+                std::shared_ptr<uds::transmission::UdpListener>& listener = datagram_shards_[i];
+                if (listener) {
+                    listener->Dispose();
+                }
+            }
+            datagram_shards_.clear();
+
+            for (std::size_t i = 0, len = shards_.size(); i < len; i++) {
+                std::shared_ptr<boost::asio::ip::tcp::acceptor>& acceptor = shards_[i];
+                if (acceptor) {
+                    Socket::Closesocket(*acceptor);
+                }
+            }
+            shards_.clear();
         }
 
         bool Switches::InboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            accepts_.fetch_add(1, std::memory_order_relaxed);
+            UDS_TRACE2(accept, 0, Socket::GetHandle(*socket));
+            Logger::Write(Logger::LogEvent_Accept, 0, Socket::GetHandle(*socket));
+
+            const ITransmissionPtr transmission = CreateTransmission(context, socket);
+            if (!transmission) {
+                return false;
+            }
+
+            return InboundAcceptTransmission(transmission, socket, Socket::GetHandle(*socket));
+        }
+
+        bool Switches::InboundAcceptTransmission(const ITransmissionPtr& transmission, const AsioTcpSocket& socket, int handle) noexcept {
             const std::shared_ptr<Reference> references = GetReference();
             const AsioTcpSocket network = socket;
-            return HandshakeTransmission(context, socket,
-                [references, this, network](const ITransmissionPtr& transmission, bool handshaked) noexcept {
+            return HandshakeTransmission(transmission,
+                [references, this, network, handle](const ITransmissionPtr& transmission, bool handshaked) noexcept {
                     const ITransmissionPtr inbound = transmission;
+                    UDS_TRACE3(handshake, 0, handle, handshaked);
+                    if (handshaked) {
+                        Logger::Write(Logger::LogEvent_HandshakeSuccess, 0, handle);
+                    }
+                    else {
+                        handshake_failures_.fetch_add(1, std::memory_order_relaxed);
+                        Logger::Write(Logger::LogEvent_HandshakeFailure, 0, handle);
+                    }
+
                     if (handshaked) {
                         handshaked = Connection::AcceptAsync(inbound, configuration_->Alignment,
                             [references, this, network](const ITransmissionPtr& inbound) noexcept -> int {
-                                ConnectionChannelPtr channel = AllocChannel(network, inbound);
-                                if (!channel) {
-                                    return 0;
-                                }
-
-                                int channelId = channel->channel_;
-                                if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
-                                    [references, this, channel, channelId, network](void* key) noexcept -> void {
-                                        ClearTimeout(key);
-                                        CloseChannel(channelId);
-                                    }, (UInt64)configuration_->Connect.Timeout * 1000))) {
-                                    channel->Close();
-                                    return 0;
-                                }
-                                return channelId;
+                                /* The slot carries its own deadline: the periodic sweep reclaims
+                                 * the pairing if no outbound client ever names this channel. */
+                                return AllocChannel(network, inbound);
                             },
                             [references, this, inbound, network](bool success, int channelId) noexcept -> void {
-                                if (!success) { 
-                                    ClearTimeout(network.get());
+                                if (!success) {
                                     CloseChannel(channelId);
                                 }
                             });
-                        if (!handshaked) {
-                            ClearTimeout(network.get());
-                        }
                     }
 
                     if (!handshaked) {
@@ -130,22 +329,51 @@ namespace uds {
         }
 
         bool Switches::OutboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            accepts_.fetch_add(1, std::memory_order_relaxed);
+            UDS_TRACE2(accept, 1, Socket::GetHandle(*socket));
+            Logger::Write(Logger::LogEvent_Accept, 1, Socket::GetHandle(*socket));
+
+            const ITransmissionPtr transmission = CreateTransmission(context, socket);
+            if (!transmission) {
+                return false;
+            }
+
+            return OutboundAcceptTransmission(transmission, Socket::GetHandle(*socket));
+        }
+
+        bool Switches::OutboundAcceptTransmission(const ITransmissionPtr& transmission, int handle) noexcept {
             const std::shared_ptr<Reference> references = GetReference();
-            return HandshakeTransmission(context, socket,
+            return HandshakeTransmission(transmission,
                 [references, this](const ITransmissionPtr& transmission, bool handshaked) noexcept {
                     const ITransmissionPtr outbound = transmission;
+                    UDS_TRACE3(handshake, 1, 0, handshaked);
+                    if (handshaked) {
+                        Logger::Write(Logger::LogEvent_HandshakeSuccess, 1, 0);
+                    }
+                    else {
+                        handshake_failures_.fetch_add(1, std::memory_order_relaxed);
+                        Logger::Write(Logger::LogEvent_HandshakeFailure, 1, 0);
+                    }
+
                     if (handshaked) {
-                        handshaked = AddTimeout(outbound.get(), uds::threading::SetTimeout(hosting_,
+                        handshaked = AddTimeout(outbound.get(), timewheel_->SetTimeout(
                             [references, this, outbound](void* key) noexcept -> void {
                                 ClearTimeout(key);
                                 outbound->Close();
                             }, (UInt64)configuration_->Connect.Timeout * 1000));
                         handshaked = handshaked && Connection::HelloAsync(outbound);
-                        handshaked = handshaked && Connection::AcceptAsync(transmission,
-                            [references, this, outbound](bool success, int channelId) noexcept -> void {
+                        handshaked = handshaked && Connection::AcceptJoinAsync(transmission,
+                            [references, this, outbound](bool success, int channelId, UInt64 token, Int64 received) noexcept -> void {
                                 ClearTimeout(outbound.get());
                                 if (success) {
-                                    success = AcceptChannel(channelId, outbound);
+                                    /* A join naming a received count is a takeover: the new pair
+                                     * reattaches to the channel the token still points at. */
+                                    if (token != 0 && received >= 0) {
+                                        success = ResumeChannel(channelId, outbound, token, (UInt64)received);
+                                    }
+                                    else {
+                                        success = AcceptChannel(channelId, outbound, token);
+                                    }
                                 }
 
                                 if (!success) {
@@ -163,77 +391,248 @@ namespace uds {
                 });
         }
 
-        Switches::ConnectionChannelPtr Switches::PopChannel(int channel) noexcept {
-            if (!channel) {
-                return NULL;
+        Switches::ChannelSlotTable::ChannelSlotTable() noexcept
+            : frees_(-1)
+            , generation_(RandomNext(1, ECHANNEL_GENERATION_MAX))
+            , count_(0) {
+
+        }
+
+        int Switches::ChannelSlotTable::Alloc(const AsioTcpSocket& network, const ITransmissionPtr& inbound, UInt64 deadline, bool inversion) noexcept {
+            int index = frees_;
+            if (index > -1) {
+                frees_ = slots_[index].next_;
+            }
+            else {
+                index = (int)slots_.size();
+                if (index > ECHANNEL_INDEX_MASK) {
+                    return 0; /* Saturated: more half-open pairings than the id space can name. */
+                }
+                slots_.emplace_back();
             }
 
-            ConnectionChannelPtr connection;
-            if (!Dictionary::TryRemove(channels_, channel, connection)) {
-                return NULL;
+            if (++generation_ > ECHANNEL_GENERATION_MAX) {
+                generation_ = 1;
+            }
+
+            int channelId = generation_ << ECHANNEL_INDEX_BITS | index;
+            if (inversion) {
+                channelId |= (int)(1 << 31);
             }
-            return std::move(connection);
+
+            Slot& slot = slots_[index];
+            slot.channel_ = channelId;
+            slot.next_ = -1;
+            slot.deadline_ = deadline;
+            slot.inbound_ = inbound;
+            slot.network_ = network;
+            count_++;
+            return channelId;
         }
 
-        Switches::ConnectionChannelPtr Switches::AllocChannel(const AsioTcpSocket& network, const ITransmissionPtr& inbound) noexcept {
-            if (!inbound) {
-                return NULL;
+        bool Switches::ChannelSlotTable::Pop(int channel, ITransmissionPtr& inbound, AsioTcpSocket& network) noexcept {
+            int index = channel & ECHANNEL_INDEX_MASK;
+            if (index >= (int)slots_.size()) {
+                return false;
             }
 
-            for (;;) {
-                int channelId = ++channel_;
-                if (channelId < 1) {
-                    channel_ = 0;
-                    continue;
-                }
+            Slot& slot = slots_[index];
+            if (!channel || slot.channel_ != channel) { /* The generation catches stale or forged ids whose slot was reused. */
+                return false;
+            }
 
-                if (Dictionary::ContainsKey(channels_, channelId)) {
-                    continue;
-                }
+            inbound = std::move(slot.inbound_);
+            network = std::move(slot.network_);
+            slot.channel_ = 0;
+            slot.deadline_ = 0;
+            slot.next_ = frees_;
+            frees_ = index;
+            count_--;
+            return true;
+        }
 
-                ConnectionChannelPtr channel = make_shared_object<ConnectionChannel>();
-                if (!channel) {
+        int Switches::ChannelSlotTable::Sweep(UInt64 now, std::vector<std::pair<ITransmissionPtr, AsioTcpSocket> >& expires) noexcept {
+            int length = 0;
+            for (int index = 0, count = (int)slots_.size(); index < count; index++) {
+                Slot& slot = slots_[index];
+                if (!slot.channel_ || slot.deadline_ > now) {
                     continue;
                 }
 
-                if (configuration_->Inversion) {
-                    int inversion = RandomNext() & 1;
-                    if (inversion) {
-                        channelId |= (int)(1 << 31);
+                length++;
+                expires.push_back(std::make_pair(std::move(slot.inbound_), std::move(slot.network_)));
+                slot.channel_ = 0;
+                slot.deadline_ = 0;
+                slot.next_ = frees_;
+                frees_ = index;
+                count_--;
+            }
+            return length;
+        }
+
+        bool Switches::OpenMetrics() noexcept {
+            typedef uds::net::MetricsServer MetricsServer;
+
+            int port = configuration_->Metrics.Port;
+            if (port <= IPEndPoint::MinPort || port > IPEndPoint::MaxPort) {
+                return true; /* Unconfigured: nothing to listen on. */
+            }
+
+            boost::system::error_code ec;
+            boost::asio::ip::address interfaceIP = boost::asio::ip::address::from_string(configuration_->Metrics.IP, ec);
+            if (ec) {
+                return false;
+            }
+
+            std::shared_ptr<MetricsServer> metrics = NewReference<MetricsServer>(hosting_, interfaceIP, port);
+            if (!metrics) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            metrics->AddSource(
+                [references, this](std::string& body) noexcept {
+                    int channels = 0;
+                    int connections = 0;
+                    int muxs = 0; {
+                        MutexScope scope(syncobj_);
+                        channels = channels_.Count();
+                        connections = (int)connections_.size();
+                        muxs = (int)muxs_.size();
                     }
-                }
-                channel->channel_ = channelId;
-                channel->inbound_ = inbound;
-                channel->network_ = network;
-                channels_[channelId] = channel;
-                return std::move(channel);
+
+                    char line[512];
+                    snprintf(line, sizeof(line),
+                        "# TYPE uds_channels gauge\n"
+                        "uds_channels %d\n"
+                        "# TYPE uds_connections gauge\n"
+                        "uds_connections %d\n"
+                        "# TYPE uds_muxs gauge\n"
+                        "uds_muxs %d\n"
+                        "# TYPE uds_accepts_total counter\n"
+                        "uds_accepts_total %llu\n"
+                        "# TYPE uds_handshake_failures_total counter\n"
+                        "uds_handshake_failures_total %llu\n",
+                        channels, connections, muxs,
+                        (unsigned long long)accepts_.load(std::memory_order_relaxed),
+                        (unsigned long long)handshake_failures_.load(std::memory_order_relaxed));
+                    body.append(line);
+                });
+
+            if (!metrics->Listen()) {
+                metrics->Dispose();
+                return false;
             }
+
+            metrics_ = std::move(metrics);
+            return true;
+        }
+
+        int Switches::AllocChannel(const AsioTcpSocket& network, const ITransmissionPtr& inbound) noexcept {
+            if (!inbound) {
+                return 0;
+            }
+
+            bool inversion = configuration_->Inversion && (RandomNext() & 1);
+            UInt64 deadline = uds::threading::Hosting::CachedMillisec() + (UInt64)configuration_->Connect.Timeout * 1000;
+
+            MutexScope scope(syncobj_);
+            return channels_.Alloc(network, inbound, deadline, inversion);
         }
 
         bool Switches::CloseChannel(int channel) noexcept {
-            ConnectionChannelPtr connection = PopChannel(channel);
-            if (!connection) {
+            ITransmissionPtr inbound;
+            AsioTcpSocket network;
+            bool success = false; {
+                MutexScope scope(syncobj_);
+                success = channels_.Pop(channel, inbound, network);
+            }
+
+            if (!success) {
                 return false;
             }
 
-            connection->Close();
+            if (inbound) {
+                inbound->Close();
+            }
+
+            if (network) {
+                Socket::Closesocket(network);
+            }
             return true;
         }
 
-        bool Switches::Accept(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+        bool Switches::SweepChannelsCycle() noexcept {
+            static const int ESWEEP_CHANNELS_INTERVAL = 500;
+
+            const std::shared_ptr<Reference> references = GetReference();
+            return AddTimeout(this, timewheel_->SetTimeout(
+                [references, this](void* key) noexcept {
+                    ClearTimeout(key);
+                    if (disposed_) {
+                        return;
+                    }
+
+                    std::vector<std::pair<ITransmissionPtr, AsioTcpSocket> > expires; {
+                        MutexScope scope(syncobj_);
+                        channels_.Sweep(uds::threading::Hosting::CachedMillisec(), expires);
+                    }
+
+                    for (std::size_t i = 0, len = expires.size(); i < len; i++) {
+                        ITransmissionPtr& inbound = expires[i].first;
+                        if (inbound) {
+                            inbound->Close();
+                        }
+
+                        AsioTcpSocket& network = expires[i].second;
+                        if (network) {
+                            Socket::Closesocket(network);
+                        }
+                    }
+                    SweepChannelsCycle();
+                }, ESWEEP_CHANNELS_INTERVAL));
+        }
+
+        bool Switches::Accept(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, UInt64 token) noexcept {
             if (!inbound || !outbound || !channel) {
                 return false;
             }
 
+            if (configuration_->Mux) {
+                /* The paired transmissions become the shared pipe itself: every relayed
+                 * connection afterwards is a logical channel riding it. */
+                return AcceptMux(channel, inbound, outbound);
+            }
+            elif(configuration_->Bonding > 1) {
+                /* The pair is one member of a striped group: the joining frame it is
+                 * about to send names the group it belongs to. */
+                return AcceptBond(inbound, outbound);
+            }
+
             /* CHANNEL: S <-> C: RX(inbound) <-> TX(outbound). */
             ConnectionPtr connection = CreateConnection(channel, inbound, outbound);
             if (connection) {
+                if (token != 0 && configuration_->Resume) {
+                    connection->SetResumable(token);
+                }
+
                 std::shared_ptr<Reference> references = GetReference();
                 connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                    MutexScope scope(syncobj_);
                     Dictionary::TryRemove(connections_, connection->Id);
+
+                    UInt64 token = connection->GetResumeToken();
+                    if (token) {
+                        Dictionary::TryRemove(resumes_, token);
+                    }
                 };
                 if (connection->Listen(NULL)) {
+                    MutexScope scope(syncobj_);
                     if (Dictionary::TryAdd(connections_, channel, connection)) {
+                        UInt64 rtoken = connection->GetResumeToken();
+                        if (rtoken) {
+                            Dictionary::TryAdd(resumes_, rtoken, connection);
+                        }
                         return true;
                     }
                 }
@@ -242,28 +641,213 @@ namespace uds {
             return false;
         }
 
-        bool Switches::AcceptChannel(int channel, const ITransmissionPtr& outbound) noexcept {
-            if (!channel || !outbound) {
+        bool Switches::AcceptMux(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+            /* CHANNEL: S <-> C: RX(inbound) <-> TX(outbound). */
+            MuxPtr mux = NewReference<Mux>(GetSnapshot(), inbound, outbound);
+            if (!mux) {
                 return false;
             }
 
-            ConnectionChannelPtr link = PopChannel(channel);
-            if (!link) {
+            const std::shared_ptr<Reference> references = GetReference();
+            mux->DisposedEvent = [references, this](Mux* mux) noexcept {
+                MutexScope scope(syncobj_);
+                Dictionary::TryRemove(muxs_, (void*)mux);
+            };
+            mux->AcceptEvent = [references, this](Mux* mux, int channel) noexcept {
+                ITransmissionPtr transmission = mux->AcceptChannel(channel);
+                if (transmission) {
+                    /* The relay reads and writes the same logical channel, and the
+                     * connection is kept alive by its own pending operations rather
+                     * than the connections table: channel ids are only unique within
+                     * one multiplexer. */
+                    ConnectionPtr connection = NewReference<Connection>(mux->GetConfiguration(), channel, transmission, transmission);
+                    if (connection && connection->Listen(NULL)) {
+                        return;
+                    }
+                    transmission->Close();
+                }
+            };
+
+            if (mux->Run()) {
+                MutexScope scope(syncobj_);
+                if (Dictionary::TryAdd(muxs_, (void*)mux.get(), mux)) {
+                    return true;
+                }
+            }
+
+            mux->Close();
+            return false;
+        }
+
+        bool Switches::AcceptBond(const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const ITransmissionPtr sreader = reader;
+            const ITransmissionPtr swriter = writer;
+
+            return Connection::AcceptAsync(sreader,
+                [references, this, sreader, swriter](bool success, int gid) noexcept {
+                    if (success) {
+                        success = JoinBond(gid, sreader, swriter);
+                    }
+
+                    if (!success) {
+                        sreader->Close();
+                        swriter->Close();
+                    }
+                });
+        }
+
+        bool Switches::JoinBond(int gid, const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept {
+            if (!gid || !reader || !writer) {
+                return false;
+            }
+
+            const int bonding = configuration_->Bonding;
+            BondChannelPtr bond;
+            bool opened = false;
+            bool completed = false; {
+                MutexScope scope(syncobj_);
+                if (!Dictionary::TryGetValue(bonds_, gid, bond)) {
+                    bond = make_shared_object<BondChannel>();
+                    if (!bond) {
+                        return false;
+                    }
+
+                    bond->gid_ = gid;
+                    bonds_[gid] = bond;
+                    opened = true;
+                }
+
+                bond->readers_.push_back(reader);
+                bond->writers_.push_back(writer);
+                if ((int)bond->readers_.size() >= bonding) {
+                    Dictionary::TryRemove(bonds_, gid);
+                    completed = true;
+                }
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            if (!completed) {
+                if (opened) { /* A group the client never finishes must not pin its members forever. */
+                    return AddTimeout(bond.get(), timewheel_->SetTimeout(
+                        [references, this, bond, gid](void* key) noexcept {
+                            ClearTimeout(key); {
+                                MutexScope scope(syncobj_);
+                                Dictionary::TryRemove(bonds_, gid);
+                            }
+                            bond->Close();
+                        }, (UInt64)configuration_->Connect.Timeout * 1000));
+                }
+                return true;
+            }
+
+            ClearTimeout(bond.get());
+
+            /* CHANNEL: S <-> C: RX(bonded readers) <-> TX(bonded writers). */
+            ITransmissionPtr rx = NewReference2<ITransmission, Bond>(bond->readers_, configuration_->Alignment);
+            ITransmissionPtr tx = NewReference2<ITransmission, Bond>(bond->writers_, configuration_->Alignment);
+            if (rx && tx) {
+                rx = rx->Constructor(rx);
+                tx = tx->Constructor(tx);
+
+                ConnectionPtr connection = NewReference<Connection>(GetSnapshot(), gid, rx, tx);
+                if (connection) {
+                    connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                        MutexScope scope(syncobj_);
+                        Dictionary::TryRemove(connections_, connection->Id);
+                    };
+                    if (connection->Listen(NULL)) {
+                        MutexScope scope(syncobj_);
+                        if (Dictionary::TryAdd(connections_, gid, connection)) {
+                            return true;
+                        }
+                    }
+                    connection->Close();
+                }
+            }
+
+            bond->Close();
+            return false;
+        }
+
+        bool Switches::AcceptChannel(int channel, const ITransmissionPtr& outbound, UInt64 token) noexcept {
+            if (!channel || !outbound) {
                 return false;
             }
 
-            bool success = ClearTimeout(link->network_.get());
+            ITransmissionPtr inbound;
+            AsioTcpSocket network;
+            bool success = false; {
+                MutexScope scope(syncobj_);
+                success = channels_.Pop(channel, inbound, network);
+            }
+
+            /* A successful pop is the race guard: an expired pairing was already
+             * reclaimed by the sweep, so its channel id can no longer be completed. */
             if (success) {
                 if (channel >> 31) {
-                    success = Accept(channel, outbound, link->inbound_);
+                    success = Accept(channel, outbound, inbound, token);
                 }
                 else {
-                    success = Accept(channel, link->inbound_, outbound);
+                    success = Accept(channel, inbound, outbound, token);
                 }
             }
 
             if (!success) {
-                link->Close();
+                if (inbound) {
+                    inbound->Close();
+                }
+
+                if (network) {
+                    Socket::Closesocket(network);
+                }
+            }
+            return success;
+        }
+
+        bool Switches::ResumeChannel(int channel, const ITransmissionPtr& outbound, UInt64 token, UInt64 received) noexcept {
+            if (!channel || !outbound || !token) {
+                return false;
+            }
+
+            ITransmissionPtr inbound;
+            AsioTcpSocket network;
+            ConnectionPtr connection;
+            bool success = false; {
+                MutexScope scope(syncobj_);
+                success = channels_.Pop(channel, inbound, network);
+                if (success) {
+                    Dictionary::TryGetValue(resumes_, token, connection);
+                }
+            }
+
+            if (success) {
+                success = false;
+                if (connection && configuration_->Resume) {
+                    /* Mirror the pairing orientation, then let the reattach speak: it
+                     * acknowledges our received count ahead of the replayed backlog. */
+                    ITransmissionPtr reader = inbound;
+                    ITransmissionPtr writer = outbound;
+                    if (channel >> 31) {
+                        reader = outbound;
+                        writer = inbound;
+                    }
+
+                    success = connection->Reattach(reader, writer, received, true);
+                    if (!success) {
+                        connection->Close();
+                    }
+                }
+            }
+
+            if (!success) {
+                if (inbound) {
+                    inbound->Close();
+                }
+
+                if (network) {
+                    Socket::Closesocket(network);
+                }
             }
             return success;
         }
@@ -277,7 +861,7 @@ namespace uds {
             const std::shared_ptr<uds::transmission::ITransmission> network = transmission;
             const HandshakeAsyncCallback scallback = callback;
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), timewheel_->SetTimeout(
                 [reference, this, network, scallback](void* key) noexcept {
                     ClearTimeout(key);
                     network->Close();
@@ -299,19 +883,6 @@ namespace uds {
                 });
         }
 
-        bool Switches::HandshakeTransmission(const AsioContext& context, const AsioTcpSocket& socket, HandshakeAsyncCallback&& callback) noexcept {
-            if (!callback) {
-                return false;
-            }
-
-            const std::shared_ptr<uds::transmission::ITransmission> transmission = CreateTransmission(context, socket);
-            if (!transmission) {
-                return false;
-            }
-
-            return HandshakeTransmission(transmission, std::forward<HandshakeAsyncCallback>(callback));
-        }
-
         Switches::ITransmissionPtr Switches::CreateTransmission(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
             std::shared_ptr<uds::transmission::ITransmission> transmission;
             if (configuration_->Protocol == AppConfiguration::ProtocolType_SSL ||
@@ -329,12 +900,21 @@ namespace uds {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::EncryptorTransmission>(hosting_, context, socket,
                     configuration_->Protocols.Encryptor.Method,
                     configuration_->Protocols.Encryptor.Password,
-                    configuration_->Alignment);
+                    configuration_->Alignment,
+                    configuration_->Protocols.Encryptor.Offload);
+            }
+            elif(configuration_->Protocol == AppConfiguration::ProtocolType_ChaCha20Poly1305) {
+                transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::ChaCha20Poly1305Transmission>(hosting_, context, socket,
+                    configuration_->Protocols.Encryptor.Password,
+                    configuration_->Alignment,
+                    configuration_->Protocols.Encryptor.Offload);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::WebSocketTransmission>(hosting_, context, socket,
                     configuration_->Protocols.WebSocket.Host,
                     configuration_->Protocols.WebSocket.Path,
+                    configuration_->Protocols.WebSocket.Compression,
+                    configuration_->Protocols.WebSocket.CompressionThreshold,
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket_SSL ||
@@ -342,6 +922,8 @@ namespace uds {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::SslWebSocketTransmission>(hosting_, context, socket,
                     configuration_->Protocols.WebSocket.Host,
                     configuration_->Protocols.WebSocket.Path,
+                    configuration_->Protocols.WebSocket.Compression,
+                    configuration_->Protocols.WebSocket.CompressionThreshold,
                     configuration_->Protocols.Ssl.CertificateFile,
                     configuration_->Protocols.Ssl.CertificateKeyFile,
                     configuration_->Protocols.Ssl.CertificateChainFile,
@@ -360,10 +942,10 @@ namespace uds {
                 return NULL;
             }
 
-            return NewReference<Connection>(configuration_, channel, inbound, outbound);
+            return NewReference<Connection>(GetSnapshot(), channel, inbound, outbound);
         }
 
-        bool Switches::AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept {
+        bool Switches::AddTimeout(void* key, TimeoutPtr&& timeout) noexcept {
             if (!key || !timeout) {
                 return false;
             }
@@ -371,9 +953,12 @@ namespace uds {
                 ClearTimeout(key);
             }
 
-            bool success = Dictionary::TryAdd(timeouts_, key, timeout);
+            bool success = false; {
+                MutexScope scope(syncobj_);
+                success = Dictionary::TryAdd(timeouts_, key, timeout);
+            }
             if (!success) {
-                uds::threading::ClearTimeout(timeout);
+                TimingWheel::ClearTimeout(timeout);
             }
             return success;
         }
@@ -383,20 +968,22 @@ namespace uds {
                 return false;
             }
 
-            TimeoutPtr timeout;
-            Dictionary::TryRemove(timeouts_, key, timeout);
-            return uds::threading::ClearTimeout(timeout);
+            TimeoutPtr timeout; {
+                MutexScope scope(syncobj_);
+                Dictionary::TryRemove(timeouts_, key, timeout);
+            }
+            return TimingWheel::ClearTimeout(timeout);
         }
 
-        std::shared_ptr<boost::asio::ip::tcp::acceptor> Switches::OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
+        std::shared_ptr<boost::asio::ip::tcp::acceptor> Switches::OpenAcceptor(const uds::net::IPEndPoint& bindEP, const AsioContext& context, bool reusePort, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
             int listenPort = bindEP.Port;
             if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
                 listenPort = IPEndPoint::MinPort;
             }
-            
+
             boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(bindEP).address();
-            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = NewReference<boost::asio::ip::tcp::acceptor>(*context_);
-            if (!Socket::OpenAcceptor(*acceptor, address, listenPort, configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo)) {
+            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = NewReference<boost::asio::ip::tcp::acceptor>(*context);
+            if (!Socket::OpenAcceptor(*acceptor, address, listenPort, configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo, reusePort)) {
                 Socket::Closesocket(*acceptor);
                 return NULL;
             }
@@ -408,6 +995,27 @@ namespace uds {
             return std::move(acceptor);
         }
 
+        std::shared_ptr<uds::transmission::UdpListener> Switches::OpenDatagramListener(const uds::net::IPEndPoint& bindEP, int side) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            std::shared_ptr<uds::transmission::UdpListener> listener = NewReference<uds::transmission::UdpListener>(hosting_, context_, configuration_->Alignment);
+            bool success = listener->Listen(bindEP,
+                [references, this, side](const std::shared_ptr<uds::transmission::UdpTransmission>& transmission) noexcept {
+                    accepts_.fetch_add(1, std::memory_order_relaxed);
+                    UDS_TRACE2(accept, side, datagrams_[side] ? datagrams_[side]->GetHandle() : -1);
+                    Logger::Write(Logger::LogEvent_Accept, side, datagrams_[side] ? datagrams_[side]->GetHandle() : -1);
+
+                    if (side) {
+                        return OutboundAcceptTransmission(transmission, -1);
+                    }
+                    return InboundAcceptTransmission(transmission, AsioTcpSocket(), -1);
+                });
+            if (!success) {
+                listener->Dispose();
+                return NULL;
+            }
+            return listener;
+        }
+
         const std::shared_ptr<boost::asio::io_context>& Switches::GetContext() noexcept {
             return context_;
         }
@@ -429,18 +1037,23 @@ namespace uds {
             return boost::asio::ip::tcp::endpoint();
         }
 
-        void Switches::ConnectionChannel::Close() noexcept {
-            ITransmissionPtr inbound = std::move(inbound_);
-            if (inbound) {
-                inbound_.reset();
-                inbound->Close();
+        void Switches::BondChannel::Close() noexcept {
+            for (std::size_t i = 0, len = readers_.size(); i < len; i++) {
+                const ITransmissionPtr& reader = readers_[i];
+                if (reader) {
+                    reader->Close();
+                }
             }
+            readers_.clear();
 
-            AsioTcpSocket network = std::move(network_);
-            if (network) {
-                network_.reset();
-                Socket::Closesocket(network);
+            for (std::size_t i = 0, len = writers_.size(); i < len; i++) {
+                const ITransmissionPtr& writer = writers_[i];
+                if (writer) {
+                    writer->Close();
+                }
             }
+            writers_.clear();
         }
+
     }
 }
\ No newline at end of file
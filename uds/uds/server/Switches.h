@@ -5,8 +5,13 @@
 #include <uds/configuration/AppConfiguration.h>
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
+#include <uds/net/MetricsServer.h>
 #include <uds/tunnel/Connection.h>
+#include <uds/tunnel/Mux.h>
+#include <uds/tunnel/Bond.h>
 #include <uds/transmission/ITransmission.h>
+#include <uds/transmission/UdpListener.h>
+#include <uds/collections/FlatHashMap.h>
 
 namespace uds {
     namespace server {
@@ -18,24 +23,69 @@ namespace uds {
             using ITransmissionPtr                                              = std::shared_ptr<ITransmission>;
             using AppConfiguration                                              = uds::configuration::AppConfiguration;
             using HandshakeAsyncCallback                                        = std::function<void(const ITransmissionPtr&, bool)>;
-            using TimeoutPtr                                                    = std::shared_ptr<boost::asio::deadline_timer>;
-            using TimeoutTable                                                  = std::unordered_map<void*, TimeoutPtr>;
+            using TimingWheel                                                   = uds::threading::TimingWheel;
+            using TimeoutPtr                                                    = TimingWheel::TimeoutPtr;
+            using TimeoutTable                                                  = uds::collections::FlatHashMap<void*, TimeoutPtr>;
             using Connection                                                    = uds::tunnel::Connection;
             using ConnectionPtr                                                 = std::shared_ptr<Connection>;
-            using ConnectionTable                                               = std::unordered_map<int, ConnectionPtr>;
+            using ConnectionTable                                               = uds::collections::FlatHashMap<int, ConnectionPtr>;
+            using ResumeTable                                                   = uds::collections::FlatHashMap<UInt64, ConnectionPtr>;
+            using Mux                                                           = uds::tunnel::Mux;
+            using MuxPtr                                                        = std::shared_ptr<Mux>;
+            using MuxTable                                                      = uds::collections::FlatHashMap<void*, MuxPtr>;
+            using Bond                                                          = uds::tunnel::Bond;
+            using Mutex                                                         = std::mutex;
+            using MutexScope                                                    = std::lock_guard<Mutex>;
 
         private:
-            class ConnectionChannel final {
+            /* Half-open pairings in one contiguous slot array: the channel id embeds the
+             * slot index, so allocation pops an intrusive free-list, completion is one
+             * indexed load, and expiry is a deadline sweep off the timing wheel - no
+             * dictionary probes and no timer entry per pairing. */
+            class ChannelSlotTable final {
             public:
-                int                                                             channel_;
-                ITransmissionPtr                                                inbound_;
-                AsioTcpSocket                                                   network_;
+                static const int                                                ECHANNEL_INDEX_BITS = 17;
+                static const int                                                ECHANNEL_INDEX_MASK = (1 << ECHANNEL_INDEX_BITS) - 1;
+                static const int                                                ECHANNEL_GENERATION_MAX = (1 << (31 - ECHANNEL_INDEX_BITS)) - 1;
+
+            public:
+                ChannelSlotTable() noexcept;
+
+            public:
+                int                                                             Alloc(const AsioTcpSocket& network, const ITransmissionPtr& inbound, UInt64 deadline, bool inversion) noexcept;
+                bool                                                            Pop(int channel, ITransmissionPtr& inbound, AsioTcpSocket& network) noexcept;
+                int                                                             Sweep(UInt64 now, std::vector<std::pair<ITransmissionPtr, AsioTcpSocket> >& expires) noexcept;
+                inline int                                                      Count() noexcept {
+                    return count_;
+                }
+
+            private:
+                struct Slot {
+                    int                                                         channel_  = 0; /* Zero marks a free slot. */
+                    int                                                         next_     = -1;
+                    UInt64                                                      deadline_ = 0;
+                    ITransmissionPtr                                            inbound_;
+                    AsioTcpSocket                                               network_;
+                };
+
+            private:
+                int                                                             frees_;
+                int                                                             generation_;
+                int                                                             count_;
+                std::vector<Slot>                                               slots_;
+            };
+
+            class BondChannel final {
+            public:
+                int                                                             gid_;
+                std::vector<ITransmissionPtr>                                   readers_;
+                std::vector<ITransmissionPtr>                                   writers_;
 
             public:
                 void                                                            Close() noexcept;
             };
-            using ConnectionChannelPtr                                          = std::shared_ptr<ConnectionChannel>;
-            using ConnectionChannelTable                                        = std::unordered_map<int, ConnectionChannelPtr>;
+            using BondChannelPtr                                                = std::shared_ptr<BondChannel>;
+            using BondChannelTable                                              = uds::collections::FlatHashMap<int, BondChannelPtr>;
 
         public:
             Switches(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
@@ -48,45 +98,67 @@ namespace uds {
 
         public:
             virtual bool                                                        Listen() noexcept;
+            virtual bool                                                        Reload(const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
             virtual void                                                        Dispose() noexcept override;
 
         private:
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
+            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     OpenAcceptor(const uds::net::IPEndPoint& bindEP, const AsioContext& context, bool reusePort, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
+            bool                                                                OpenAcceptorShards(const uds::net::IPEndPoint& inboundEP, const uds::net::IPEndPoint& outboundEP) noexcept;
+            bool                                                                OpenAcceptorPorts() noexcept;
             void                                                                CloseAcceptor() noexcept;
 
         private:
             bool                                                                InboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
             bool                                                                OutboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
-            
+            bool                                                                InboundAcceptTransmission(const ITransmissionPtr& transmission, const AsioTcpSocket& socket, int handle) noexcept;
+            bool                                                                OutboundAcceptTransmission(const ITransmissionPtr& transmission, int handle) noexcept;
+            std::shared_ptr<uds::transmission::UdpListener>                     OpenDatagramListener(const uds::net::IPEndPoint& bindEP, int side) noexcept;
+
         private:
             bool                                                                HandshakeTransmission(const ITransmissionPtr& transmission, HandshakeAsyncCallback&& callback) noexcept;
-            bool                                                                HandshakeTransmission(const AsioContext& context, const AsioTcpSocket& socket, HandshakeAsyncCallback&& callback) noexcept;
 
         private:
             bool                                                                ClearTimeout(void* key) noexcept;
-            bool                                                                AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept;
+            bool                                                                AddTimeout(void* key, TimeoutPtr&& timeout) noexcept;
             
         private:
-            ConnectionChannelPtr                                                PopChannel(int channel) noexcept;
-            ConnectionChannelPtr                                                AllocChannel(const AsioTcpSocket& network, const ITransmissionPtr& inbound) noexcept;
+            bool                                                                AcceptMux(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+            bool                                                                AcceptBond(const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept;
+            bool                                                                JoinBond(int gid, const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept;
+            int                                                                 AllocChannel(const AsioTcpSocket& network, const ITransmissionPtr& inbound) noexcept;
             bool                                                                CloseChannel(int channel) noexcept;
-            bool                                                                AcceptChannel(int channel, const ITransmissionPtr& outbound) noexcept;
+            bool                                                                AcceptChannel(int channel, const ITransmissionPtr& outbound, UInt64 token) noexcept;
+            bool                                                                ResumeChannel(int channel, const ITransmissionPtr& outbound, UInt64 token, UInt64 received) noexcept;
+            bool                                                                SweepChannelsCycle() noexcept;
+            bool                                                                OpenMetrics() noexcept;
+            std::shared_ptr<uds::configuration::AppConfiguration>               GetSnapshot() noexcept;
 
         protected:
             virtual ITransmissionPtr                                            CreateTransmission(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
             virtual ConnectionPtr                                               CreateConnection(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
-            virtual bool                                                        Accept(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+            virtual bool                                                        Accept(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, UInt64 token) noexcept;
 
         private:
             std::atomic<bool>                                                   disposed_;
-            std::atomic<int>                                                    channel_;
             std::shared_ptr<uds::threading::Hosting>                            hosting_;
+            std::shared_ptr<uds::threading::TimingWheel>                        timewheel_;
             std::shared_ptr<uds::configuration::AppConfiguration>               configuration_;
+            std::vector<std::shared_ptr<uds::configuration::AppConfiguration>>  reloads_; /* Superseded snapshots, pinned so unlocked field reads stay valid. */
             std::shared_ptr<boost::asio::io_context>                            context_;
             std::shared_ptr<boost::asio::ip::tcp::acceptor>                     acceptor_[2];
+            std::shared_ptr<uds::transmission::UdpListener>                     datagrams_[2];
+            std::vector<std::shared_ptr<uds::transmission::UdpListener> >      datagram_shards_;
+            std::vector<std::shared_ptr<boost::asio::ip::tcp::acceptor> >      shards_;
+            std::shared_ptr<uds::net::MetricsServer>                            metrics_;
+            std::atomic<uint64_t>                                               accepts_;            /* Sockets accepted on either side. */
+            std::atomic<uint64_t>                                               handshake_failures_; /* Transmissions that never completed the protocol handshake. */
+            Mutex                                                               syncobj_;
             TimeoutTable                                                        timeouts_;
-            ConnectionChannelTable                                              channels_;
+            ChannelSlotTable                                                    channels_;
             ConnectionTable                                                     connections_;
+            ResumeTable                                                         resumes_; /* Token to the live channel it can take over. */
+            MuxTable                                                            muxs_;
+            BondChannelTable                                                    bonds_;
         };
     }
 }
\ No newline at end of file
@@ -2,8 +2,237 @@
 #include <uds/ssl/SSL.h>
 #include <uds/io/File.h>
 
+#include <openssl/rand.h>
+#include <openssl/core_names.h>
+#include <openssl/pem.h>
+#include <openssl/err.h>
+
 namespace uds {
     namespace ssl {
+        typedef std::mutex                                          SSL_Mutex;
+        typedef std::lock_guard<SSL_Mutex>                          SSL_MutexScope;
+
+        /* One process-lifetime ticket key: every server context encrypts and accepts
+         * the same tickets, so resumption survives the per-connection SSL_CTX setup. */
+        typedef struct {
+            unsigned char                                           name_[16];
+            unsigned char                                           hmac_[32];
+            unsigned char                                           aes_[32];
+        } SSL_TICKET_KEY;
+
+        static SSL_Mutex                                            SSL_SessionSyncobj_;
+        static std::unordered_map<std::string, SSL_SESSION*>        SSL_SessionCache_;
+
+        bool SSL::KernelTls = false;
+
+        /* Contexts are immutable once built, so every transmission configured with
+         * the same material shares one SSL_CTX instead of re-parsing PEM files and
+         * the embedded root bundle on each connection. SSL_CTX is reference counted
+         * and safe to mint SSL handles from concurrently. */
+        static SSL_Mutex                                            SSL_ContextSyncobj_;
+        static std::unordered_map<std::string,
+            std::shared_ptr<boost::asio::ssl::context>>             SSL_ContextCache_;
+
+        static std::shared_ptr<boost::asio::ssl::context> SSL_GetCachedSslContext(const std::string& cachekey) noexcept {
+            SSL_MutexScope scope(SSL_ContextSyncobj_);
+            std::unordered_map<std::string, std::shared_ptr<boost::asio::ssl::context>>::iterator tail = SSL_ContextCache_.find(cachekey);
+            if (tail != SSL_ContextCache_.end()) {
+                return tail->second;
+            }
+            return NULL;
+        }
+
+        static void SSL_AddCachedSslContext(const std::string& cachekey, const std::shared_ptr<boost::asio::ssl::context>& ssl_context) noexcept {
+            SSL_MutexScope scope(SSL_ContextSyncobj_);
+            SSL_ContextCache_[cachekey] = ssl_context;
+        }
+
+        /* The embedded bundle parses once into a process-wide verification store on
+         * the first client context that verifies peers; every such SSL_CTX then
+         * references the shared store instead of re-parsing ~4,000 lines of PEM,
+         * and configurations that never verify a peer never build it at all. */
+        static X509_STORE* SSL_GetRootCertificateStore() noexcept {
+            static X509_STORE* store_ = []() noexcept -> X509_STORE* {
+                X509_STORE* store = X509_STORE_new();
+                if (!store) {
+                    return NULL;
+                }
+
+                const std::string& pem = get_root_certificates();
+                BIO* bio = BIO_new_mem_buf(pem.data(), (int)pem.size());
+                if (bio) {
+                    for (;;) {
+                        X509* certificate = PEM_read_bio_X509(bio, NULL, NULL, NULL);
+                        if (!certificate) {
+                            ERR_clear_error(); /* The failing read is the end of the bundle. */
+                            break;
+                        }
+
+                        X509_STORE_add_cert(store, certificate);
+                        X509_free(certificate);
+                    }
+                    BIO_free(bio);
+                }
+
+                X509_STORE_set_default_paths(store); /* The system bundle still backs the embedded one. */
+                return store;
+            }();
+            return store_;
+        }
+
+        static SSL_TICKET_KEY& SSL_GetTicketKey() noexcept {
+            static SSL_TICKET_KEY key_ = []() noexcept {
+                SSL_TICKET_KEY key;
+                RAND_bytes((unsigned char*)&key, sizeof(key));
+                return key;
+            }();
+            return key_;
+        }
+
+        static int SSL_TicketKeyCallback(::SSL* ssl, unsigned char* key_name, unsigned char* iv, EVP_CIPHER_CTX* context, EVP_MAC_CTX* hmac, int enc) noexcept {
+            SSL_TICKET_KEY& key = SSL_GetTicketKey();
+            OSSL_PARAM params[] = {
+                OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac_, sizeof(key.hmac_)),
+                OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char*)"SHA256", 0),
+                OSSL_PARAM_construct_end(),
+            };
+
+            if (enc) {
+                if (RAND_bytes(iv, EVP_MAX_IV_LENGTH) < 1) {
+                    return -1;
+                }
+
+                memcpy(key_name, key.name_, sizeof(key.name_));
+                if (EVP_EncryptInit_ex(context, EVP_aes_256_cbc(), NULL, key.aes_, iv) < 1) {
+                    return -1;
+                }
+                return EVP_MAC_CTX_set_params(hmac, params) < 1 ? -1 : 1;
+            }
+
+            if (memcmp(key_name, key.name_, sizeof(key.name_)) != 0) {
+                return 0; /* A ticket from a previous run: fall back to the full handshake. */
+            }
+
+            if (EVP_DecryptInit_ex(context, EVP_aes_256_cbc(), NULL, key.aes_, iv) < 1) {
+                return -1;
+            }
+            return EVP_MAC_CTX_set_params(hmac, params) < 1 ? -1 : 1;
+        }
+
+        static int SSL_SessionHostIndex() noexcept {
+            static int index_ = SSL_get_ex_new_index(0, NULL, NULL, NULL,
+                [](void* parent, void* ptr, CRYPTO_EX_DATA* ad, int idx, long argl, void* argp) noexcept {
+                    std::string* host = (std::string*)ptr;
+                    if (host) {
+                        delete host; /* The ex-data slot owns the raw hostname key. */
+                    }
+                });
+            return index_;
+        }
+
+        static int SSL_NewSessionCallback(::SSL* ssl, SSL_SESSION* session) noexcept {
+            std::string* host = (std::string*)SSL_get_ex_data(ssl, SSL_SessionHostIndex());
+            if (!host) {
+                return 0;
+            }
+
+            SSL_SESSION* stale; {
+                SSL_MutexScope scope(SSL_SessionSyncobj_);
+                SSL_SESSION*& slot = SSL_SessionCache_[*host];
+                stale = slot;
+                slot = session;
+            }
+            if (stale) {
+                SSL_SESSION_free(stale);
+            }
+            return 1; /* The cache keeps the reference handed in by the library. */
+        }
+
+        /* Handshake admission control, one gate per I/O thread (contexts are pinned
+         * one-to-one to threads). asio's ssl::stream cannot migrate executors, so the
+         * asymmetric crypto cannot leave this thread; bounding how many handshakes
+         * interleave instead caps the event-loop share a reconnect storm can steal
+         * from established channels. */
+        static const int                                            SSL_MAX_HANDSHAKES = 8;
+        static thread_local int                                     SSL_ActiveHandshakes_ = 0;
+        static thread_local std::list<std::function<void()>>        SSL_PendingHandshakes_;
+
+        void SSL::BeginSslHandshake(const std::function<void()>& handshake) noexcept {
+            if (!handshake) {
+                return;
+            }
+
+            if (SSL_ActiveHandshakes_ < SSL_MAX_HANDSHAKES) {
+                SSL_ActiveHandshakes_++;
+                handshake();
+                return;
+            }
+            SSL_PendingHandshakes_.push_back(handshake);
+        }
+
+        void SSL::EndSslHandshake() noexcept {
+            if (!SSL_PendingHandshakes_.empty()) {
+                std::function<void()> handshake = std::move(SSL_PendingHandshakes_.front());
+                SSL_PendingHandshakes_.pop_front();
+                handshake(); /* The released slot passes straight to the next waiter. */
+                return;
+            }
+
+            if (SSL_ActiveHandshakes_ > 0) {
+                SSL_ActiveHandshakes_--;
+            }
+        }
+
+        bool SSL::SetSslSession(::SSL* ssl, const std::string& host) noexcept {
+            if (!ssl) {
+                return false;
+            }
+
+            std::string* key = new (std::nothrow) std::string(host);
+            if (!key) {
+                return false;
+            }
+
+            if (SSL_set_ex_data(ssl, SSL_SessionHostIndex(), key) < 1) {
+                delete key;
+                return false;
+            }
+
+            SSL_SESSION* session = NULL; {
+                SSL_MutexScope scope(SSL_SessionSyncobj_);
+                std::unordered_map<std::string, SSL_SESSION*>::iterator tail = SSL_SessionCache_.find(host);
+                if (tail != SSL_SessionCache_.end()) {
+                    session = tail->second;
+                    SSL_SessionCache_.erase(tail);
+                }
+            }
+
+            if (session) {
+                /* TLS 1.3 tickets are single-use, so the ticket leaves the cache with
+                 * this handshake; the server hands fresh tickets back on resumption. */
+                SSL_set_session(ssl, session);
+                SSL_SESSION_free(session);
+            }
+            return true;
+        }
+
+        bool SSL::EnableKernelTls(::SSL* ssl) noexcept {
+            if (!ssl || !KernelTls) {
+                return false;
+            }
+
+            bool enabled = false;
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS)
+            /* Requested on the handle before the handshake runs so the negotiated
+             * keys land in the socket; when the cipher or the kernel cannot offload
+             * OpenSSL silently keeps the crypto in userspace, so nothing breaks on
+             * hosts without the tls module. Per-handle, not per-context: the cached
+             * SSL_CTX instances stay shared with configurations that opted out. */
+            enabled = (SSL_set_options(ssl, SSL_OP_ENABLE_KTLS) & SSL_OP_ENABLE_KTLS) != 0;
+#endif
+            return enabled;
+        }
+
         boost::asio::ssl::context::method SSL::SSL_S_METHOD(int method) noexcept {
             switch (method) {
             case SSL_METHOD::tlsv13:
@@ -97,7 +326,18 @@ namespace uds {
             const std::string& certificate_chain_file,
             const std::string& certificate_key_password,
             const std::string& ciphersuites) noexcept {
-            std::shared_ptr<boost::asio::ssl::context> ssl_context = make_shared_object<boost::asio::ssl::context>(
+            std::string cachekey = "s|" + std::to_string(method) +
+                "|" + certificate_file +
+                "|" + certificate_key_file +
+                "|" + certificate_chain_file +
+                "|" + certificate_key_password +
+                "|" + ciphersuites;
+            std::shared_ptr<boost::asio::ssl::context> ssl_context = SSL_GetCachedSslContext(cachekey);
+            if (ssl_context) {
+                return ssl_context;
+            }
+
+            ssl_context = make_shared_object<boost::asio::ssl::context>(
                 uds::ssl::SSL::SSL_S_METHOD(method));
             if (!ssl_context) {
                 return NULL;
@@ -134,6 +374,14 @@ namespace uds {
                 SSL_CTX_set_ciphersuites(ssl_context->native_handle(), ciphersuites.data());
             }
             SSL_CTX_set_ecdh_auto(ssl_context->native_handle(), 1);
+
+            /* Resumption: server-side session cache plus the process-wide ticket key,
+             * so flapping clients come back in one round trip with no asymmetric work. */
+            SSL_CTX_set_session_id_context(ssl_context->native_handle(), (const unsigned char*)"uds", 3);
+            SSL_CTX_set_session_cache_mode(ssl_context->native_handle(), SSL_SESS_CACHE_SERVER);
+            SSL_CTX_set_tlsext_ticket_key_evp_cb(ssl_context->native_handle(), SSL_TicketKeyCallback);
+
+            SSL_AddCachedSslContext(cachekey, ssl_context);
             return ssl_context;
         }
 
@@ -141,17 +389,28 @@ namespace uds {
             int method, 
             bool verify_peer, 
             const std::string& ciphersuites) noexcept {
-            std::shared_ptr<boost::asio::ssl::context> ssl_context = make_shared_object<boost::asio::ssl::context>(
+            std::string cachekey = "c|" + std::to_string(method) +
+                "|" + std::to_string(verify_peer) +
+                "|" + ciphersuites;
+            std::shared_ptr<boost::asio::ssl::context> ssl_context = SSL_GetCachedSslContext(cachekey);
+            if (ssl_context) {
+                return ssl_context;
+            }
+
+            ssl_context = make_shared_object<boost::asio::ssl::context>(
                 uds::ssl::SSL::SSL_C_METHOD(uds::ssl::SSL::SSL_METHOD::tlsv13));
             if (!ssl_context) {
                 return NULL;
             }
 
-            // This holds the root certificate used for verification.
-            load_root_certificates(*ssl_context);
-
-            // This holds the root certificate used for verification.
-            ssl_context->set_default_verify_paths();
+            // This holds the root certificates used for verification: the shared
+            // store is only ever built when a context actually verifies peers.
+            if (verify_peer) {
+                X509_STORE* store = SSL_GetRootCertificateStore();
+                if (store) {
+                    SSL_CTX_set1_verify_cert_store(ssl_context->native_handle(), store);
+                }
+            }
             ssl_context->set_verify_mode(verify_peer ? boost::asio::ssl::verify_peer : boost::asio::ssl::verify_none);
 
             SSL_CTX_set_cipher_list(ssl_context->native_handle(), "DEFAULT");
@@ -165,6 +424,13 @@ namespace uds {
                 SSL_CTX_set_ciphersuites(ssl_context->native_handle(), ciphersuites.data());
             }
             SSL_CTX_set_ecdh_auto(ssl_context->native_handle(), 1);
+
+            /* Resumption: tickets land in the per-host cache through the new-session
+             * callback and ride out on the next handshake to the same host. */
+            SSL_CTX_set_session_cache_mode(ssl_context->native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+            SSL_CTX_sess_set_new_cb(ssl_context->native_handle(), SSL_NewSessionCallback);
+
+            SSL_AddCachedSslContext(cachekey, ssl_context);
             return ssl_context;
         }
 
@@ -25,6 +25,16 @@ namespace uds {
                 const std::string&                                          certificate_key_file,
                 const std::string&                                          certificate_chain_file) noexcept;
             static const char*                                              GetSslCiphersuites() noexcept;
+            static bool                                                     SetSslSession(::SSL* ssl, const std::string& host) noexcept;
+            static bool                                                     EnableKernelTls(::SSL* ssl) noexcept;
+
+        public:
+            /* Opt-in kernel TLS: the handshake stays in OpenSSL but the negotiated
+             * keys are pushed into the socket, so symmetric crypto runs in the
+             * kernel (or the NIC) instead of userspace. */
+            static bool                                                     KernelTls;
+            static void                                                     BeginSslHandshake(const std::function<void()>& handshake) noexcept;
+            static void                                                     EndSslHandshake() noexcept;
 
         public:
             static std::shared_ptr<boost::asio::ssl::context>               CreateServerSslContext(
@@ -42,8 +42,9 @@ namespace ssl = boost::asio::ssl; // from <boost/asio/ssl.hpp>
 
 namespace detail {
 
-    inline void load_root_certificates(ssl::context& ctx, boost::system::error_code& ec) noexcept
+    inline const std::string& root_certificates() noexcept
     {
+        static const std::string cert_ = []() noexcept {
         std::string cert =
             "# ACCVRAIZ1\n"
             "-----BEGIN CERTIFICATE-----\n"
@@ -3930,7 +3931,14 @@ namespace detail {
             "m7v/OeZWYdMKp8RcTGB7BXcmer/YB1IsYvdwY9k5vG8cwnncdimvzsUsZAReiDZu\n"
             "MdRAGmI0Nj81Aa6sY6A=\n"
             "-----END CERTIFICATE-----";
+        return cert;
+        }();
+        return cert_;
+    }
 
+    inline void load_root_certificates(ssl::context& ctx, boost::system::error_code& ec) noexcept
+    {
+        const std::string& cert = root_certificates();
         ctx.add_certificate_authority(
             boost::asio::buffer(cert.data(), cert.size()), ec);
         if (ec)
@@ -3955,4 +3963,10 @@ inline void load_root_certificates(ssl::context& ctx)
     }
 }
 
+// The raw PEM bundle, for callers that parse it into their own store.
+inline const std::string& get_root_certificates() noexcept
+{
+    return detail::root_certificates();
+}
+
 #endif
@@ -27,6 +27,20 @@ namespace uds {
 #endif
     }
 
+    bool SetThreadAffinity(int cpu) noexcept {
+        if (cpu < 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (cpu & 63)) != 0;
+#else
+        cpu_set_t cpuset_;
+        CPU_ZERO(&cpuset_);
+        CPU_SET(cpu, &cpuset_);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpuset_), &cpuset_) == 0;
+#endif
+    }
+
     void SetProcessPriorityToMaxLevel() noexcept {
 #ifdef _WIN32
         SetPriorityClass(GetCurrentProcess(), REALTIME_PRIORITY_CLASS);
@@ -138,6 +152,11 @@ namespace uds {
         return (Char)GLOBAL_RANDOBJECT.Next(x_[i_], y_[i_]);
     }
 
+    void RandomAsciiFill(void* buffer, int length) noexcept {
+        static thread_local RandomBlock GLOBAL_BLOCKOBJECT; /* Per-thread state: the block generator needs no lock. */
+        GLOBAL_BLOCKOBJECT.NextAscii(buffer, length);
+    }
+
     int RandomNext() noexcept {
         return GLOBAL_RANDOBJECT.Next(0, INT_MAX);
     }
@@ -675,6 +675,8 @@ namespace uds {
 
     Char                                                                    RandomAscii() noexcept;
 
+    void                                                                    RandomAsciiFill(void* buffer, int length) noexcept;
+
     int                                                                     RandomNext() noexcept;
 
     int                                                                     RandomNext(int minValue, int maxValue) noexcept;
@@ -686,7 +688,9 @@ namespace uds {
     void                                                                    SetThreadPriorityToMaxLevel() noexcept;
 
     void                                                                    SetProcessPriorityToMaxLevel() noexcept;
-  
+
+    bool                                                                    SetThreadAffinity(int cpu) noexcept;
+
     bool                                                                    IsInputHelpCommand(int argc, const char* argv[]) noexcept;
 
     bool                                                                    GetCommandArgument(const char* name, int argc, const char** argv, bool defaultValue) noexcept;
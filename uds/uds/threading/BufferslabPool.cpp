@@ -0,0 +1,88 @@
+#include <uds/threading/BufferslabPool.h>
+
+namespace uds {
+    namespace threading {
+        static const int BUFFERSLAB_MIN_CLAZZ                       = 9;  /* 512 bytes. */
+        static const int BUFFERSLAB_MAX_CLAZZ                       = 17; /* 128 kilobytes, covers ETRANSMISSION_TSS + ETRANSMISSION_MSS. */
+        static const int BUFFERSLAB_CLAZZ_COUNT                     = BUFFERSLAB_MAX_CLAZZ - BUFFERSLAB_MIN_CLAZZ + 1;
+        static const int BUFFERSLAB_MAX_FREES                       = 64; /* Cached blocks per clazz per thread. */
+
+        class BufferslabCache final {
+        public:
+            BufferslabCache() noexcept
+                : disposed_(false) {
+                memset(frees_, 0, sizeof(frees_));
+                memset(counts_, 0, sizeof(counts_));
+            }
+            ~BufferslabCache() noexcept {
+                disposed_ = true;
+                for (int slot = 0; slot < BUFFERSLAB_CLAZZ_COUNT; slot++) {
+                    Byte* p = frees_[slot];
+                    frees_[slot] = NULL;
+
+                    while (NULL != p) {
+                        Byte* next = *(Byte**)p;
+                        Mfree(p);
+                        p = next;
+                    }
+                }
+            }
+
+        public:
+            Byte*                                                   frees_[BUFFERSLAB_CLAZZ_COUNT];
+            int                                                     counts_[BUFFERSLAB_CLAZZ_COUNT];
+            bool                                                    disposed_;
+        };
+        static thread_local BufferslabCache bufferslab_cache_;
+
+        std::shared_ptr<Byte> BufferslabPool::Alloc(int length) noexcept {
+            if (length < 1) {
+                return NULL;
+            }
+            elif(length > (1 << BUFFERSLAB_MAX_CLAZZ)) {
+                return make_shared_alloc<Byte>(length);
+            }
+
+            int clazz = BUFFERSLAB_MIN_CLAZZ;
+            while ((1 << clazz) < length) {
+                clazz++;
+            }
+
+            int slot = clazz - BUFFERSLAB_MIN_CLAZZ;
+            BufferslabCache& cache = bufferslab_cache_;
+
+            Byte* p = cache.frees_[slot];
+            if (NULL != p) {
+                cache.frees_[slot] = *(Byte**)p;
+                cache.counts_[slot]--;
+            }
+            else {
+                p = (Byte*)Malloc(1 << clazz);
+                if (NULL == p) {
+                    return NULL;
+                }
+            }
+            return std::shared_ptr<Byte>(p,
+                [clazz](Byte* p) noexcept {
+                    BufferslabPool::Release(p, clazz);
+                });
+        }
+
+        void BufferslabPool::Release(Byte* p, int clazz) noexcept {
+            if (NULL == p) {
+                return;
+            }
+
+            int slot = clazz - BUFFERSLAB_MIN_CLAZZ;
+            BufferslabCache& cache = bufferslab_cache_;
+            if (cache.disposed_ || cache.counts_[slot] >= BUFFERSLAB_MAX_FREES) {
+                Mfree(p);
+                return;
+            }
+
+            *(Byte**)p = cache.frees_[slot];
+            cache.frees_[slot] = p;
+            cache.counts_[slot]++;
+        }
+    }
+}
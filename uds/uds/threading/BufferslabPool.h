@@ -0,0 +1,98 @@
+#pragma once
+
+#include <uds/Reference.h>
+
+namespace uds {
+    namespace threading {
+        /* Slab pool for the frame buffers flowing through the transmission stack. Every hosting
+         * context is pumped by exactly one thread, so the thread-local free lists behave as
+         * per-io_context pools and the hot path never takes a lock. */
+        class BufferslabPool final {
+        public:
+            static std::shared_ptr<Byte>                            Alloc(int length) noexcept;
+
+        private:
+            static void                                             Release(Byte* p, int clazz) noexcept;
+        };
+
+        /* Typed companion to the buffer slab for allocate_shared and node storage:
+         * every instantiation keeps its own per-thread freelist of fixed-size blocks,
+         * so steady-state object churn on a hosting context recycles the same few
+         * blocks instead of touching the allocator. */
+        template <typename T>
+        class ObjectslabAllocator final {
+        public:
+            typedef T                                               value_type;
+
+        public:
+            inline ObjectslabAllocator() noexcept {
+
+            }
+            template <typename U>
+            inline ObjectslabAllocator(const ObjectslabAllocator<U>&) noexcept {
+
+            }
+
+        public:
+            inline T*                                               allocate(std::size_t n) noexcept {
+                if (n != 1) {
+                    return (T*)Malloc(n * sizeof(T));
+                }
+
+                Cache& cache = GetCache();
+                Byte* p = cache.frees_;
+                if (NULL != p) {
+                    cache.frees_ = *(Byte**)p;
+                    cache.count_--;
+                    return (T*)p;
+                }
+                return (T*)Malloc(BlockSize());
+            }
+            inline void                                             deallocate(T* p, std::size_t n) noexcept {
+                if (NULL == p) {
+                    return;
+                }
+                elif(n != 1) {
+                    Mfree(p);
+                    return;
+                }
+
+                Cache& cache = GetCache();
+                if (cache.count_ >= EOBJECTSLAB_MAX_FREES) {
+                    Mfree(p);
+                    return;
+                }
+
+                *(Byte**)p = cache.frees_;
+                cache.frees_ = (Byte*)p;
+                cache.count_++;
+            }
+
+        public:
+            friend inline bool                                      operator==(const ObjectslabAllocator&, const ObjectslabAllocator&) noexcept { return true; }
+            friend inline bool                                      operator!=(const ObjectslabAllocator&, const ObjectslabAllocator&) noexcept { return false; }
+
+        private:
+            static const int                                        EOBJECTSLAB_MAX_FREES = 64; /* Cached blocks per instantiation per thread. */
+
+            struct Cache {
+                Byte*                                               frees_ = NULL;
+                int                                                 count_ = 0;
+
+                inline ~Cache() noexcept {
+                    for (Byte* p = frees_; NULL != p;) {
+                        Byte* next = *(Byte**)p;
+                        Mfree(p);
+                        p = next;
+                    }
+                    frees_ = NULL;
+                }
+            };
+            static inline std::size_t                               BlockSize() noexcept { return std::max<std::size_t>(sizeof(T), sizeof(Byte*)); /* A free block doubles as the list link. */ }
+            static inline Cache&                                    GetCache() noexcept {
+                static thread_local Cache cache;
+                return cache;
+            }
+        };
+    }
+}
@@ -0,0 +1,31 @@
+#include <uds/threading/CryptoWorkerPool.h>
+#include <uds/threading/Hosting.h>
+
+namespace uds {
+    namespace threading {
+        static boost::asio::io_context& CryptoWorkerPool_GetContext() noexcept {
+            static boost::asio::io_context* pool = []() noexcept {
+                boost::asio::io_context* context = new boost::asio::io_context();
+
+                /* Half the cores pump crypto so the other half keep pumping I/O. */
+                int concurrent = std::max<int>(1, Hosting::GetMaxConcurrency() >> 1);
+                for (int i = 0; i < concurrent; i++) {
+                    std::thread(
+                        [context]() noexcept {
+                            SetThreadPriorityToMaxLevel();
+
+                            boost::system::error_code ec_;
+                            boost::asio::io_context::work work_(*context);
+                            context->run(ec_);
+                        }).detach();
+                }
+                return context;
+            }();
+            return *pool;
+        }
+
+        std::shared_ptr<CryptoWorkerPool::Strand> CryptoWorkerPool::NewStrand() noexcept {
+            return make_shared_object<Strand>(CryptoWorkerPool_GetContext());
+        }
+    }
+}
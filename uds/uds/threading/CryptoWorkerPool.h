@@ -0,0 +1,19 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace threading {
+        /* A small pool of dedicated worker threads for CPU-bound jobs (EVP seal/open),
+         * kept apart from the I/O contexts so one channel doing bulk crypto cannot
+         * starve the event loops. Jobs posted through one strand run in submission
+         * order, which preserves the wire order of every transmission that owns one. */
+        class CryptoWorkerPool final {
+        public:
+            typedef boost::asio::io_context::strand         Strand;
+
+        public:
+            static std::shared_ptr<Strand>                  NewStrand() noexcept;
+        };
+    }
+}
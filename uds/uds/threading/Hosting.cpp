@@ -2,11 +2,31 @@
 
 namespace uds {
     namespace threading {
+        bool Hosting::Affinity = false;
+        std::atomic<uint64_t> Hosting::cached_now_ = ATOMIC_VAR_INIT(0);
+
+        uint64_t Hosting::SteadyMillisec() noexcept {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /* Each hosting thread points at its own context's placement counter, so the
+         * per-frame bump from the relay path is an uncontended relaxed add. */
+        static thread_local std::atomic<uint64_t>* hosting_load_ = NULL;
+
         bool Hosting::Run(std::function<void()> entryPoint) noexcept {
+            return Run(1, std::move(entryPoint));
+        }
+
+        bool Hosting::Run(int concurrent, std::function<void()> entryPoint) noexcept {
             if (context_ || buffer_) {
                 return false;
             }
 
+            if (concurrent < 1) {
+                concurrent = GetMaxConcurrency();
+            }
+
             context_ = make_shared_object<boost::asio::io_context>();
             if (!context_) {
                 return false;
@@ -21,6 +41,37 @@ namespace uds {
                 return false;
             }
 
+            /* The first context is run by the calling thread, the rest are pumped by one worker thread each. */
+            contexts_.push_back(context_);
+            loads_.push_back(make_shared_object<std::atomic<uint64_t>>(0));
+            for (int i = 1; i < concurrent; i++) {
+                ContextPtr context = make_shared_object<boost::asio::io_context>();
+                if (!context) {
+                    return false;
+                }
+
+                LoadPtr load = make_shared_object<std::atomic<uint64_t>>(0);
+                contexts_.push_back(context);
+                loads_.push_back(load);
+                std::thread(
+                    [context, load, i]() noexcept {
+                        SetThreadPriorityToMaxLevel();
+                        if (Affinity) {
+                            SetThreadAffinity(i % GetMaxConcurrency());
+                        }
+
+                        hosting_load_ = load.get();
+                        boost::system::error_code ec_;
+                        boost::asio::io_context::work work_(*context);
+                        context->run(ec_);
+                    }).detach();
+            }
+
+            if (Affinity) { /* The calling thread pumps the first context. */
+                SetThreadAffinity(0);
+            }
+            hosting_load_ = loads_[0].get();
+
             if (entryPoint) {
                 context_->post(std::move(entryPoint));
             }
@@ -31,6 +82,50 @@ namespace uds {
             return true;
         }
 
+        std::shared_ptr<boost::asio::io_context> Hosting::GetContext(int index) noexcept {
+            std::size_t concurrent = contexts_.size();
+            if (concurrent < 2 || index < 0) {
+                return context_;
+            }
+            return contexts_[index % concurrent];
+        }
+
+        std::shared_ptr<boost::asio::io_context> Hosting::NextContext() noexcept {
+            std::size_t concurrent = contexts_.size();
+            if (concurrent < 2) {
+                return context_;
+            }
+            return contexts_[rotate_++ % concurrent];
+        }
+
+        std::shared_ptr<boost::asio::io_context> Hosting::LeastContext() noexcept {
+            std::size_t concurrent = contexts_.size();
+            if (concurrent < 2) {
+                return context_;
+            }
+
+            /* Rotating the scan origin breaks ties round-robin when contexts idle. */
+            std::size_t offset = rotate_++;
+            std::size_t least = 0;
+            uint64_t    bytes = UINT64_MAX;
+            for (std::size_t i = 0; i < concurrent; i++) {
+                std::size_t index = (offset + i) % concurrent;
+                uint64_t load = loads_[index]->load(std::memory_order_relaxed);
+                if (load < bytes) {
+                    bytes = load;
+                    least = index;
+                }
+            }
+            return contexts_[least];
+        }
+
+        void Hosting::AddWork(int bytes) noexcept {
+            std::atomic<uint64_t>* load = hosting_load_;
+            if (NULL != load && bytes > 0) {
+                load->fetch_add(bytes, std::memory_order_relaxed);
+            }
+        }
+
         bool Hosting::OpenTimeout() noexcept {
             if (timeout_ || !context_) {
                 return true;
@@ -41,6 +136,16 @@ namespace uds {
                 return false;
             }
 
+            uint64_t now = SteadyMillisec();
+            now_.store(now, std::memory_order_relaxed);
+            cached_now_.store(now, std::memory_order_relaxed);
+
+            wheel_ = make_shared_object<TimingWheel>(now);
+            if (!wheel_) {
+                return false;
+            }
+            TimingWheel::SetDefault(wheel_);
+
             return AwaitTimeoutAsync();
         }
 
@@ -55,7 +160,23 @@ namespace uds {
             timeout->expires_from_now(boost::posix_time::milliseconds(ANY_WAIT_TICK_TIMEOUT));
             timeout->async_wait(
                 [this, reference, timeout](const boost::system::error_code& ec) noexcept {
-                    now_ += ANY_WAIT_TICK_TIMEOUT;
+                    /* One clock syscall per tick re-anchors the cache, so a late timer
+                     * no longer skews every cached read until the process restarts. */
+                    const uint64_t now = SteadyMillisec();
+                    now_.store(now, std::memory_order_relaxed);
+                    cached_now_.store(now, std::memory_order_relaxed);
+
+                    if (++decays_ >= 100) { /* Halve the placement loads about once a second so old elephants stop counting. */
+                        decays_ = 0;
+                        for (const LoadPtr& load : loads_) {
+                            load->store(load->load(std::memory_order_relaxed) >> 1, std::memory_order_relaxed);
+                        }
+                    }
+
+                    const std::shared_ptr<TimingWheel> wheel = wheel_;
+                    if (wheel) {
+                        wheel->Tick(now);
+                    }
                     AwaitTimeoutAsync();
                 });
             return true;
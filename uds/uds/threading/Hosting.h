@@ -1,6 +1,7 @@
 #pragma once
 
 #include <uds/Reference.h>
+#include <uds/threading/TimingWheel.h>
 
 namespace uds {
     namespace threading {
@@ -8,13 +9,20 @@ namespace uds {
             typedef std::shared_ptr<boost::asio::io_context>            ContextPtr;
             typedef std::mutex                                          Mutex;
             typedef std::lock_guard<Mutex>                              MutexScope;
-            typedef std::list<ContextPtr>                               ContextList;
+            typedef std::vector<ContextPtr>                             ContextList;
+            typedef std::shared_ptr<std::atomic<uint64_t>>              LoadPtr;
+            typedef std::vector<LoadPtr>                                LoadList;
             typedef std::shared_ptr<Byte>                               ChunkPtr;
             typedef std::unordered_map<void*, ChunkPtr>                 ChunkTable;
 
         public:
             static const int                                            BufferSize = 65535;
 
+            /* Process-wide pinning switch, copied from the configuration before Run:
+             * hosting thread i sticks to CPU i, and because the slab freelists are
+             * per-thread, first touch then keeps steady-state buffers NUMA-local. */
+            static bool                                                 Affinity;
+
         public:
             inline const std::shared_ptr<boost::asio::io_context>&      GetContext() noexcept {
                 return context_;
@@ -22,13 +30,33 @@ namespace uds {
             inline const std::shared_ptr<Byte>&                         GetBuffer() noexcept {
                 return buffer_;
             }
+            inline const std::shared_ptr<TimingWheel>&                  GetTimingWheel() noexcept {
+                return wheel_;
+            }
+            inline int                                                  GetConcurrency() noexcept {
+                return std::max<int>(1, contexts_.size());
+            }
+            std::shared_ptr<boost::asio::io_context>                    NextContext() noexcept;
+            std::shared_ptr<boost::asio::io_context>                    GetContext(int index) noexcept;
+            std::shared_ptr<boost::asio::io_context>                    LeastContext() noexcept;
+            static void                                                 AddWork(int bytes) noexcept;
             bool                                                        OpenTimeout() noexcept;
             bool                                                        Run(std::function<void()> entryPoint) noexcept;
+            bool                                                        Run(int concurrent, std::function<void()> entryPoint) noexcept;
 
         public:
             inline uint64_t                                             CurrentMillisec() noexcept {
-                return now_;
+                return now_.load(std::memory_order_relaxed);
+            }
+            /* The cached coarse clock: monotonic milliseconds re-anchored by the
+             * 10ms hosting tick, readable lock-free from any thread. Timestamping
+             * a frame costs one relaxed load instead of a clock syscall; before
+             * the first tick (tools, early setup) it falls through to the truth. */
+            inline static uint64_t                                      CachedMillisec() noexcept {
+                uint64_t now = cached_now_.load(std::memory_order_relaxed);
+                return now ? now : SteadyMillisec();
             }
+            static uint64_t                                             SteadyMillisec() noexcept;
             inline static int                                           GetMaxConcurrency() noexcept {
                 int concurrent = std::thread::hardware_concurrency();
                 if (concurrent < 1) {
@@ -97,9 +125,15 @@ namespace uds {
             bool                                                        AwaitTimeoutAsync() noexcept;
 
         private:
-            uint64_t                                                    now_;
+            static std::atomic<uint64_t>                                cached_now_;
+            std::atomic<uint64_t>                                       now_ = ATOMIC_VAR_INIT(0);
+            std::atomic<unsigned int>                                   rotate_ = ATOMIC_VAR_INIT(0);
+            std::shared_ptr<TimingWheel>                                wheel_;
             std::shared_ptr<Byte>                                       buffer_;
             std::shared_ptr<boost::asio::io_context>                    context_;
+            ContextList                                                 contexts_;
+            LoadList                                                    loads_;  /* Recency-weighted bytes relayed per context, for placement. */
+            int                                                         decays_ = 0;
             std::shared_ptr<boost::asio::deadline_timer>                timeout_;
         };
     }
@@ -0,0 +1,210 @@
+#include <uds/threading/Logger.h>
+
+#include <chrono>
+#include <thread>
+
+namespace uds {
+    namespace threading {
+        struct LogRecord {
+            uint64_t                                    tick_;
+            int32_t                                     event_;
+            int64_t                                     a_;
+            int64_t                                     b_;
+        };
+
+        /* Bounded multi-producer ring (Vyukov sequence slots): producers claim a
+         * slot with one CAS and never block, a full ring drops the record and
+         * counts it, and the single flusher thread is the only consumer. */
+        struct alignas(64) LogRing {
+            static const int                            ELOGGER_RING_SIZE = 1024; /* Power of two. */
+
+            struct LogSlot {
+                std::atomic<uint32_t>                   sequence_;
+                LogRecord                               record_;
+            };
+
+            std::atomic<uint32_t>                       head_ = ATOMIC_VAR_INIT(0); /* Flusher only. */
+            std::atomic<uint32_t>                       tail_ = ATOMIC_VAR_INIT(0);
+            std::atomic<uint64_t>                       dropped_ = ATOMIC_VAR_INIT(0);
+            LogSlot                                     slots_[ELOGGER_RING_SIZE];
+
+            LogRing() noexcept {
+                for (int i = 0; i < ELOGGER_RING_SIZE; i++) { /* Slot i is claimable by producer position i. */
+                    slots_[i].sequence_.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            bool                                        Push(const LogRecord& record) noexcept {
+                uint32_t pos = tail_.load(std::memory_order_relaxed);
+                for (;;) {
+                    LogSlot& slot = slots_[pos & (ELOGGER_RING_SIZE - 1)];
+                    uint32_t sequence = slot.sequence_.load(std::memory_order_acquire);
+                    int32_t dif = (int32_t)(sequence - pos);
+                    if (dif == 0) {
+                        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            slot.record_ = record;
+                            slot.sequence_.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    elif(dif < 0) { /* Full: losing a record beats stalling the io thread. */
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    else {
+                        pos = tail_.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+            bool                                        Pop(LogRecord& record) noexcept {
+                uint32_t pos = head_.load(std::memory_order_relaxed);
+                LogSlot& slot = slots_[pos & (ELOGGER_RING_SIZE - 1)];
+                uint32_t sequence = slot.sequence_.load(std::memory_order_acquire);
+                if ((int32_t)(sequence - (pos + 1)) < 0) {
+                    return false;
+                }
+
+                record = slot.record_;
+                slot.sequence_.store(pos + ELOGGER_RING_SIZE, std::memory_order_release);
+                head_.store(pos + 1, std::memory_order_relaxed);
+                return true;
+            }
+        };
+
+        static const int                                ELOGGER_RINGS = 16;
+        static LogRing                                  LOGGER_RINGS[ELOGGER_RINGS];
+        static std::atomic<unsigned int>                LOGGER_ROTATE = ATOMIC_VAR_INIT(0);
+        static std::atomic<bool>                        LOGGER_OPENED = ATOMIC_VAR_INIT(false);
+        static std::atomic<bool>                        LOGGER_EXITING = ATOMIC_VAR_INIT(false);
+        static FILE*                                    LOGGER_FILE = NULL;
+        static std::thread                              LOGGER_FLUSHER;
+
+        static const char* LOGGER_EVENT_FORMATS[Logger::LogEvent_MaxType] = {
+            "accept side=%lld handle=%lld",
+            "handshake success side=%lld handle=%lld",
+            "handshake failure side=%lld handle=%lld",
+            "channel open id=%lld",
+            "channel close id=%lld idle=%lldms",
+            "backpressure begin queued=%lld",
+            "backpressure end queued=%lld",
+        };
+
+        static void Logger_FlushRecord(const LogRecord& record, uint64_t tick, int64_t wall) noexcept {
+            /* The record only carries the cheap monotonic tick: the wall-clock
+             * time is reconstructed once here, off the hot path. */
+            int64_t when = wall - (int64_t)(tick - record.tick_);
+            time_t seconds = (time_t)(when / 1000);
+
+            struct tm tm_;
+#if defined(_WIN32)
+            localtime_s(&tm_, &seconds);
+#else
+            localtime_r(&seconds, &tm_);
+#endif
+
+            char timestamp[32];
+            strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm_);
+
+            char message[160];
+            int event = record.event_;
+            if (event < 0 || event >= Logger::LogEvent_MaxType) {
+                return;
+            }
+
+            snprintf(message, sizeof(message), LOGGER_EVENT_FORMATS[event], (long long)record.a_, (long long)record.b_);
+            fprintf(LOGGER_FILE, "%s.%03d %s\n", timestamp, (int)(when % 1000), message);
+        }
+
+        static void Logger_FlushLoopback() noexcept {
+            uint64_t dropped = 0;
+            for (;;) {
+                int drained = 0;
+                uint64_t tick = uds::GetTickCount();
+                int64_t wall = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+
+                for (int i = 0; i < ELOGGER_RINGS; i++) {
+                    LogRing& ring = LOGGER_RINGS[i];
+
+                    LogRecord record;
+                    while (ring.Pop(record)) {
+                        drained++;
+                        Logger_FlushRecord(record, tick, wall);
+                    }
+
+                    uint64_t lost = ring.dropped_.load(std::memory_order_relaxed);
+                    if (lost > dropped) {
+                        fprintf(LOGGER_FILE, "logger dropped %llu records\n", (unsigned long long)(lost - dropped));
+                        dropped = lost;
+                    }
+                }
+
+                if (drained > 0) {
+                    fflush(LOGGER_FILE);
+                }
+                elif(LOGGER_EXITING.load(std::memory_order_relaxed)) {
+                    return; /* Quiesced after the exit request: everything pushed before Close() is on disk. */
+                }
+                else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+        }
+
+        bool Logger::Open(const std::string& path) noexcept {
+            if (path.empty() || LOGGER_OPENED.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            FILE* file = path == "stdout" ? stdout : fopen(path.data(), "ab");
+            if (!file) {
+                return false;
+            }
+
+            LOGGER_FILE = file;
+            LOGGER_EXITING.exchange(false);
+            LOGGER_FLUSHER = std::thread(Logger_FlushLoopback);
+            LOGGER_OPENED.exchange(true);
+
+            /* The flusher must be joined before static destruction tears the
+             * rings down, even when the process leaves through exit(). */
+            static const int atexit_ = atexit(Logger::Close);
+            (void)atexit_;
+            return true;
+        }
+
+        void Logger::Close() noexcept {
+            if (LOGGER_OPENED.exchange(false)) {
+                LOGGER_EXITING.exchange(true);
+                if (LOGGER_FLUSHER.joinable()) {
+                    LOGGER_FLUSHER.join();
+                }
+
+                FILE* file = LOGGER_FILE;
+                LOGGER_FILE = NULL;
+                if (file && file != stdout) {
+                    fclose(file);
+                }
+            }
+        }
+
+        void Logger::Write(LogEvent event, int64_t a, int64_t b) noexcept {
+            if (!LOGGER_OPENED.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            if (event < 0 || event >= LogEvent_MaxType) {
+                return;
+            }
+
+            LogRecord record;
+            record.tick_ = uds::GetTickCount();
+            record.event_ = event;
+            record.a_ = a;
+            record.b_ = b;
+
+            static thread_local LogRing* ring = addressof(LOGGER_RINGS[LOGGER_ROTATE++ % ELOGGER_RINGS]);
+            ring->Push(record);
+        }
+    }
+}
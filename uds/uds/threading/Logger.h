@@ -0,0 +1,31 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace threading {
+        /* Asynchronous operational log: hot-path call sites push one fixed-size
+         * record into a bounded lock-free ring and return in nanoseconds; a
+         * background thread formats and flushes. When no log file is configured
+         * Write() is a single relaxed load, so the data path never pays for
+         * visibility it is not asked for. */
+        class Logger final {
+        public:
+            enum LogEvent {
+                LogEvent_Accept,
+                LogEvent_HandshakeSuccess,
+                LogEvent_HandshakeFailure,
+                LogEvent_ChannelOpen,
+                LogEvent_ChannelClose,
+                LogEvent_CongestionBegin,
+                LogEvent_CongestionEnd,
+                LogEvent_MaxType,
+            };
+
+        public:
+            static bool                                 Open(const std::string& path) noexcept;
+            static void                                 Close() noexcept;
+            static void                                 Write(LogEvent event, int64_t a, int64_t b) noexcept;
+        };
+    }
+}
@@ -0,0 +1,70 @@
+#include <uds/threading/Statistics.h>
+#include <uds/threading/Hosting.h>
+
+namespace uds {
+    namespace threading {
+        /* One cacheline per shard: a thread bumping its own counters never
+         * invalidates the line another hosting context is writing. */
+        struct alignas(64) StatisticsShard {
+            std::atomic<uint64_t>                       inbound_bytes_;
+            std::atomic<uint64_t>                       inbound_frames_;
+            std::atomic<uint64_t>                       outbound_bytes_;
+            std::atomic<uint64_t>                       outbound_frames_;
+            std::atomic<int64_t>                        queued_bytes_;
+            std::atomic<uint64_t>                       latency_[Statistics::ESTATISTICS_BUCKETS];
+        };
+
+        static const int                                ESTATISTICS_SHARDS = 64;
+        static StatisticsShard                          STATISTICS_SHARDS[ESTATISTICS_SHARDS];
+        static std::atomic<unsigned int>                STATISTICS_ROTATE = ATOMIC_VAR_INIT(0);
+
+        static StatisticsShard& GetShard() noexcept {
+            static thread_local StatisticsShard* shard = addressof(STATISTICS_SHARDS[STATISTICS_ROTATE++ % ESTATISTICS_SHARDS]);
+            return *shard;
+        }
+
+        void Statistics::AddInbound(int length) noexcept {
+            StatisticsShard& shard = GetShard();
+            shard.inbound_bytes_.fetch_add(length, std::memory_order_relaxed);
+            shard.inbound_frames_.fetch_add(1, std::memory_order_relaxed);
+            Hosting::AddWork(length); /* Feeds the per-context placement load. */
+        }
+
+        void Statistics::AddOutbound(int length) noexcept {
+            StatisticsShard& shard = GetShard();
+            shard.outbound_bytes_.fetch_add(length, std::memory_order_relaxed);
+            shard.outbound_frames_.fetch_add(1, std::memory_order_relaxed);
+            Hosting::AddWork(length); /* Feeds the per-context placement load. */
+        }
+
+        void Statistics::AddQueued(int delta) noexcept {
+            GetShard().queued_bytes_.fetch_add(delta, std::memory_order_relaxed);
+        }
+
+        void Statistics::AddLatency(uint64_t milliseconds) noexcept {
+            int bucket = 0;
+            while (milliseconds > 0 && bucket < ESTATISTICS_BUCKETS - 1) {
+                milliseconds >>= 1;
+                bucket++;
+            }
+
+            GetShard().latency_[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Statistics::Collect(Counters& counters) noexcept {
+            counters = Counters();
+            for (int i = 0; i < ESTATISTICS_SHARDS; i++) {
+                StatisticsShard& shard = STATISTICS_SHARDS[i];
+                counters.inbound_bytes_ += shard.inbound_bytes_.load(std::memory_order_relaxed);
+                counters.inbound_frames_ += shard.inbound_frames_.load(std::memory_order_relaxed);
+                counters.outbound_bytes_ += shard.outbound_bytes_.load(std::memory_order_relaxed);
+                counters.outbound_frames_ += shard.outbound_frames_.load(std::memory_order_relaxed);
+                counters.queued_bytes_ += shard.queued_bytes_.load(std::memory_order_relaxed);
+
+                for (int j = 0; j < ESTATISTICS_BUCKETS; j++) {
+                    counters.latency_[j] += shard.latency_[j].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+}
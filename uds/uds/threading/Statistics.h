@@ -0,0 +1,32 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace threading {
+        /* Process-wide traffic counters and a coarse write-latency histogram.
+         * The data path only ever touches relaxed atomics inside a shard picked
+         * once per thread, so hosting contexts never contend with each other
+         * and collection sums the shards without taking a lock. */
+        class Statistics final {
+        public:
+            static const int                            ESTATISTICS_BUCKETS = 16; /* log2 milliseconds: [0] < 1ms, [n] < 2^n ms. */
+
+            struct Counters {
+                uint64_t                                inbound_bytes_  = 0; /* Relayed from the tunnel to the remote socket. */
+                uint64_t                                inbound_frames_ = 0;
+                uint64_t                                outbound_bytes_  = 0; /* Relayed into the tunnel. */
+                uint64_t                                outbound_frames_ = 0;
+                int64_t                                 queued_bytes_ = 0; /* Bytes sitting in transmission write queues. */
+                uint64_t                                latency_[ESTATISTICS_BUCKETS] = { 0 }; /* Frame queue-to-wire times. */
+            };
+
+        public:
+            static void                                 AddInbound(int length) noexcept;
+            static void                                 AddOutbound(int length) noexcept;
+            static void                                 AddQueued(int delta) noexcept;
+            static void                                 AddLatency(uint64_t milliseconds) noexcept;
+            static void                                 Collect(Counters& counters) noexcept;
+        };
+    }
+}
@@ -0,0 +1,92 @@
+#include <uds/threading/TimingWheel.h>
+
+namespace uds {
+    namespace threading {
+        static std::shared_ptr<TimingWheel> default_;
+
+        std::shared_ptr<TimingWheel> TimingWheel::GetDefault() noexcept {
+            return default_;
+        }
+
+        void TimingWheel::SetDefault(const std::shared_ptr<TimingWheel>& wheel) noexcept {
+            default_ = wheel;
+        }
+
+        TimingWheel::TimingWheel(uint64_t now) noexcept
+            : now_(now) {
+
+        }
+
+        TimingWheel::TimeoutPtr TimingWheel::SetTimeout(BOOST_ASIO_MOVE_ARG(TimeoutEventHandler) handler, int timeout) noexcept {
+            TimeoutEventHandler h = BOOST_ASIO_MOVE_CAST(TimeoutEventHandler)(constantof(handler));
+            if (!h || timeout < 1) {
+                return NULL;
+            }
+
+            TimeoutPtr entry = make_shared_object<Timeout>();
+            if (!entry) {
+                return NULL;
+            }
+            entry->handler_ = std::move(h);
+
+            MutexScope scope(syncobj_);
+            uint64_t deadline = now_ + (uint64_t)timeout;
+            entry->deadline_ = deadline;
+            slots_[(deadline / EWHEEL_TICK) % EWHEEL_SLOTS].push_back(entry);
+            return entry;
+        }
+
+        bool TimingWheel::ClearTimeout(TimeoutPtr& timeout) noexcept {
+            TimeoutPtr entry = std::move(timeout);
+            timeout.reset();
+            if (!entry) {
+                return false;
+            }
+
+            /* The slot keeps the dead entry until its rotation comes around; the
+             * flag is enough to make the sweep drop it without ever firing. */
+            int expected = 0;
+            return entry->state_.compare_exchange_strong(expected, 2);
+        }
+
+        void TimingWheel::Tick(uint64_t now) noexcept {
+            std::list<TimeoutPtr> expires; {
+                MutexScope scope(syncobj_);
+                uint64_t prev = now_ / EWHEEL_TICK;
+                uint64_t next = now / EWHEEL_TICK;
+                now_ = now;
+
+                for (uint64_t i = prev + 1; i <= next; i++) {
+                    std::list<TimeoutPtr>& slot = slots_[i % EWHEEL_SLOTS];
+                    for (auto tail = slot.begin(); tail != slot.end();) {
+                        TimeoutPtr& entry = *tail;
+                        if (entry->state_ != 0) {
+                            tail = slot.erase(tail);
+                        }
+                        elif(entry->deadline_ / EWHEEL_TICK <= next) {
+                            /* This rotation of the wheel: fire by tick, not by raw
+                             * deadline, or an entry visited a hair early waits a
+                             * whole extra rotation instead of one tick. */
+                            expires.push_back(std::move(entry));
+                            tail = slot.erase(tail);
+                        }
+                        else {
+                            ++tail; /* A later rotation of the wheel. */
+                        }
+                    }
+                }
+            }
+
+            for (TimeoutPtr& entry : expires) {
+                int expected = 0;
+                if (entry->state_.compare_exchange_strong(expected, 1)) {
+                    TimeoutEventHandler handler = std::move(entry->handler_);
+                    entry->handler_ = NULL;
+                    if (handler) {
+                        handler(entry.get());
+                    }
+                }
+            }
+        }
+    }
+}
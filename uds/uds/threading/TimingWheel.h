@@ -0,0 +1,54 @@
+#pragma once
+
+#include <uds/Reference.h>
+
+namespace uds {
+    namespace threading {
+        /* Hashed timing wheel driven by the hosting 10ms tick: arming or cancelling a
+         * timeout is a bucket operation under one lock instead of a heap-allocated
+         * kernel timer per call, so high accept rates stop churning timer syscalls. */
+        class TimingWheel final : public Reference {
+            using Mutex                             = std::mutex;
+            using MutexScope                        = std::lock_guard<Mutex>;
+
+        public:
+            using TimeoutEventHandler               = std::function<void(void*)>;
+
+            class Timeout final {
+                friend class TimingWheel;
+
+            public:
+                Timeout() noexcept : state_(0), deadline_(0) {}
+
+            private:
+                std::atomic<int>                    state_; /* 0 armed, 1 fired, 2 cancelled. */
+                uint64_t                            deadline_;
+                TimeoutEventHandler                 handler_;
+            };
+            using TimeoutPtr                        = std::shared_ptr<Timeout>;
+
+        public:
+            static const int                        EWHEEL_TICK  = 10;
+            static const int                        EWHEEL_SLOTS = 512;
+
+        public:
+            TimingWheel(uint64_t now) noexcept;
+
+        public:
+            TimeoutPtr                              SetTimeout(BOOST_ASIO_MOVE_ARG(TimeoutEventHandler) handler, int timeout) noexcept;
+            void                                    Tick(uint64_t now) noexcept;
+            static bool                             ClearTimeout(TimeoutPtr& timeout) noexcept;
+
+        public:
+            /* The process-wide wheel, published by the hosting that ticks it; parts of
+             * the tunnel that only hold an io_context schedule through it. */
+            static std::shared_ptr<TimingWheel>     GetDefault() noexcept;
+            static void                             SetDefault(const std::shared_ptr<TimingWheel>& wheel) noexcept;
+
+        private:
+            Mutex                                   syncobj_;
+            uint64_t                                now_;
+            std::list<TimeoutPtr>                   slots_[EWHEEL_SLOTS];
+        };
+    }
+}
@@ -0,0 +1,16 @@
+#include <uds/transmission/ChaCha20Poly1305Transmission.h>
+
+namespace uds {
+    namespace transmission {
+        ChaCha20Poly1305Transmission::ChaCha20Poly1305Transmission(
+            const std::shared_ptr<uds::threading::Hosting>&             hosting,
+            const std::shared_ptr<boost::asio::io_context>&             context,
+            const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
+            const std::string&                                          password,
+            int                                                         alignment,
+            bool                                                        offload) noexcept
+            : EncryptorTransmission(hosting, context, socket, "chacha20-poly1305", password, alignment, offload) {
+
+        }
+    }
+}
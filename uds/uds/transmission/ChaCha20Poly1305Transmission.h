@@ -0,0 +1,21 @@
+#pragma once
+
+#include <uds/transmission/EncryptorTransmission.h>
+
+namespace uds {
+    namespace transmission {
+        /* AEAD transmission pinned to chacha20-poly1305: OpenSSL dispatches it to
+         * vectorized assembly (AVX2/AVX-512/NEON), which beats AES on boxes without
+         * AES-NI while frames stay authenticated end to end. */
+        class ChaCha20Poly1305Transmission final : public EncryptorTransmission {
+        public:
+            ChaCha20Poly1305Transmission(
+                const std::shared_ptr<uds::threading::Hosting>&             hosting,
+                const std::shared_ptr<boost::asio::io_context>&             context,
+                const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
+                const std::string&                                          password,
+                int                                                         alignment,
+                bool                                                        offload = false) noexcept;
+        };
+    }
+}
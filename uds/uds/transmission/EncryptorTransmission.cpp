@@ -1,18 +1,73 @@
 #include <uds/transmission/EncryptorTransmission.h>
+#include <uds/threading/BufferslabPool.h>
+
+#include <openssl/rand.h>
 
 namespace uds {
     namespace transmission {
         EncryptorTransmission::EncryptorTransmission(
-            const std::shared_ptr<uds::threading::Hosting>&             hosting, 
-            const std::shared_ptr<boost::asio::io_context>&             context, 
+            const std::shared_ptr<uds::threading::Hosting>&             hosting,
+            const std::shared_ptr<boost::asio::io_context>&             context,
             const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
             const std::string&                                          method,
             const std::string&                                          password,
-            int                                                         alignment) noexcept
+            int                                                         alignment,
+            bool                                                        offload) noexcept
             : Transmission(hosting, context, socket, alignment)
             , disposed_(false)
-            , encryptor_(method, password) {
-            
+            , encryptor_(method, password)
+            , offloading_(0) {
+            if (offload) {
+                offload_ = uds::threading::CryptoWorkerPool::NewStrand();
+            }
+        }
+
+        bool EncryptorTransmission::HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
+            typedef uds::cryptography::Encryptor                            Encryptor;
+
+            if (!callback || disposed_) {
+                return false;
+            }
+
+            const std::shared_ptr<boost::asio::ip::tcp::socket> socket = GetSocket();
+            if (!socket || !socket->is_open()) {
+                return false;
+            }
+
+            /* The password key and base IV are deterministic, so without fresh
+             * per-session material every connection counts AEAD nonces from the
+             * same (key, nonce) origin. Each peer ships one random salt before
+             * any framed traffic; the send direction is keyed from the local
+             * salt, the receive direction from the peer's. */
+            const std::shared_ptr<Byte> salts = uds::threading::BufferslabPool::Alloc(Encryptor::SESSION_SALT_SIZE << 1);
+            if (!salts || RAND_bytes(salts.get(), Encryptor::SESSION_SALT_SIZE) < 1) {
+                return false;
+            }
+
+            const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+
+            boost::asio::async_write(*socket, boost::asio::buffer(salts.get(), Encryptor::SESSION_SALT_SIZE),
+                [reference_, this, socket, salts, callback_](const boost::system::error_code& ec, size_t) noexcept {
+                    if (ec) {
+                        Close();
+                        callback_(false);
+                        return;
+                    }
+
+                    boost::asio::async_read(*socket, boost::asio::buffer(salts.get() + Encryptor::SESSION_SALT_SIZE, Encryptor::SESSION_SALT_SIZE),
+                        [reference_, this, salts, callback_](const boost::system::error_code& ec, size_t) noexcept {
+                            bool success = ec ?
+                                false :
+                                encryptor_.SessionKey(salts.get(), salts.get() + Encryptor::SESSION_SALT_SIZE, Encryptor::SESSION_SALT_SIZE);
+                            if (!success) {
+                                Close();
+                            }
+
+                            callback_(success);
+                        });
+                });
+            return true;
         }
 
         bool EncryptorTransmission::WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
@@ -20,7 +75,30 @@ namespace uds {
                 return false;
             }
 
+            /* The hop must come before the cipher runs: a stream cipher keyed once
+             * per transmission has to transform frames in wire order, which only the
+             * owning context can guarantee. */
+            if (!InOwnerContext()) {
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            /* Any pending offload job forces the queue: a small frame sealed inline
+             * would otherwise overtake a large one still on the worker. */
+            if (offload_ && (offloading_ > 0 || length >= EENCRYPTOR_OFFLOAD_MSS)) {
+                return WriteOffloadAsync(buffer, offset, length, forward0f(callback));
+            }
+
             int outlen;
+            if (encryptor_.Streaming()) { /* Stream ciphers transform in place without an output buffer. */
+                if (!encryptor_.Encrypt(buffer.get() + offset, length, buffer.get() + offset, outlen) || outlen < 1) {
+                    return false;
+                }
+                return Transmission::WriteAsync(buffer, offset, outlen, forward0f(callback));
+            }
+            elif(encryptor_.Aead()) {
+                return WriteAeadAsync(buffer, offset, length, forward0f(callback));
+            }
+
             const std::shared_ptr<Byte> packet = encryptor_.Encrypt(buffer.get() + offset, length, outlen);
             if (!packet || outlen < 1) {
                 return false;
@@ -34,12 +112,137 @@ namespace uds {
                     }
                 });
         }
-        
+
+        bool EncryptorTransmission::WriteAeadAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            /* Every sealed frame grows by the authentication tag, so full-size relay
+             * chunks are split to keep frames inside the transmission MSS. */
+            int mss = ETRANSMISSION_MSS - encryptor_.Overhead();
+            if (mss < 1) {
+                return false;
+            }
+
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            for (int i = 0; i < length; i += mss) {
+                int chunklen = std::min<int>(mss, length - i);
+                int outlen;
+                const std::shared_ptr<Byte> packet = encryptor_.Encrypt(buffer.get() + offset + i, chunklen, outlen);
+                if (!packet || outlen < 1) {
+                    return false;
+                }
+
+                bool endl = (i + chunklen) >= length;
+                bool success = Transmission::WriteAsync(packet, 0, outlen,
+                    endl ?
+                    (WriteAsyncCallback)[callback_](bool success) noexcept {
+                        if (callback_) {
+                            callback_(success);
+                        }
+                    } : (WriteAsyncCallback)NULL);
+                if (!success) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool EncryptorTransmission::WriteOffloadAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            const std::shared_ptr<boost::asio::io_context> context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            offloading_++;
+
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            boost::asio::post(*offload_,
+                [reference_, this, context, buffer, offset, length, callback_]() noexcept {
+                    /* The CPU-bound cipher runs on the worker; frames come back to the
+                     * owning context in strand order, so the wire order never changes. */
+                    pmessage_vector messages;
+                    bool success = EncryptToMessages(buffer, offset, length, callback_, messages);
+
+                    boost::asio::post(*context,
+                        [reference_, this, messages, success, callback_]() noexcept {
+                            offloading_--;
+                            if (!success) {
+                                if (callback_) {
+                                    callback_(false);
+                                }
+                                Close();
+                                return;
+                            }
+
+                            for (const pmessage& message : messages) {
+                                OnAddWriteAsync(forward0f(message));
+                            }
+                        });
+                });
+            return true;
+        }
+
+        bool EncryptorTransmission::EncryptToMessages(const std::shared_ptr<Byte>& buffer, int offset, int length, const WriteAsyncCallback& callback, pmessage_vector& messages) noexcept {
+            int outlen;
+            if (encryptor_.Streaming()) { /* Stream ciphers transform in place without an output buffer. */
+                if (!encryptor_.Encrypt(buffer.get() + offset, length, buffer.get() + offset, outlen) || outlen < 1) {
+                    return false;
+                }
+
+                pmessage message = Pack(buffer, offset, outlen, WriteAsyncCallback(callback));
+                if (!message) {
+                    return false;
+                }
+
+                messages.push_back(std::move(message));
+                return true;
+            }
+            elif(encryptor_.Aead()) {
+                int mss = ETRANSMISSION_MSS - encryptor_.Overhead();
+                if (mss < 1) {
+                    return false;
+                }
+
+                for (int i = 0; i < length; i += mss) {
+                    int chunklen = std::min<int>(mss, length - i);
+                    const std::shared_ptr<Byte> packet = encryptor_.Encrypt(buffer.get() + offset + i, chunklen, outlen);
+                    if (!packet || outlen < 1) {
+                        return false;
+                    }
+
+                    bool endl = (i + chunklen) >= length;
+                    pmessage message = Pack(packet, 0, outlen, endl ? WriteAsyncCallback(callback) : (WriteAsyncCallback)NULL);
+                    if (!message) {
+                        return false;
+                    }
+
+                    messages.push_back(std::move(message));
+                }
+                return true;
+            }
+
+            const std::shared_ptr<Byte> packet = encryptor_.Encrypt(buffer.get() + offset, length, outlen);
+            if (!packet || outlen < 1) {
+                return false;
+            }
+
+            pmessage message = Pack(packet, 0, outlen, WriteAsyncCallback(callback));
+            if (!message) {
+                return false;
+            }
+
+            messages.push_back(std::move(message));
+            return true;
+        }
+
         bool EncryptorTransmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
             if (!callback) {
                 return false;
             }
 
+            if (!InOwnerContext()) {
+                return ForwardReadAsync(forward0f(callback));
+            }
+
             const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
             return Transmission::ReadAsync(
                 [callback_, this](const std::shared_ptr<Byte>& buffer, int length) noexcept {
@@ -48,7 +251,48 @@ namespace uds {
                         return;
                     }
 
+                    if (offload_ && length >= EENCRYPTOR_OFFLOAD_MSS) {
+                        /* The next read only starts after the callback runs, so the
+                         * frame buffer stays pinned while the worker opens it. */
+                        const std::shared_ptr<ITransmission> reference_ = GetReference();
+                        const std::shared_ptr<boost::asio::io_context> context = GetContext();
+                        boost::asio::post(*offload_,
+                            [reference_, this, context, buffer, length, callback_]() noexcept {
+                                int outlen = ~0;
+                                std::shared_ptr<Byte> packet;
+                                if (encryptor_.Streaming()) {
+                                    if (encryptor_.Decrypt(buffer.get(), length, buffer.get(), outlen) && outlen > 0) {
+                                        packet = buffer;
+                                    }
+                                }
+                                else {
+                                    packet = encryptor_.Decrypt(buffer.get(), length, outlen);
+                                }
+
+                                boost::asio::post(*context,
+                                    [packet, outlen, callback_]() noexcept {
+                                        if (!packet || outlen < 1) {
+                                            callback_(NULL, -1);
+                                        }
+                                        else {
+                                            callback_(packet, outlen);
+                                        }
+                                    });
+                            });
+                        return;
+                    }
+
                     int outlen;
+                    if (encryptor_.Streaming()) { /* Stream ciphers transform in place without an output buffer. */
+                        if (!encryptor_.Decrypt(buffer.get(), length, buffer.get(), outlen) || outlen < 1) {
+                            callback_(NULL, -1);
+                        }
+                        else {
+                            callback_(buffer, outlen);
+                        }
+                        return;
+                    }
+
                     const std::shared_ptr<Byte> packet = encryptor_.Decrypt(buffer.get(), length, outlen);
                     if (!packet || outlen < 1) {
                         callback_(NULL, -1);
@@ -59,4 +303,4 @@ namespace uds {
                 });
         }
     }
-}
\ No newline at end of file
+}
@@ -1,27 +1,43 @@
 #pragma once
 
 #include <uds/transmission/Transmission.h>
+#include <uds/threading/CryptoWorkerPool.h>
 #include <uds/cryptography/Encryptor.h>
 
 namespace uds {
     namespace transmission {
         class EncryptorTransmission : public Transmission {
+        protected:
+            /* Frames at or above this size are sealed/opened on the crypto worker
+             * pool instead of the I/O thread; smaller frames stay inline because
+             * the post round trip costs more than the cipher itself. */
+            const int EENCRYPTOR_OFFLOAD_MSS                                = 4096;
+
         public:
             EncryptorTransmission(
-                const std::shared_ptr<uds::threading::Hosting>&             hosting, 
-                const std::shared_ptr<boost::asio::io_context>&             context, 
+                const std::shared_ptr<uds::threading::Hosting>&             hosting,
+                const std::shared_ptr<boost::asio::io_context>&             context,
                 const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
                 const std::string&                                          method,
-                const std::string&                                          password, 
-                int                                                         alignment) noexcept;
+                const std::string&                                          password,
+                int                                                         alignment,
+                bool                                                        offload = false) noexcept;
 
         public:
-            virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
-            virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
+            virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override final;
+            virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override final;
+
+        private:
+            bool                                                            WriteAeadAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            bool                                                            WriteOffloadAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            bool                                                            EncryptToMessages(const std::shared_ptr<Byte>& buffer, int offset, int length, const WriteAsyncCallback& callback, pmessage_vector& messages) noexcept;
 
         private:
             std::atomic<bool>                                               disposed_;
             uds::cryptography::Encryptor                                    encryptor_;
+            std::shared_ptr<uds::threading::CryptoWorkerPool::Strand>       offload_;
+            int                                                             offloading_;
         };
     }
-}
\ No newline at end of file
+}
@@ -24,6 +24,86 @@ namespace uds {
             return transmission->GetReference();
         }
 
+        std::shared_ptr<boost::asio::ip::tcp::socket> ITransmission::GetUnderlyingSocket() noexcept {
+            return NULL;
+        }
+
+        bool ITransmission::IsCongested() noexcept {
+            return false;
+        }
+
+        bool ITransmission::AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            return false; /* Never congested: there is nothing to wait for. */
+        }
+
+        int ITransmission::GetChunkSize() noexcept {
+            return 0;
+        }
+
+        bool ITransmission::InOwnerContext() noexcept {
+            const std::shared_ptr<boost::asio::io_context> context = GetContext();
+            return NULL == context || context->get_executor().running_in_this_thread();
+        }
+
+        bool ITransmission::ForwardReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
+            const std::shared_ptr<boost::asio::io_context> context = GetContext();
+            const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+            if (!context || !callback_) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            boost::asio::post(*context,
+                [reference_, this, callback_]() noexcept {
+                    if (!ReadAsync(ReadAsyncCallback(callback_))) {
+                        callback_(NULL, -1); /* Refused on the owning context: surfaced as the stream failure the caller already handles. */
+                    }
+                });
+            return true;
+        }
+
+        bool ITransmission::ForwardWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            const std::shared_ptr<boost::asio::io_context> context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const std::shared_ptr<Byte> packet_ = buffer;
+            boost::asio::post(*context,
+                [reference_, this, packet_, offset, length, callback_]() noexcept {
+                    if (WriteAsync(packet_, offset, length, WriteAsyncCallback(callback_))) {
+                        return;
+                    }
+
+                    if (callback_) { /* The caller decides between detach and close, exactly as for a synchronous refusal. */
+                        callback_(false);
+                    }
+                    else {
+                        Close();
+                    }
+                });
+            return true;
+        }
+
+        bool ITransmission::ForwardDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            const std::shared_ptr<boost::asio::io_context> context = GetContext();
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            if (!context || !callback_) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            boost::asio::post(*context,
+                [reference_, this, callback_]() noexcept {
+                    if (!AwaitDrainAsync(WriteAsyncCallback(callback_))) {
+                        callback_(true); /* Drained (or closed) while the hop was in flight: the resumed read finds out on its own. */
+                    }
+                });
+            return true;
+        }
+
         std::shared_ptr<ITransmission> ITransmission::GetReference() noexcept {
             std::weak_ptr<ITransmission> weak = reference_;
             return weak.lock();
@@ -1,14 +1,15 @@
 #pragma once
 
 #include <uds/IDisposable.h>
+#include <uds/InplaceFunction.h>
 #include <uds/net/IPEndPoint.h>
 
 namespace uds {
     namespace transmission {
         class ITransmission {
         public:
-            typedef std::function<void(const std::shared_ptr<Byte>&, int)>      ReadAsyncCallback;
-            typedef std::function<void(bool)>                                   WriteAsyncCallback;
+            typedef InplaceFunction<void(const std::shared_ptr<Byte>&, int)>    ReadAsyncCallback;
+            typedef InplaceFunction<void(bool)>                                 WriteAsyncCallback;
             typedef WriteAsyncCallback                                          HandshakeAsyncCallback;
             typedef enum {
                 HandshakeType_Server,
@@ -42,6 +43,34 @@ namespace uds {
             virtual uds::net::IPEndPoint                                        GetLocalEndPoint() = 0;
             virtual uds::net::IPEndPoint                                        GetRemoteEndPoint() = 0;
 
+        public:
+            /* The raw transport socket when the byte stream carries nothing but the
+             * plain frame header; NULL when it is wrapped (ssl/websocket/cipher). */
+            virtual std::shared_ptr<boost::asio::ip::tcp::socket>               GetUnderlyingSocket() noexcept;
+
+        public:
+            /* Write-side flow control: a transmission whose queued bytes crossed the
+             * high watermark reports congested, and drain waiters fire once the queue
+             * falls back below the low watermark (or with false when it is closed). */
+            virtual bool                                                        IsCongested() noexcept;
+            virtual bool                                                        AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+
+        public:
+            /* The send chunk the transport currently wants relays to feed it with;
+             * zero when it has no opinion and the caller's default applies. */
+            virtual int                                                         GetChunkSize() noexcept;
+
+        protected:
+            /* Thread affinity: a transmission's pending queue, parse cursors and
+             * cipher state are unlocked and belong to the io_context it was created
+             * on. Sharded accepts pair transmissions across contexts, so the entry
+             * points hop off-context callers here first; the callback then fires on
+             * the owning context, like every other completion of the transmission. */
+            bool                                                                InOwnerContext() noexcept;
+            bool                                                                ForwardReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept;
+            bool                                                                ForwardWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            bool                                                                ForwardDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+
         private:
             std::weak_ptr<ITransmission>                                        reference_;
         };
@@ -81,17 +81,14 @@ namespace uds {
             const std::shared_ptr<ITransmission> reference = GetReference();
             const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
 
-            boost::asio::async_write(*ssl_socket_, boost::asio::buffer(messages->packet.get(), messages->packet_size),
+            boost::asio::async_write(*ssl_socket_, ToBuffers(messages),
                 [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
                     bool success = ec ? false : true;
                     if (!success) {
                         Close();
                     }
 
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
+                    OnWriteCompleted(messages, success);
                     OnAsyncWrite(true);
                 });
             return true;
@@ -190,7 +187,11 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
+            if (!InOwnerContext()) { /* Paired shards enter through the owning context: the pending chain is unlocked. */
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            pmessage messages = Pack(buffer, offset, length, forward0f(callback));
             if (!messages) {
                 return false;
             }
@@ -209,6 +210,9 @@ namespace uds {
                 return false;
             }
 
+            if (!InOwnerContext()) {
+                return ForwardReadAsync(forward0f(callback));
+            }
             return Transmission::Unpack(*ssl_socket_, forward0f(callback));
         }
     }
@@ -4,7 +4,7 @@
 
 namespace uds {
     namespace transmission {
-        class SslSocketTransmission : public Transmission {
+        class SslSocketTransmission final : public Transmission {
             typedef boost::asio::ssl::stream<boost::asio::ip::tcp::socket>  SslSocket;
 
         private:
@@ -45,6 +45,9 @@ namespace uds {
 
         public:
             virtual void                                                    Dispose() noexcept override;
+            virtual std::shared_ptr<boost::asio::ip::tcp::socket>      GetUnderlyingSocket() noexcept override {
+                return NULL;
+            }
             virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
@@ -12,6 +12,8 @@ namespace uds {
             bool                                                        verify_peer,
             const std::string&                                          host,
             const std::string&                                          path,
+            bool                                                        compression,
+            int                                                         compression_threshold,
             const std::string&                                          certificate_file,
             const std::string&                                          certificate_key_file,
             const std::string&                                          certificate_chain_file,
@@ -23,6 +25,8 @@ namespace uds {
             , verify_peer_(verify_peer)
             , host_(host)
             , path_(path)
+            , compression_(compression)
+            , compression_threshold_(compression_threshold)
             , certificate_file_(certificate_file)
             , certificate_key_file_(certificate_key_file)
             , certificate_chain_file_(certificate_chain_file)
@@ -38,6 +42,8 @@ namespace uds {
             bool                                                        verify_peer,
             const std::string&                                          host,
             const std::string&                                          path,
+            bool                                                        compression,
+            int                                                         compression_threshold,
             const std::string&                                          ciphersuites,
             int                                                         alignment) noexcept
             : SslWebSocketTransmission(
@@ -47,6 +53,8 @@ namespace uds {
                 verify_peer,
                 host,
                 path,
+                compression,
+                compression_threshold,
                 "",
                 "",
                 "",
@@ -62,6 +70,8 @@ namespace uds {
             const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
             const std::string&                                          host,
             const std::string&                                          path,
+            bool                                                        compression,
+            int                                                         compression_threshold,
             const std::string&                                          certificate_file,
             const std::string&                                          certificate_key_file,
             const std::string&                                          certificate_chain_file,
@@ -75,6 +85,8 @@ namespace uds {
                 false,
                 host,
                 path,
+                compression,
+                compression_threshold,
                 certificate_file,
                 certificate_key_file,
                 certificate_chain_file,
@@ -112,8 +124,8 @@ namespace uds {
 
             class AcceptSslvWebSocket final : public uds::transmission::templates::WebSocket<SslvWebSocket> {
             public:
-                inline AcceptSslvWebSocket(const std::shared_ptr<SslWebSocketTransmission>& transmission, SslvWebSocket& websocket, std::string& host, std::string& path) noexcept
-                    : WebSocket(websocket, host, path)
+                inline AcceptSslvWebSocket(const std::shared_ptr<SslWebSocketTransmission>& transmission, SslvWebSocket& websocket, std::string& host, std::string& path, bool compression, int compression_threshold) noexcept
+                    : WebSocket(websocket, host, path, compression, compression_threshold)
                     , transmission_(transmission) {
 
                 }
@@ -175,7 +187,7 @@ namespace uds {
                 inline bool  PerformWebSocketHandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
                     SslvWebSocketPtr& ssl_websocket_ = GetSslSocket();
                     std::shared_ptr<AcceptSslvWebSocket> accept =
-                        NewReference<AcceptSslvWebSocket>(transmission_, *ssl_websocket_, host_, path_);
+                        NewReference<AcceptSslvWebSocket>(transmission_, *ssl_websocket_, host_, path_, transmission_->compression_, transmission_->compression_threshold_);
                     return accept->HandshakeAsync(type, forward0f(callback));
                 }
                 virtual SSL* GetSslHandle() noexcept override {
@@ -223,17 +235,14 @@ namespace uds {
             const std::shared_ptr<ITransmission> reference = GetReference();
             const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
 
-            ssl_websocket_->async_write(boost::asio::buffer(messages->packet.get(), messages->packet_size),
+            ssl_websocket_->async_write(ToBuffers(messages),
                 [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
                     bool success = ec ? false : true;
                     if (!success) {
                         Close();
                     }
 
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
+                    OnWriteCompleted(messages, success);
                     OnAsyncWrite(true);
                 });
             return true;
@@ -244,7 +253,11 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
+            if (!InOwnerContext()) { /* Paired shards enter through the owning context: the pending chain is unlocked. */
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            pmessage messages = Pack(buffer, offset, length, forward0f(callback));
             if (!messages) {
                 return false;
             }
@@ -258,7 +271,16 @@ namespace uds {
                 return false;
             }
 
-            return Transmission::Unpack(*ssl_websocket_, forward0f(callback));
+            if (!InOwnerContext()) {
+                return ForwardReadAsync(forward0f(callback));
+            }
+
+            std::shared_ptr<SslvWebSocketReadStream> reader = reader_;
+            if (!reader) {
+                reader = make_shared_object<SslvWebSocketReadStream>(*ssl_websocket_);
+                reader_ = reader;
+            }
+            return Transmission::Unpack(*reader, forward0f(callback));
         }
     }
 }
\ No newline at end of file
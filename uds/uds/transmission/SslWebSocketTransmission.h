@@ -1,13 +1,15 @@
 #pragma once
 
 #include <uds/transmission/Transmission.h>
+#include <uds/transmission/templates/WebSocket.hpp>
 
 namespace uds {
     namespace transmission {
-        class SslWebSocketTransmission : public Transmission {
+        class SslWebSocketTransmission final : public Transmission {
             typedef boost::asio::ip::tcp::socket                            AsioTcpSocket;
             typedef boost::asio::ssl::stream<AsioTcpSocket>                 SslvTcpSocket;
             typedef boost::beast::websocket::stream<SslvTcpSocket>          SslvWebSocket;
+            typedef templates::WebSocketReadStream<SslvWebSocket>           SslvWebSocketReadStream;
 
         private:
             SslWebSocketTransmission(
@@ -17,6 +19,8 @@ namespace uds {
                 bool                                                        verify_peer,
                 const std::string&                                          host,
                 const std::string&                                          path,
+                bool                                                        compression,
+                int                                                         compression_threshold,
                 const std::string&                                          certificate_file,
                 const std::string&                                          certificate_key_file,
                 const std::string&                                          certificate_chain_file,
@@ -32,6 +36,8 @@ namespace uds {
                 bool                                                        verify_peer,
                 const std::string&                                          host,
                 const std::string&                                          path,
+                bool                                                        compression,
+                int                                                         compression_threshold,
                 const std::string&                                          ciphersuites,
                 int                                                         alignment) noexcept;
 
@@ -41,6 +47,8 @@ namespace uds {
                 const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
                 const std::string&                                          host,
                 const std::string&                                          path,
+                bool                                                        compression,
+                int                                                         compression_threshold,
                 const std::string&                                          certificate_file,
                 const std::string&                                          certificate_key_file,
                 const std::string&                                          certificate_chain_file,
@@ -50,6 +58,9 @@ namespace uds {
 
         public:
             virtual void                                                    Dispose() noexcept override;
+            virtual std::shared_ptr<boost::asio::ip::tcp::socket>      GetUnderlyingSocket() noexcept override {
+                return NULL;
+            }
             virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
@@ -61,9 +72,12 @@ namespace uds {
             std::atomic<bool>                                               disposed_;
             std::shared_ptr<boost::asio::ssl::context>                      ssl_context_;
             std::shared_ptr<SslvWebSocket>                                  ssl_websocket_;
+            std::shared_ptr<SslvWebSocketReadStream>                        reader_;
             bool                                                            verify_peer_;
             std::string                                                     host_;
             std::string                                                     path_;
+            bool                                                            compression_;
+            int                                                             compression_threshold_;
             std::string                                                     certificate_file_;
             std::string                                                     certificate_key_file_;
             std::string                                                     certificate_chain_file_;
@@ -1,14 +1,40 @@
+#include <uds/Tracepoints.h>
 #include <uds/transmission/Transmission.h>
+#include <uds/compression/Lz4Codec.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/threading/Statistics.h>
+#include <uds/threading/Logger.h>
 #include <uds/net/Socket.h>
 
 namespace uds {
     namespace transmission {
+        Transmission::CompressionTuning Transmission::Compression;
+        Transmission::FramingTuning     Transmission::Framing;
+        Transmission::AdaptiveTuning    Transmission::Adaptive;
+
+        static const int  ETUNING_WINDOW    = 1000;     /* Milliseconds of drained bytes behind each chunk retune. */
+        static const int  ETUNING_FLOOR     = 2 * 1024; /* Smallest chunk the tuner converges to on a slow path. */
+        static const int  ETUNING_DEPTH     = 4;        /* Chunks per round trip: mirrors the relay's read window. */
+        static const int  ETUNING_OVERHEAD  = 60;       /* IP, TCP and option bytes subtracted from the path MTU. */
+        static const int  ETUNING_SEGMENT   = 1400;     /* Fallback segment when the path MTU is unreadable. */
+        static const int  ETUNING_CSS       = 5;        /* Control record behind the zero varint: opcode plus big-endian chunk. */
+        static const Byte ETUNING_OP_CHUNK  = 0x01;     /* Announces the sender's new chunk size. */
+
         Transmission::Transmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const std::shared_ptr<boost::asio::ip::tcp::socket>& socket, int alignment) noexcept
             : disposed_(false)
             , hosting_(hosting)
             , context_(context)
             , socket_(socket)
-            , writing_(false) {
+            , writing_(false)
+            , queued_(0)
+            , congested_(false)
+            , credits_(ETRANSMISSION_CREDITS)
+            , probes_(0)
+            , unpacked_offset_(0)
+            , unpacked_length_(0)
+            , buffered_offset_(0)
+            , buffered_length_(0)
+            , messages_tail_(NULL) {
             typedef uds::net::IPEndPoint IPEndPoint;
 
             /* Format address enpoint. */
@@ -20,7 +46,14 @@ namespace uds {
             if (alignment >= (UINT8_MAX << 1) && alignment <= ETRANSMISSION_MSS) {
                 constantof(ETRANSMISSION_MSS) = alignment;
             }
-            buffer_ = make_shared_alloc<Byte>(ETRANSMISSION_MSS);
+            buffer_ = uds::threading::BufferslabPool::Alloc(ReceiveBufferSize());
+
+            /* The configured alignment is the baseline both ends accept unannounced. */
+            tuned_mss_ = ETRANSMISSION_MSS;
+            announced_mss_ = ETRANSMISSION_MSS;
+            peer_mss_ = ETRANSMISSION_MSS;
+            window_tick_ = 0;
+            window_bytes_ = 0;
         }
 
         uds::net::IPEndPoint Transmission::GetLocalEndPoint() noexcept {
@@ -68,6 +101,9 @@ namespace uds {
                 return false;
             }
 
+            if (!InOwnerContext()) { /* The parse cursors are unlocked: paired shards enter through the owning context. */
+                return ForwardReadAsync(forward0f(callback));
+            }
             return Transmission::Unpack(*socket_, forward0f(callback));
         }
 
@@ -76,7 +112,11 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
+            if (!InOwnerContext()) { /* The intrusive pending chain is unlocked: paired shards enter through the owning context. */
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            pmessage messages = Pack(buffer, offset, length, forward0f(callback));
             if (!messages) {
                 return false;
             }
@@ -87,77 +127,519 @@ namespace uds {
 
         void Transmission::OnAddWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
             const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
+            messages->queued_tick = hosting_ ? hosting_->CurrentMillisec() : 0;
 
-            messages_.push_back(messages);
+            uds::threading::Statistics::AddQueued(ETRANSMISSION_TSS + messages->packet_size);
+
+            int queued = queued_ += ETRANSMISSION_TSS + messages->packet_size;
+            UDS_TRACE2(frame_queued, messages->packet_size, queued);
+            if (queued >= ETRANSMISSION_HWM) { /* The queue outruns the wire: producers should park their reads. */
+                if (!congested_.exchange(true)) {
+                    uds::threading::Logger::Write(uds::threading::Logger::LogEvent_CongestionBegin, queued, 0);
+                }
+            }
+
+            Transmission::message* tail = messages_tail_; /* Qualified: the parameter shadows the node type. */
+            messages_tail_ = messages.get();
+            if (NULL != tail) {
+                tail->next_ = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(messages));
+            }
+            else {
+                messages_ = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(messages));
+            }
             OnAsyncWrite(false);
         }
 
         void Transmission::Dispose() noexcept {
             if (!disposed_.exchange(true)) {
-                messages_.clear();
+                messages_ = NULL; /* The node destructor unlinks the chain iteratively. */
+                messages_tail_ = NULL;
+                OnResumeDrains(false);
                 uds::net::Socket::Closesocket(socket_);
             }
         }
 
+        bool Transmission::IsCongested() noexcept {
+            return congested_;
+        }
+
+        bool Transmission::AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            if (!callback_ || disposed_) {
+                return false;
+            }
+
+            if (!congested_) {
+                return false; /* Drained already: the caller re-arms its read straight away. */
+            }
+
+            if (!InOwnerContext()) { /* The drain queue is unlocked: paired shards park through the owning context. */
+                return ForwardDrainAsync(std::move(callback_));
+            }
+
+            drains_.push_back(std::move(callback_));
+            if (!congested_) { /* The queue emptied while the waiter parked: do not leave it behind. */
+                OnResumeDrains(true);
+            }
+            return true;
+        }
+
+        void Transmission::OnResumeDrains(bool success) noexcept {
+            drain_queue drains = std::move(drains_);
+            drains_.clear();
+
+            for (WriteAsyncCallback& callback : drains) {
+                if (callback) {
+                    callback(success);
+                }
+            }
+        }
+
         bool Transmission::OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
             const std::shared_ptr<ITransmission> reference = GetReference();
             const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
 
-            boost::asio::async_write(*socket_, boost::asio::buffer(messages->packet.get(), messages->packet_size),
+            boost::asio::async_write(*socket_, ToBuffers(messages),
                 [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
                     bool success = ec ? false : true;
                     if (!success) {
                         Close();
                     }
 
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
+                    OnWriteCompleted(messages, success);
                     OnAsyncWrite(true);
                 });
             return true;
         }
 
+        void Transmission::OnWriteCompleted(const pmessage& messages, bool success) noexcept {
+            const uint64_t now = hosting_ ? hosting_->CurrentMillisec() : 0;
+
+            int drained = 0;
+            for (message* message = messages.get(); NULL != message; message = message->next_.get()) {
+                drained += ETRANSMISSION_TSS + message->packet_size;
+                if (success && now >= message->queued_tick) {
+                    uds::threading::Statistics::AddLatency(now - message->queued_tick);
+                }
+
+                const WriteAsyncCallback& callback = message->callback;
+                if (callback) {
+                    callback(success);
+                }
+            }
+
+            uds::threading::Statistics::AddQueued(-drained);
+
+            if (success && Adaptive.enabled && Framing.version >= 2) {
+                window_bytes_ += drained;
+                if (!window_tick_) {
+                    window_tick_ = now;
+                }
+                elif(now >= window_tick_ + ETUNING_WINDOW) {
+                    RetuneChunkSize(now);
+                }
+            }
+
+            int queued = queued_ -= drained;
+            UDS_TRACE3(frame_written, success, drained, queued);
+            if (queued <= ETRANSMISSION_LWM && congested_.exchange(false)) {
+                uds::threading::Logger::Write(uds::threading::Logger::LogEvent_CongestionEnd, queued, 0);
+                OnResumeDrains(true); /* Below the low watermark: parked producers resume their reads. */
+            }
+        }
+
         bool Transmission::OnAsyncWrite(bool internall) noexcept {
             if (!internall) {
-                if (writing_.exchange(true)) { // ���ڶ���д�����Ҳ����ڲ������򷵻���
+                if (writing_.exchange(true)) { // ���ڶ���д�����Ҳ����ڲ������򷵻���
                     return true;
                 }
             }
 
-            message_queue::iterator tail = messages_.begin();
-            message_queue::iterator endl = messages_.end();
-            if (tail == endl) { // ��ǰ��Ϣ�����ǿյ�
+            if (NULL == messages_) { // ��ǰ��Ϣ�����ǿյ�
                 writing_.exchange(false);
                 return false;
             }
 
+            /* Drain the whole pending chain so a burst of small frames leaves
+             * in one gathered write instead of one syscall per frame. */
             std::shared_ptr<ITransmission> reference = GetReference();
-            pmessage message = std::move(*tail);
+            pmessage messages = std::move(messages_); // ����Ϣ������ɾ��������Ϣ
 
-            messages_.erase(tail); // ����Ϣ������ɾ��������Ϣ
-            return OnWriteAsync(BOOST_ASIO_MOVE_CAST(pmessage)(message));
+            messages_ = NULL;
+            messages_tail_ = NULL;
+            return OnWriteAsync(BOOST_ASIO_MOVE_CAST(pmessage)(messages));
         }
 
-        Transmission::pmessage Transmission::Pack(const void* buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
-            if (!buffer || offset < 0 || length < 1 || length > ETRANSMISSION_MSS) {
+        Transmission::pmessage Transmission::Pack(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (!buffer || offset < 0 || length < 1 || length > announced_mss_) { /* The announced chunk is the alignment until the adaptive tuner raises it. */
                 return NULL;
             }
 
-            int packet_size_ = ETRANSMISSION_TSS + length;
-            std::shared_ptr<Byte> packet_ = make_shared_alloc<Byte>(packet_size_);
+            /* The payload is never copied, the caller buffer is pinned by the message
+             * and written on the wire behind the frame header as a gather sequence;
+             * only the compression stage, when it actually shrinks a frame, swaps
+             * the caller buffer for a freshly packed one. */
+            std::shared_ptr<Byte> packet = buffer;
+            int packet_offset = offset;
+            int packet_size = length;
 
-            Byte* p_ = packet_.get();
-            p_[0] = (Byte)(length >> 8);
-            p_[1] = (Byte)(length);
-            memcpy(p_ + ETRANSMISSION_TSS, ((Byte*)buffer) + offset, length);
+            bool compressed = Compression.enabled && Deflate(packet, packet_offset, packet_size);
 
-            pmessage messages = make_shared_object<message>();
-            messages->packet = packet_;
-            messages->packet_size = packet_size_;
+            /* Node and control block land in one slab block that recycles through the
+             * per-thread freelist, so steady-state enqueueing touches no allocator. */
+            pmessage messages = std::allocate_shared<message>(uds::threading::ObjectslabAllocator<message>());
+            if (Framing.version >= 2) { /* Bit 0 of the varint carries the codec flag; the batch head gains the outer length in ToBuffers. */
+                messages->header_size = (Byte)VarintEncode(messages->header, (UInt32)packet_size << 1 | (compressed ? 1 : 0));
+                if (messages->header_size + packet_size > announced_mss_ + ETRANSMISSION_VSS) {
+                    return NULL; /* The peer reads a whole body into one slacked receive buffer; unreachable while payloads honor the alignment. */
+                }
+            }
+            else {
+                Byte flags = compressed ? (Byte)((INT16_MAX + 1) >> 8) : 0; /* Bit 15 of the frame length header. */
+                messages->header[0] = (Byte)(packet_size >> 8) | flags;
+                messages->header[1] = (Byte)(packet_size);
+                messages->header_size = (Byte)(ETRANSMISSION_TSS);
+            }
+            messages->packet = packet;
+            messages->packet_offset = packet_offset;
+            messages->packet_size = packet_size;
             messages->callback = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
             return messages;
         }
+
+        std::vector<boost::asio::const_buffer> Transmission::ToBuffers(const pmessage& messages) noexcept {
+            std::size_t count = 0;
+            for (message* i = messages.get(); NULL != i; i = i->next_.get()) {
+                count++;
+            }
+
+            std::vector<boost::asio::const_buffer> buffers;
+            buffers.reserve(count << 1);
+
+            if (Framing.version >= 2) {
+                /* Greedy batches: consecutive payloads share one outer frame header
+                 * while the combined body still fits the peer's receive buffer, so a
+                 * drained burst of small writes pays one header plus a varint each. */
+                int batch = std::min<int>(announced_mss_ + ETRANSMISSION_VSS, UINT16_MAX); /* Never let a batch body outgrow its two-byte outer length. */
+                for (message* head = messages.get(); NULL != head;) {
+                    int body = 0;
+                    message* tail = head;
+                    while (NULL != tail) {
+                        int wire = tail->header_size + tail->packet_size;
+                        if (tail != head && body + wire > batch) {
+                            break;
+                        }
+
+                        body += wire;
+                        tail = tail->next_.get();
+                    }
+
+                    memmove(head->header + ETRANSMISSION_TSS, head->header, head->header_size);
+                    head->header[0] = (Byte)(body >> 8);
+                    head->header[1] = (Byte)(body);
+                    head->header_size += ETRANSMISSION_TSS;
+
+                    for (message* i = head; i != tail; i = i->next_.get()) {
+                        buffers.push_back(boost::asio::const_buffer(i->header, i->header_size));
+                        buffers.push_back(boost::asio::const_buffer(i->packet.get() + i->packet_offset, i->packet_size));
+                    }
+                    head = tail;
+                }
+                return buffers;
+            }
+
+            for (message* i = messages.get(); NULL != i; i = i->next_.get()) {
+                buffers.push_back(boost::asio::const_buffer(i->header, ETRANSMISSION_TSS));
+                buffers.push_back(boost::asio::const_buffer(i->packet.get() + i->packet_offset, i->packet_size));
+            }
+            return buffers;
+        }
+
+        bool Transmission::OnUnpackNext(const ReadAsyncCallback& callback) noexcept {
+            for (;;) {
+                Byte* p = buffer_.get() + unpacked_offset_;
+                int remaining = unpacked_length_ - unpacked_offset_;
+
+                UInt32 value = 0;
+                int varlen = VarintDecode(p, remaining, value);
+                int size = (int)(value >> 1);
+                if (varlen < 1 || varlen + size > remaining || (size < 1 && (!Adaptive.enabled || remaining < varlen + ETUNING_CSS))) {
+                    unpacked_offset_ = 0; /* A torn payload sequence is a protocol breach, not a short read. */
+                    unpacked_length_ = 0;
+                    Close();
+                    callback(NULL, -1);
+                    return true;
+                }
+
+                if (size < 1) { /* The zero varint escapes into a fixed-size tuning record. */
+                    if (p[varlen] == ETUNING_OP_CHUNK) {
+                        /* The bound only ratchets up: frames the peer sent before a
+                         * shrink are still in flight behind this announcement. */
+                        UInt32 chunk = (UInt32)p[varlen + 1] << 24 | (UInt32)p[varlen + 2] << 16 | (UInt32)p[varlen + 3] << 8 | p[varlen + 4];
+                        int accept = std::min<int>(ReceiveBufferSize() >> 1, UINT16_MAX - ETRANSMISSION_VSS); /* No frame above this can ever legally arrive: its outer length would wrap. */
+                        peer_mss_ = std::max(peer_mss_, (int)std::min<UInt32>(chunk, (UInt32)accept));
+                    } /* Unknown opcodes skip cleanly: the record length is fixed. */
+
+                    unpacked_offset_ += varlen + ETUNING_CSS;
+                    if (unpacked_offset_ >= unpacked_length_) {
+                        unpacked_offset_ = 0;
+                        unpacked_length_ = 0;
+                        return false; /* Only tuning: nothing to hand the reader yet. */
+                    }
+                    continue;
+                }
+
+                unpacked_offset_ += varlen + size;
+                if (unpacked_offset_ >= unpacked_length_) { /* The frame is drained: the next read goes back to the frame parser. */
+                    unpacked_offset_ = 0;
+                    unpacked_length_ = 0;
+                }
+
+                if (value & 1) {
+                    int length = size;
+                    std::shared_ptr<Byte> packet = Inflate(p + varlen, length);
+                    if (!packet) {
+                        unpacked_offset_ = 0;
+                        unpacked_length_ = 0;
+                        Close();
+                        callback(NULL, -1);
+                        return true;
+                    }
+
+                    callback(packet, length);
+                    return true;
+                }
+
+                /* Aliased: the handout pins the receive buffer and points into the body. */
+                callback(std::shared_ptr<Byte>(buffer_, p + varlen), size);
+                return true;
+            }
+        }
+
+        int Transmission::BufferedFrame() noexcept {
+            int remaining = buffered_length_ - buffered_offset_;
+            if (remaining < ETRANSMISSION_TSS) {
+                return 0;
+            }
+
+            Byte* p = buffer_.get() + buffered_offset_;
+            int length = p[0] << 8 | p[1];
+            if (Framing.version < 2 && Compression.enabled) {
+                length &= INT16_MAX; /* Bit 15 carries the codec flag when the stage is on. */
+            }
+
+            int bound = ETRANSMISSION_MSS;
+            if (Framing.version >= 2) { /* The peer may have announced a larger adaptive chunk. */
+                bound = std::max(bound, peer_mss_) + ETRANSMISSION_VSS;
+            }
+
+            if (length < 1 || length > bound) {
+                return -1;
+            }
+            return remaining >= ETRANSMISSION_TSS + length ? 1 : 0;
+        }
+
+        bool Transmission::OnUnpackFrame(const ReadAsyncCallback& callback) noexcept {
+            for (;;) {
+                Byte* p = buffer_.get() + buffered_offset_;
+                bool compressed = false;
+                int length = p[0] << 8 | p[1];
+                if (Framing.version < 2 && Compression.enabled) {
+                    compressed = (length & (INT16_MAX + 1)) != 0; /* Bit 15 carries the codec flag when the stage is on; v2 moves it into the payload varint. */
+                    length &= INT16_MAX;
+                }
+
+                /* The parse cursor moves past the whole frame up front: later frames of
+                 * the same read_some stay behind it for the next delivery. */
+                Byte* body = p + ETRANSMISSION_TSS;
+                buffered_offset_ += ETRANSMISSION_TSS + length;
+                if (buffered_offset_ >= buffered_length_) {
+                    buffered_offset_ = 0;
+                    buffered_length_ = 0;
+                }
+
+                if (Framing.version >= 2) { /* The body is a varint-delimited payload sequence: deliver the first, park the rest. */
+                    unpacked_offset_ = (int)(body - buffer_.get());
+                    unpacked_length_ = unpacked_offset_ + length;
+                    if (OnUnpackNext(callback)) {
+                        return true;
+                    }
+
+                    /* The frame carried nothing but tuning records: move on to the
+                     * next buffered frame, when a whole one is already here. */
+                    int status = BufferedFrame();
+                    if (status > 0) {
+                        continue;
+                    }
+                    elif(status < 0) {
+                        Close();
+                        callback(NULL, -1);
+                        return true;
+                    }
+                    return false;
+                }
+
+                if (compressed) {
+                    std::shared_ptr<Byte> packet = Inflate(body, length);
+                    if (!packet) {
+                        Close();
+                        callback(NULL, -1);
+                        return true;
+                    }
+
+                    callback(packet, length);
+                    return true;
+                }
+
+                /* Aliased: the handout pins the receive buffer and points into the body. */
+                callback(std::shared_ptr<Byte>(buffer_, body), length);
+                return true;
+            }
+        }
+
+        void Transmission::RetuneChunkSize(uint64_t now) noexcept {
+            int64_t elapsed = (int64_t)(now - window_tick_);
+            int64_t bytes = window_bytes_;
+            window_tick_ = now;
+            window_bytes_ = 0;
+
+            const std::shared_ptr<boost::asio::ip::tcp::socket> socket = socket_;
+            int fd = socket ? (int)socket->native_handle() : -1;
+            int rtt = uds::net::Socket::GetRoundTripTime(fd); /* Wrapped transports moved the raw socket out: their chunk stays at the alignment. */
+            if (elapsed < 1 || rtt < 1) {
+                return;
+            }
+
+            /* One relay read of the path's current quantum: the bytes one round trip
+             * carries at the achieved rate, split across the relay's read window so
+             * the pipe never stalls behind a single oversized read. */
+            int64_t quantum = bytes * rtt / (elapsed * 1000);
+            int ceiling = std::min<int>(ReceiveBufferSize() >> 1, UINT16_MAX - ETRANSMISSION_VSS); /* The v2 outer length is two bytes: a slacked batch body must still fit it. */
+            int target = (int)std::min<int64_t>(quantum / ETUNING_DEPTH, ceiling);
+            if (target < ETUNING_FLOOR) {
+                target = ETUNING_FLOOR;
+            }
+
+            /* Whole path segments: the tail of a chunk stops shipping a runt. */
+            int segment = uds::net::Socket::GetPathMtu(fd) - ETUNING_OVERHEAD;
+            if (segment < 1) {
+                segment = ETUNING_SEGMENT;
+            }
+
+            if (target > segment) {
+                target -= target % segment;
+            }
+
+            /* A quarter either way is wiggle, not a trend: leave the chunk alone. */
+            int current = tuned_mss_;
+            if (target * 4 > current * 3 && current * 4 > target * 3) {
+                return;
+            }
+
+            if (target > announced_mss_) {
+                /* The announcement leaves ahead of any larger frame: TCP ordering
+                 * raises the peer's bound before the first chunk that needs it. */
+                if (!AnnounceChunkSize(target)) {
+                    return;
+                }
+                announced_mss_ = target;
+            }
+
+            tuned_mss_ = target;
+        }
+
+        bool Transmission::AnnounceChunkSize(int chunk) noexcept {
+            std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(ETUNING_CSS);
+            if (!packet) {
+                return false;
+            }
+
+            Byte* p = packet.get();
+            p[0] = ETUNING_OP_CHUNK;
+            p[1] = (Byte)(chunk >> 24);
+            p[2] = (Byte)(chunk >> 16);
+            p[3] = (Byte)(chunk >> 8);
+            p[4] = (Byte)(chunk);
+
+            pmessage messages = std::allocate_shared<message>(uds::threading::ObjectslabAllocator<message>());
+            if (!messages) {
+                return false;
+            }
+
+            messages->header[0] = 0; /* The zero-length payload varint escapes into the control record. */
+            messages->header_size = 1;
+            messages->packet = packet;
+            messages->packet_offset = 0;
+            messages->packet_size = ETUNING_CSS;
+            messages->callback = NULL;
+            OnAddWriteAsync(BOOST_ASIO_MOVE_CAST(pmessage)(messages));
+            return true;
+        }
+
+        bool Transmission::Deflate(std::shared_ptr<Byte>& packet, int& offset, int& size) noexcept {
+            if (size < Compression.threshold || size > INT16_MAX) {
+                return false;
+            }
+
+            if (credits_ < 1) { /* Recent frames refused to shrink: idle the codec, probing one frame per window. */
+                if (++probes_ < ETRANSMISSION_PROBES) {
+                    return false;
+                }
+
+                probes_ = 0;
+                credits_ = 1;
+            }
+
+            std::shared_ptr<Byte> block = uds::threading::BufferslabPool::Alloc(size);
+            if (!block) {
+                return false; /* The frame simply ships uncompressed. */
+            }
+
+            int outlen = uds::compression::Lz4Codec::Compress(packet.get() + offset, size,
+                block.get() + ETRANSMISSION_TSS, size - ETRANSMISSION_TSS);
+
+            /* A frame is shipped compressed only when the codec saves at least a
+             * sixteenth of it; marginal wins are not worth the decode on the peer. */
+            int wire = outlen + ETRANSMISSION_TSS;
+            if (outlen < 1 || (size - wire) < (size >> 4)) {
+                credits_--;
+                return false;
+            }
+
+            Byte* p = block.get();
+            p[0] = (Byte)(size >> 8); /* The decompressed length rides ahead of the block. */
+            p[1] = (Byte)(size);
+
+            credits_ = ETRANSMISSION_CREDITS;
+            packet = block;
+            offset = 0;
+            size = wire;
+            return true;
+        }
+
+        std::shared_ptr<Byte> Transmission::Inflate(const Byte* block, int& length) noexcept {
+            const Byte* p = block;
+            if (!p || length <= ETRANSMISSION_TSS) {
+                return NULL;
+            }
+
+            int origin = p[0] << 8 | p[1];
+            if (origin < 1 || origin > ETRANSMISSION_MSS) {
+                return NULL;
+            }
+
+            std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(origin);
+            if (!packet) {
+                return NULL;
+            }
+
+            int outlen = uds::compression::Lz4Codec::Decompress(p + ETRANSMISSION_TSS, length - ETRANSMISSION_TSS, packet.get(), origin);
+            if (outlen != origin) {
+                return NULL;
+            }
+
+            length = origin;
+            return packet;
+        }
     }
 }
\ No newline at end of file
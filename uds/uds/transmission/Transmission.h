@@ -8,18 +8,73 @@ namespace uds {
         class Transmission : public ITransmission {
         protected:
             const int ETRANSMISSION_TSS                             = 2;
+            const int ETRANSMISSION_VSS                             = 3; /* Worst-case payload varint: v2 receive buffers and batch bodies carry this slack so a full-alignment payload still frames. */
             const int ETRANSMISSION_MSS                             = uds::threading::Hosting::BufferSize;
+            const int ETRANSMISSION_RBS                             = 4; /* Receive buffer, in ETRANSMISSION_MSS multiples: one read_some drains a kernel queue of frames. */
+            const int ETRANSMISSION_HWM                             = 4 * 1024 * 1024; /* Queued bytes that mark the stream congested. */
+            const int ETRANSMISSION_CREDITS                         = 8;   /* Consecutive incompressible frames before the codec idles. */
+            const int ETRANSMISSION_PROBES                          = 256; /* Frames skipped while the codec idles between probes. */
+            const int ETRANSMISSION_LWM                             = 1 * 1024 * 1024; /* Queued bytes at which drain waiters resume. */
             struct message {
-                std::shared_ptr<Byte>                               packet;
+                Byte                                                header[5]; /* v1: big-endian ETRANSMISSION_TSS frame length. v2: the payload varint; the batch head grows the outer length in front of it. */
+                Byte                                                header_size;
+                std::shared_ptr<Byte>                               packet;    /* The caller payload buffer, written in place. */
+                int                                                 packet_offset;
                 int                                                 packet_size;
+                uint64_t                                            queued_tick; /* Hosting millisec tick at enqueue, for the latency histogram. */
                 WriteAsyncCallback                                  callback;
+                std::shared_ptr<message>                            next_;       /* Intrusive pending-queue link: the node is its own list cell. */
+
+                inline ~message() noexcept { /* Unlink ahead of teardown so dropping a long chain never recurses. */
+                    for (std::shared_ptr<message> chain = std::move(next_); NULL != chain;) {
+                        std::shared_ptr<message> next = std::move(chain->next_);
+                        chain = std::move(next);
+                    }
+                }
             };
             typedef std::shared_ptr<message>                        pmessage;
-            typedef std::list<pmessage>                             message_queue;
+            typedef std::vector<pmessage>                           pmessage_vector;
+            typedef std::list<WriteAsyncCallback>                   drain_queue;
 
         public:
             Transmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const std::shared_ptr<boost::asio::ip::tcp::socket>& socket, int alignment) noexcept;
 
+        public:
+            /* Process-wide frame compression tuning, copied from the configuration at
+             * startup: both tunnel ends must agree, because an enabled end claims bit
+             * 15 of the frame length header as the compressed flag (which also caps
+             * the alignment at 32767 bytes). Frames below the threshold, and frames
+             * the codec cannot shrink, travel unchanged with the flag clear. */
+            struct CompressionTuning {
+                bool                                                enabled = false;
+                int                                                 threshold = 128;
+            };
+            static CompressionTuning                                Compression;
+
+            /* Process-wide frame format selection, copied from the configuration at
+             * startup: both tunnel ends must agree, because the one-shot channel
+             * handshake carries no capability reply to negotiate against. Version 2
+             * frames a whole drained batch behind one outer length, each payload
+             * prefixed by a varint carrying its size and codec flag, so a burst of
+             * small writes stops paying the fixed header per payload. */
+            struct FramingTuning {
+                int                                                 version = 1;
+            };
+            static FramingTuning                                    Framing;
+
+            /* Process-wide adaptive chunk tuning, copied from the configuration at
+             * startup; requires version 2 framing, because announcements travel as
+             * zero-length payload escapes only the v2 parser knows. Each
+             * transmission retunes its send chunk from the measured RTT, path MTU
+             * and achieved goodput of its own socket, and tells the peer before a
+             * frame ever exceeds the configured alignment; the peer's frame bound
+             * only ever ratchets up, so frames in flight stay valid across a
+             * shrink. */
+            struct AdaptiveTuning {
+                bool                                                enabled = false;
+            };
+            static AdaptiveTuning                                   Adaptive;
+
         public:
             inline const std::shared_ptr<uds::threading::Hosting>&  GetHosting() noexcept {
                 return hosting_;
@@ -31,6 +86,14 @@ namespace uds {
             virtual void                                            Dispose() noexcept override;
             virtual uds::net::IPEndPoint                            GetLocalEndPoint() noexcept override;
             virtual uds::net::IPEndPoint                            GetRemoteEndPoint() noexcept override;
+            virtual std::shared_ptr<boost::asio::ip::tcp::socket>   GetUnderlyingSocket() noexcept override {
+                return socket_;
+            }
+            virtual bool                                            IsCongested() noexcept override;
+            virtual bool                                            AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+            virtual int                                             GetChunkSize() noexcept override {
+                return Adaptive.enabled ? tuned_mss_ : 0;
+            }
 
         protected:
             inline std::shared_ptr<Byte>&                           GetBuffer() noexcept {
@@ -50,7 +113,44 @@ namespace uds {
         protected:
             void                                                    OnAddWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept;
             bool                                                    OnAsyncWrite(bool internall) noexcept;
-            virtual bool                                            OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept;
+            virtual bool                                            OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) messages) noexcept;
+            void                                                    OnWriteCompleted(const pmessage& messages, bool success) noexcept;
+
+        private:
+            void                                                    OnResumeDrains(bool success) noexcept;
+            bool                                                    OnUnpackNext(const ReadAsyncCallback& callback) noexcept;
+            int                                                     BufferedFrame() noexcept;
+            bool                                                    OnUnpackFrame(const ReadAsyncCallback& callback) noexcept;
+            void                                                    RetuneChunkSize(uint64_t now) noexcept;
+            bool                                                    AnnounceChunkSize(int chunk) noexcept;
+            bool                                                    Deflate(std::shared_ptr<Byte>& packet, int& offset, int& size) noexcept;
+            std::shared_ptr<Byte>                                   Inflate(const Byte* block, int& length) noexcept;
+
+        private:
+            inline int                                              ReceiveBufferSize() noexcept {
+                return ETRANSMISSION_RBS * ETRANSMISSION_MSS;
+            }
+
+        private:
+            inline static int                                       VarintEncode(Byte* p, UInt32 value) noexcept {
+                int length = 0;
+                while (value > 0x7f) {
+                    p[length++] = (Byte)(value | 0x80);
+                    value >>= 7;
+                }
+                p[length++] = (Byte)(value);
+                return length;
+            }
+            inline static int                                       VarintDecode(const Byte* p, int length, UInt32& value) noexcept {
+                value = 0;
+                for (int i = 0; i < length && i < 5; i++) {
+                    value |= (UInt32)(p[i] & 0x7f) << (i * 7);
+                    if (!(p[i] & 0x80)) {
+                        return i + 1;
+                    }
+                }
+                return 0;
+            }
 
         protected:
             template<typename AsynchronousStream>
@@ -61,43 +161,74 @@ namespace uds {
 
                 const std::shared_ptr<ITransmission> reference_ = GetReference();
                 const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
-                const static auto trigger = [](Transmission* transmission, int length, const ReadAsyncCallback& callback) noexcept {
-                    if (length < 1) {
-                        transmission->Close();
-                    }
-                    callback(NULL, length);
-                };
-
                 AsynchronousStream* const stream_ = addressof(stream);
-                boost::asio::async_read(*stream_, boost::asio::buffer(buffer_.get(), ETRANSMISSION_TSS),
+
+                if (unpacked_length_ > 0) { /* Payloads of the previous v2 frame are still parked in the buffer: hand over the next one without touching the wire. */
+                    boost::asio::post(*context_,
+                        [reference_, this, callback_, stream_]() noexcept {
+                            if (OnUnpackNext(callback_)) {
+                                return;
+                            }
+
+                            /* Only tuning records remained: fall through to buffered frames, then the wire. */
+                            if (BufferedFrame() > 0 && OnUnpackFrame(callback_)) {
+                                return;
+                            }
+                            UnpackSome(stream_, reference_, callback_);
+                        });
+                    return true;
+                }
+
+                if (BufferedFrame() > 0) { /* An earlier read_some drained this frame off the wire already: deliver it without another syscall. */
+                    boost::asio::post(*context_,
+                        [reference_, this, callback_, stream_]() noexcept {
+                            if (!OnUnpackFrame(callback_)) {
+                                UnpackSome(stream_, reference_, callback_);
+                            }
+                        });
+                    return true;
+                }
+
+                UnpackSome(stream_, reference_, callback_);
+                return true;
+            }
+            template<typename AsynchronousStream>
+            void                                                    UnpackSome(AsynchronousStream* const stream_, const std::shared_ptr<ITransmission>& reference_, const ReadAsyncCallback& callback_) noexcept {
+                /* Slide the partial tail to the front so a maximal frame always fits
+                 * behind it, then pull whatever the kernel has queued in one gulp. */
+                if (buffered_offset_ > 0) {
+                    memmove(buffer_.get(), buffer_.get() + buffered_offset_, buffered_length_ - buffered_offset_);
+                    buffered_length_ -= buffered_offset_;
+                    buffered_offset_ = 0;
+                }
+
+                stream_->async_read_some(boost::asio::buffer(buffer_.get() + buffered_length_, ReceiveBufferSize() - buffered_length_),
                     [reference_, this, callback_, stream_](const boost::system::error_code& ec, std::size_t sz) noexcept {
                         int length = std::max<int>(-1, ec ? -1 : sz);
                         if (length < 1) {
-                            trigger(this, length, callback_);
+                            Close();
+                            callback_(NULL, length);
                             return;
                         }
 
-                        Byte* p = buffer_.get();
-                        length = p[0] << 8 | p[1];
-                        if (length < 1 || length > ETRANSMISSION_MSS) {
-                            trigger(this, -1, callback_);
-                            return;
+                        buffered_length_ += length;
+                        int status = BufferedFrame();
+                        if (status > 0) {
+                            if (!OnUnpackFrame(callback_)) { /* Only tuning records so far: keep reading. */
+                                UnpackSome(stream_, reference_, callback_);
+                            }
+                        }
+                        elif(status < 0) { /* A length the peer can never legally frame: protocol breach. */
+                            Close();
+                            callback_(NULL, -1);
+                        }
+                        else { /* A torn frame head or body: go back for the rest. */
+                            UnpackSome(stream_, reference_, callback_);
                         }
-
-                        boost::asio::async_read(*stream_, boost::asio::buffer(buffer_.get(), length),
-                            [reference_, this, callback_](const boost::system::error_code& ec, std::size_t sz) noexcept {
-                                int length = std::max<int>(-1, ec ? -1 : sz);
-                                if (length < 1) {
-                                    trigger(this, length, callback_);
-                                    return;
-                                }
-
-                                callback_(buffer_, length);
-                            });
                     });
-                return true;
             }
-            pmessage                                                Pack(const void* buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            pmessage                                                Pack(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            std::vector<boost::asio::const_buffer>                  ToBuffers(const pmessage& messages) noexcept;
 
         private:
             std::atomic<bool>                                       disposed_;
@@ -106,7 +237,22 @@ namespace uds {
             std::shared_ptr<boost::asio::io_context>                context_;
             std::shared_ptr<boost::asio::ip::tcp::socket>           socket_;
             std::atomic<bool>                                       writing_;
-            message_queue                                           messages_;
+            std::atomic<int>                                        queued_;    /* Bytes sitting in messages_ plus in-flight gathers. */
+            std::atomic<bool>                                       congested_;
+            int                                                     credits_; /* Remaining codec attempts before the compressor idles. */
+            int                                                     probes_;  /* Frames skipped so far in the current idle window. */
+            int                                                     tuned_mss_;     /* Adaptive send chunk this end targets; ETRANSMISSION_MSS until retuned. */
+            int                                                     announced_mss_; /* Largest chunk the peer has been told to accept; Pack never exceeds it. */
+            int                                                     peer_mss_;      /* Largest chunk the peer announced; the frame bound ratchets up to it. */
+            uint64_t                                                window_tick_;   /* Start of the current goodput measurement window. */
+            int64_t                                                 window_bytes_;  /* Wire bytes drained inside the window. */
+            int                                                     unpacked_offset_; /* Read cursor of the parked v2 frame body, absolute into buffer_. */
+            int                                                     unpacked_length_; /* End of the parked v2 body, absolute into buffer_; zero between frames. */
+            int                                                     buffered_offset_; /* Frame-parse cursor over the raw wire bytes in buffer_. */
+            int                                                     buffered_length_; /* Raw wire bytes an earlier read_some left in buffer_. */
+            pmessage                                                messages_;      /* Head of the intrusive pending chain. */
+            message*                                                messages_tail_; /* Last node, for O(1) enqueue; NULL when the chain is empty. */
+            drain_queue                                             drains_;
             uds::net::IPEndPoint                                    localEP_;
             uds::net::IPEndPoint                                    remoteEP_;
         };
@@ -0,0 +1,150 @@
+#include <uds/transmission/UdpListener.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/threading/Timer.h>
+#include <uds/net/Socket.h>
+
+namespace uds {
+    namespace transmission {
+        UdpListener::UdpListener(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, int alignment) noexcept
+            : disposed_(false)
+            , hosting_(hosting)
+            , context_(context)
+            , alignment_(alignment) {
+            buffer_ = uds::threading::BufferslabPool::Alloc(uds::threading::Hosting::BufferSize);
+        }
+
+        bool UdpListener::Listen(const uds::net::IPEndPoint& bindEP, const BOOST_ASIO_MOVE_ARG(AcceptAsyncCallback) callback) noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            AcceptAsyncCallback callback_accept = BOOST_ASIO_MOVE_CAST(AcceptAsyncCallback)(constantof(callback));
+            if (!callback_accept || disposed_ || socket_) {
+                return false;
+            }
+
+            int listenPort = bindEP.Port;
+            if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
+                listenPort = IPEndPoint::MinPort;
+            }
+
+            boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::udp>(bindEP).address();
+            socket_ = NewReference<boost::asio::ip::udp::socket>(*context_);
+            if (!uds::net::Socket::OpenSocket(*socket_, address, listenPort)) {
+                uds::net::Socket::Closesocket(socket_);
+                socket_.reset();
+                return false;
+            }
+
+            callback_ = std::move(callback_accept);
+            if (!ForwardLoopback() || !NextSweepCycle()) {
+                Dispose();
+                return false;
+            }
+            return true;
+        }
+
+        int UdpListener::GetHandle() noexcept {
+            return socket_ ? uds::net::Socket::GetHandle(*socket_) : -1;
+        }
+
+        bool UdpListener::ForwardLoopback() noexcept {
+            if (disposed_ || !socket_ || !socket_->is_open()) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> reference_ = GetReference();
+            socket_->async_receive_from(boost::asio::buffer(buffer_.get(), uds::threading::Hosting::BufferSize), sourceEP_,
+                [reference_, this](const boost::system::error_code& ec, std::size_t sz) noexcept {
+                    if (ec == boost::system::errc::operation_canceled) {
+                        return;
+                    }
+
+                    if (!ec && sz > 0) {
+                        OnDatagram(sourceEP_, buffer_.get(), (int)sz);
+                    }
+
+                    ForwardLoopback();
+                });
+            return true;
+        }
+
+        void UdpListener::OnDatagram(const boost::asio::ip::udp::endpoint& remoteEP, const Byte* datagram, int length) noexcept {
+            if (length < 1) {
+                return;
+            }
+
+            UdpTransmissionPtr transmission;
+            TransmissionTable::iterator tail = transmissions_.find(remoteEP);
+            if (tail != transmissions_.end()) {
+                transmission = tail->second;
+                if (!transmission->Available()) { /* The endpoint came back after a close: a SYN starts over. */
+                    transmissions_.erase(tail);
+                    transmission.reset();
+                }
+            }
+
+            if (transmission) {
+                transmission->OnInput(datagram, length);
+                return;
+            }
+
+            if (datagram[0] != 1) { /* Anything but a SYN from an unknown endpoint is a stray. */
+                return;
+            }
+
+            transmission = NewReference<UdpTransmission>(hosting_, context_, socket_, remoteEP, alignment_);
+            transmission->Constructor(transmission);
+            transmissions_.emplace(remoteEP, transmission);
+            transmission->OnInput(datagram, length);
+
+            if (!callback_(transmission)) {
+                transmission->Close();
+            }
+        }
+
+        bool UdpListener::NextSweepCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> reference_ = GetReference();
+            sweeper_ = uds::threading::SetTimeout(context_,
+                [reference_, this](void*) noexcept {
+                    sweeper_.reset();
+                    if (disposed_) {
+                        return;
+                    }
+
+                    TransmissionTable::iterator tail = transmissions_.begin();
+                    while (tail != transmissions_.end()) {
+                        if (tail->second->Available()) {
+                            ++tail;
+                        }
+                        else {
+                            tail = transmissions_.erase(tail);
+                        }
+                    }
+                    NextSweepCycle();
+                }, EUDP_SWEEP_INTERVAL);
+            return NULL != sweeper_;
+        }
+
+        void UdpListener::Dispose() noexcept {
+            if (disposed_.exchange(true)) {
+                return;
+            }
+
+            if (sweeper_) {
+                uds::threading::ClearTimeout(sweeper_);
+            }
+
+            TransmissionTable transmissions = std::move(transmissions_);
+            transmissions_.clear();
+            for (TransmissionTable::value_type& kv : transmissions) {
+                kv.second->Close();
+            }
+
+            callback_ = NULL;
+            uds::net::Socket::Closesocket(socket_);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <uds/transmission/UdpTransmission.h>
+
+namespace uds {
+    namespace transmission {
+        /* The datagram counterpart of a listening acceptor: one bound udp socket
+         * whose receive loop demultiplexes by sender endpoint. The first SYN from
+         * an unknown endpoint materializes a UdpTransmission and hands it to the
+         * accept callback; every later datagram from that endpoint feeds the same
+         * transmission's ARQ input path. */
+        class UdpListener final : public IDisposable {
+            using AsioUdpSocket                                     = UdpTransmission::AsioUdpSocket;
+            using UdpTransmissionPtr                                = std::shared_ptr<UdpTransmission>;
+            using TransmissionTable                                 = std::map<boost::asio::ip::udp::endpoint, UdpTransmissionPtr>;
+
+        private:
+            static const int EUDP_SWEEP_INTERVAL                    = 60 * 1000; /* Disposed but quiet endpoints leave the table on this cadence. */
+
+        public:
+            typedef std::function<bool(const UdpTransmissionPtr&)>  AcceptAsyncCallback;
+
+        public:
+            UdpListener(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, int alignment) noexcept;
+
+        public:
+            bool                                                    Listen(const uds::net::IPEndPoint& bindEP, const BOOST_ASIO_MOVE_ARG(AcceptAsyncCallback) callback) noexcept;
+            virtual void                                            Dispose() noexcept override;
+            int                                                     GetHandle() noexcept;
+
+        private:
+            bool                                                    ForwardLoopback() noexcept;
+            void                                                    OnDatagram(const boost::asio::ip::udp::endpoint& remoteEP, const Byte* datagram, int length) noexcept;
+            bool                                                    NextSweepCycle() noexcept;
+
+        private:
+            std::atomic<bool>                                       disposed_;
+            std::shared_ptr<uds::threading::Hosting>                hosting_;
+            std::shared_ptr<boost::asio::io_context>                context_;
+            AsioUdpSocket                                           socket_;
+            int                                                     alignment_;
+            AcceptAsyncCallback                                     callback_;
+            std::shared_ptr<Byte>                                   buffer_;
+            boost::asio::ip::udp::endpoint                          sourceEP_;
+            TransmissionTable                                       transmissions_;
+            std::shared_ptr<boost::asio::deadline_timer>            sweeper_;
+        };
+    }
+}
@@ -0,0 +1,589 @@
+#include <uds/transmission/UdpTransmission.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/threading/Timer.h>
+#include <uds/net/Socket.h>
+
+namespace uds {
+    namespace transmission {
+        static inline uint32_t UdpTransmission_ReadU32(const Byte* p) noexcept {
+            return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+        }
+
+        static inline void UdpTransmission_WriteU32(Byte* p, uint32_t v) noexcept {
+            p[0] = (Byte)(v >> 24);
+            p[1] = (Byte)(v >> 16);
+            p[2] = (Byte)(v >> 8);
+            p[3] = (Byte)(v);
+        }
+
+        /* Signed distance on the wrapping sequence circle. */
+        static inline int UdpTransmission_Distance(uint32_t lhs, uint32_t rhs) noexcept {
+            return (int)(int32_t)(lhs - rhs);
+        }
+
+        UdpTransmission::UdpTransmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const boost::asio::ip::udp::endpoint& remoteEP, int alignment) noexcept
+            : disposed_(false)
+            , hosting_(hosting)
+            , context_(context)
+            , binded_(false)
+            , established_(false)
+            , remoteEP_(remoteEP)
+            , alignment_(alignment)
+            , syn_tick_(0)
+            , snd_nxt_(0)
+            , srtt_(0)
+            , rto_(ERUDP_RTO_INIT)
+            , last_ack_(0)
+            , dupacks_(0)
+            , rcv_nxt_(0)
+            , instream_size_(0)
+            , reading_header_(true)
+            , reading_length_(0)
+            , queued_(0)
+            , congested_(false) {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            socket_ = Reference::NewReference<boost::asio::ip::udp::socket>(*context);
+            if (uds::net::Socket::OpenSocket(*socket_, remoteEP.address().is_v4() ?
+                boost::asio::ip::address(boost::asio::ip::address_v4::any()) :
+                boost::asio::ip::address(boost::asio::ip::address_v6::any()), IPEndPoint::MinPort)) {
+                boost::system::error_code ec;
+                socket_->connect(remoteEP, ec);
+            }
+            rbuffer_ = uds::threading::BufferslabPool::Alloc(uds::threading::Hosting::BufferSize);
+        }
+
+        UdpTransmission::UdpTransmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const AsioUdpSocket& socket, const boost::asio::ip::udp::endpoint& remoteEP, int alignment) noexcept
+            : disposed_(false)
+            , hosting_(hosting)
+            , context_(context)
+            , socket_(socket)
+            , binded_(true)
+            , established_(false)
+            , remoteEP_(remoteEP)
+            , alignment_(alignment)
+            , syn_tick_(0)
+            , snd_nxt_(0)
+            , srtt_(0)
+            , rto_(ERUDP_RTO_INIT)
+            , last_ack_(0)
+            , dupacks_(0)
+            , rcv_nxt_(0)
+            , instream_size_(0)
+            , reading_header_(true)
+            , reading_length_(0)
+            , queued_(0)
+            , congested_(false) {
+
+        }
+
+        std::shared_ptr<boost::asio::io_context> UdpTransmission::GetContext() noexcept {
+            return context_;
+        }
+
+        uds::net::IPEndPoint UdpTransmission::GetLocalEndPoint() noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            boost::system::error_code ec;
+            return IPEndPoint::V6ToV4(IPEndPoint::ToEndPoint(socket_ ? socket_->local_endpoint(ec) : boost::asio::ip::udp::endpoint()));
+        }
+
+        uds::net::IPEndPoint UdpTransmission::GetRemoteEndPoint() noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            return IPEndPoint::V6ToV4(IPEndPoint::ToEndPoint(remoteEP_));
+        }
+
+        bool UdpTransmission::HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
+            if (!callback || disposed_) {
+                return false;
+            }
+
+            if (!socket_ || !socket_->is_open()) {
+                return false;
+            }
+
+            const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+
+            if (type == HandshakeType::HandshakeType_Server) {
+                /* The listener only creates the transmission on a SYN: acknowledge it
+                 * and consider the link up; a lost SYNACK comes back as a duplicate
+                 * SYN and is answered again from the input path. */
+                established_ = true;
+                TransmitControl(ERUDP_KIND_SYNACK);
+                if (!NextTickCycle()) {
+                    return false;
+                }
+
+                boost::asio::post(*context_,
+                    [reference_, this, callback_]() noexcept {
+                        callback_(!disposed_);
+                    });
+                return true;
+            }
+
+            handshake_ = callback_;
+            syn_tick_ = uds::threading::Hosting::CachedMillisec();
+            TransmitControl(ERUDP_KIND_SYN);
+            if (!ForwardLoopback() || !NextTickCycle()) {
+                handshake_ = NULL;
+                return false;
+            }
+            return true;
+        }
+
+        bool UdpTransmission::ForwardLoopback() noexcept {
+            if (disposed_ || !socket_ || !socket_->is_open()) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            socket_->async_receive(boost::asio::buffer(rbuffer_.get(), uds::threading::Hosting::BufferSize),
+                [reference_, this](const boost::system::error_code& ec, std::size_t sz) noexcept {
+                    if (ec == boost::system::errc::operation_canceled) {
+                        return;
+                    }
+
+                    /* Datagram sockets surface icmp unreachable as a receive error:
+                     * stay on the loop and let the retransmission timer decide. */
+                    if (!ec && sz > 0) {
+                        OnInput(rbuffer_.get(), (int)sz);
+                    }
+
+                    ForwardLoopback();
+                });
+            return true;
+        }
+
+        bool UdpTransmission::NextTickCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            ticker_ = uds::threading::SetTimeout(context_,
+                [reference_, this](void*) noexcept {
+                    ticker_.reset();
+                    if (!disposed_) {
+                        OnTickEvent();
+                        NextTickCycle();
+                    }
+                }, ERUDP_TICK);
+            return NULL != ticker_;
+        }
+
+        void UdpTransmission::OnTickEvent() noexcept {
+            UInt64 now = uds::threading::Hosting::CachedMillisec();
+            if (!established_) {
+                if (handshake_ && now >= syn_tick_ + ERUDP_SYN_INTERVAL) {
+                    syn_tick_ = now;
+                    TransmitControl(ERUDP_KIND_SYN);
+                }
+                return;
+            }
+
+            for (psegment& segments : flight_) {
+                if (now < segments->expires_) {
+                    continue;
+                }
+
+                if (++segments->retries_ > ERUDP_RETRIES) {
+                    Close(); /* The path went dark: no transport below will keep trying for us. */
+                    return;
+                }
+
+                segments->expires_ = now + std::min<int>(rto_ << std::min<int>(segments->retries_, 4), ERUDP_RTO_MAX);
+                TransmitSegment(segments);
+            }
+        }
+
+        bool UdpTransmission::WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (!buffer || offset < 0 || length < 1 || length > alignment_) {
+                return false;
+            }
+
+            if (disposed_ || !socket_ || !socket_->is_open()) {
+                return false;
+            }
+
+            if (!InOwnerContext()) { /* The segment queues are unlocked: paired shards enter through the owning context. */
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+
+            /* The frame and its two-byte length header are copied into segment-sized
+             * datagrams: unlike the stream transports there is no gathered write to
+             * pin the caller buffer behind. */
+            Byte header[2] = { (Byte)(length >> 8), (Byte)(length) };
+            int remaining = sizeof(header) + length;
+            int position = 0;
+
+            while (remaining > 0) {
+                int size = std::min<int>(remaining, ERUDP_MSS);
+                std::shared_ptr<Byte> datagram = uds::threading::BufferslabPool::Alloc(ERUDP_HDR + size);
+                Byte* p = datagram.get();
+                p[0] = (Byte)ERUDP_KIND_PSH;
+                UdpTransmission_WriteU32(p + 1, snd_nxt_);
+                UdpTransmission_WriteU32(p + 5, rcv_nxt_);
+                p[9] = (Byte)(size >> 8);
+                p[10] = (Byte)(size);
+
+                Byte* q = p + ERUDP_HDR;
+                for (int i = 0; i < size; i++, position++) {
+                    *q++ = position < (int)sizeof(header) ? header[position] : buffer.get()[offset + position - sizeof(header)];
+                }
+
+                psegment segments = make_shared_object<segment>();
+                segments->seq_ = snd_nxt_++;
+                segments->datagram_ = datagram;
+                segments->length_ = ERUDP_HDR + size;
+                segments->expires_ = 0;
+                segments->sent_tick_ = 0;
+                segments->retries_ = 0;
+
+                remaining -= size;
+                if (remaining < 1) {
+                    segments->callback_ = std::move(callback_);
+                }
+
+                queued_ += size;
+                unsent_.push_back(std::move(segments));
+            }
+
+            int queued = queued_;
+            if (queued >= ERUDP_HWM) {
+                congested_.exchange(true);
+            }
+
+            TransmitPending();
+            return true;
+        }
+
+        void UdpTransmission::TransmitPending() noexcept {
+            UInt64 now = uds::threading::Hosting::CachedMillisec();
+            while (!unsent_.empty() && (int)flight_.size() < ERUDP_WND) {
+                psegment segments = std::move(unsent_.front());
+                unsent_.pop_front();
+
+                segments->sent_tick_ = now;
+                segments->expires_ = now + rto_;
+                TransmitSegment(segments);
+                flight_.push_back(std::move(segments));
+            }
+        }
+
+        void UdpTransmission::TransmitSegment(const psegment& segments) noexcept {
+            UdpTransmission_WriteU32(segments->datagram_.get() + 5, rcv_nxt_); /* Refresh the piggybacked ack. */
+            TransmitDatagram(segments->datagram_, segments->length_);
+
+            const WriteAsyncCallback callback = std::move(segments->callback_);
+            segments->callback_ = NULL;
+            if (callback) {
+                callback(true);
+            }
+        }
+
+        void UdpTransmission::TransmitControl(Byte kind) noexcept {
+            std::shared_ptr<Byte> datagram = uds::threading::BufferslabPool::Alloc(ERUDP_HDR);
+            Byte* p = datagram.get();
+            p[0] = kind;
+            UdpTransmission_WriteU32(p + 1, snd_nxt_);
+            UdpTransmission_WriteU32(p + 5, rcv_nxt_);
+            p[9] = 0;
+            p[10] = 0;
+            TransmitDatagram(datagram, ERUDP_HDR);
+        }
+
+        void UdpTransmission::TransmitDatagram(const std::shared_ptr<Byte>& datagram, int length) noexcept {
+            if (!socket_ || !socket_->is_open()) {
+                return;
+            }
+
+            const std::shared_ptr<Byte> datagram_ = datagram; /* Pinned until the send completes. */
+            boost::system::error_code ec;
+            if (binded_) {
+                socket_->async_send_to(boost::asio::buffer(datagram_.get(), length), remoteEP_,
+                    [datagram_](const boost::system::error_code&, std::size_t) noexcept {});
+            }
+            else {
+                socket_->async_send(boost::asio::buffer(datagram_.get(), length),
+                    [datagram_](const boost::system::error_code&, std::size_t) noexcept {});
+            }
+        }
+
+        void UdpTransmission::OnInput(const Byte* datagram, int length) noexcept {
+            if (disposed_ || length < ERUDP_HDR) {
+                return;
+            }
+
+            int kind = datagram[0];
+            uint32_t seq = UdpTransmission_ReadU32(datagram + 1);
+            uint32_t ack = UdpTransmission_ReadU32(datagram + 5);
+            int size = datagram[9] << 8 | datagram[10];
+            if (size != length - ERUDP_HDR) {
+                return;
+            }
+
+            if (kind == ERUDP_KIND_SYN) {
+                if (established_) {
+                    TransmitControl(ERUDP_KIND_SYNACK); /* The peer missed our SYNACK. */
+                }
+                return;
+            }
+
+            if (kind == ERUDP_KIND_SYNACK) {
+                established_ = true;
+                const HandshakeAsyncCallback handshake = std::move(handshake_);
+                handshake_ = NULL;
+                if (handshake) {
+                    handshake(true);
+                }
+                return;
+            }
+
+            if (kind == ERUDP_KIND_FIN) {
+                Close();
+                return;
+            }
+
+            if (kind == ERUDP_KIND_PSH) {
+                OnAcknowledge(ack);
+                OnPush(seq, datagram + ERUDP_HDR, size);
+                TransmitControl(ERUDP_KIND_ACK);
+                return;
+            }
+
+            if (kind == ERUDP_KIND_ACK) {
+                OnAcknowledge(ack);
+            }
+        }
+
+        void UdpTransmission::OnAcknowledge(uint32_t ack) noexcept {
+            UInt64 now = uds::threading::Hosting::CachedMillisec();
+            int drained = 0;
+
+            while (!flight_.empty()) {
+                psegment& segments = flight_.front();
+                if (UdpTransmission_Distance(segments->seq_, ack) >= 0) {
+                    break;
+                }
+
+                if (!segments->retries_) { /* Karn: only a first transmission samples the RTT. */
+                    int rtt = std::max<int>(1, (int)(now - segments->sent_tick_));
+                    srtt_ = srtt_ ? (srtt_ * 7 + rtt) >> 3 : rtt;
+                    rto_ = std::max<int>(ERUDP_RTO_MIN, std::min<int>(srtt_ << 1, ERUDP_RTO_MAX));
+                }
+
+                drained += segments->length_ - ERUDP_HDR;
+                flight_.pop_front();
+            }
+
+            if (drained > 0) {
+                dupacks_ = 0;
+                last_ack_ = ack;
+
+                int queued = queued_ -= drained;
+                if (queued <= ERUDP_LWM && congested_.exchange(false)) {
+                    OnResumeDrains(true);
+                }
+            }
+            elif(ack == last_ack_ && !flight_.empty()) {
+                if (++dupacks_ >= ERUDP_DUPACKS) { /* The hole is at the front: do not wait for the timer. */
+                    dupacks_ = 0;
+                    flight_.front()->retries_++;
+                    flight_.front()->expires_ = now + rto_;
+                    TransmitSegment(flight_.front());
+                }
+            }
+
+            TransmitPending();
+        }
+
+        void UdpTransmission::OnPush(uint32_t seq, const Byte* payload, int length) noexcept {
+            int distance = UdpTransmission_Distance(seq, rcv_nxt_);
+            if (distance < 0 || distance >= ERUDP_RCV_WND || length < 1) {
+                return; /* Already delivered, or too far ahead to hold. */
+            }
+
+            chunk chunks;
+            chunks.buffer_ = uds::threading::BufferslabPool::Alloc(length);
+            chunks.offset_ = 0;
+            chunks.length_ = length;
+            memcpy(chunks.buffer_.get(), payload, length);
+
+            if (distance > 0) {
+                reorder_.emplace(seq, std::move(chunks));
+                return;
+            }
+
+            instream_.push_back(std::move(chunks));
+            instream_size_ += length;
+            rcv_nxt_++;
+
+            for (;;) { /* The arrival may have plugged the hole ahead of the reorder buffer. */
+                reorder_map::iterator tail = reorder_.find(rcv_nxt_);
+                if (tail == reorder_.end()) {
+                    break;
+                }
+
+                instream_size_ += tail->second.length_;
+                instream_.push_back(std::move(tail->second));
+                reorder_.erase(tail);
+                rcv_nxt_++;
+            }
+
+            DeliverReads();
+        }
+
+        bool UdpTransmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
+            if (!callback || disposed_) {
+                return false;
+            }
+
+            if (!InOwnerContext()) {
+                return ForwardReadAsync(forward0f(callback));
+            }
+
+            if (read_) {
+                return false;
+            }
+
+            read_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+            DeliverReads();
+            return true;
+        }
+
+        void UdpTransmission::DeliverReads() noexcept {
+            while (read_) {
+                if (reading_header_) {
+                    if (instream_size_ < 2) {
+                        return;
+                    }
+
+                    Byte header[2];
+                    PullStream(header, 2);
+                    reading_length_ = header[0] << 8 | header[1];
+                    reading_header_ = false;
+                    if (reading_length_ < 1 || reading_length_ > alignment_) {
+                        const ReadAsyncCallback read = std::move(read_);
+                        read_ = NULL;
+                        Close();
+                        read(NULL, -1);
+                        return;
+                    }
+                }
+
+                if (instream_size_ < reading_length_) {
+                    return;
+                }
+
+                std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(reading_length_);
+                PullStream(packet.get(), reading_length_);
+
+                int length = reading_length_;
+                reading_header_ = true;
+                reading_length_ = 0;
+
+                const ReadAsyncCallback read = std::move(read_);
+                read_ = NULL;
+                read(packet, length);
+            }
+        }
+
+        void UdpTransmission::PullStream(Byte* destination, int length) noexcept {
+            while (length > 0) {
+                chunk& chunks = instream_.front();
+                int size = std::min<int>(length, chunks.length_);
+                memcpy(destination, chunks.buffer_.get() + chunks.offset_, size);
+
+                destination += size;
+                length -= size;
+                instream_size_ -= size;
+                chunks.offset_ += size;
+                chunks.length_ -= size;
+                if (chunks.length_ < 1) {
+                    instream_.pop_front();
+                }
+            }
+        }
+
+        bool UdpTransmission::IsCongested() noexcept {
+            return congested_;
+        }
+
+        bool UdpTransmission::AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            if (!callback_ || disposed_) {
+                return false;
+            }
+
+            if (!congested_) {
+                return false;
+            }
+
+            if (!InOwnerContext()) { /* The drain queue is unlocked: paired shards park through the owning context. */
+                return ForwardDrainAsync(std::move(callback_));
+            }
+
+            drains_.push_back(std::move(callback_));
+            return true;
+        }
+
+        void UdpTransmission::OnResumeDrains(bool success) noexcept {
+            drain_queue drains = std::move(drains_);
+            drains_.clear();
+
+            for (WriteAsyncCallback& callback : drains) {
+                if (callback) {
+                    callback(success);
+                }
+            }
+        }
+
+        void UdpTransmission::Dispose() noexcept {
+            if (disposed_.exchange(true)) {
+                return;
+            }
+
+            if (established_ && socket_ && socket_->is_open()) {
+                TransmitControl(ERUDP_KIND_FIN); /* Best effort: the peer's timer reclaims the link regardless. */
+            }
+
+            if (ticker_) {
+                uds::threading::ClearTimeout(ticker_);
+            }
+
+            segment_queue flight = std::move(flight_);
+            segment_queue unsent = std::move(unsent_);
+            flight_.clear();
+            unsent_.clear();
+            for (segment_queue* queue : { &flight, &unsent }) {
+                for (psegment& segments : *queue) {
+                    const WriteAsyncCallback callback = std::move(segments->callback_);
+                    if (callback) {
+                        callback(false);
+                    }
+                }
+            }
+
+            const HandshakeAsyncCallback handshake = std::move(handshake_);
+            handshake_ = NULL;
+            if (handshake) {
+                handshake(false);
+            }
+
+            const ReadAsyncCallback read = std::move(read_);
+            read_ = NULL;
+            if (read) {
+                read(NULL, -1);
+            }
+
+            OnResumeDrains(false);
+            if (!binded_) { /* A listener-side socket belongs to the listener. */
+                uds::net::Socket::Closesocket(socket_);
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <uds/threading/Hosting.h>
+#include <uds/transmission/ITransmission.h>
+
+namespace uds {
+    namespace transmission {
+        /* Reliable datagram transport: frames travel in sequenced UDP segments with
+         * cumulative acks, fast retransmit on duplicate acks and an RTT-driven
+         * retransmission timer (a minimal KCP-style ARQ). Unlike the TCP-backed
+         * transmissions there is no stream transport underneath, so a lossy path
+         * costs one tunnel retransmit instead of a TCP-over-TCP meltdown. Both
+         * tunnel ends must run the udp protocol; the cipher and websocket stacks
+         * do not layer over it. */
+        class UdpTransmission final : public ITransmission {
+            friend class UdpListener;
+
+        public:
+            typedef std::shared_ptr<boost::asio::ip::udp::socket>   AsioUdpSocket;
+
+        private:
+            const int ERUDP_KIND_SYN                                = 1;
+            const int ERUDP_KIND_SYNACK                             = 2;
+            const int ERUDP_KIND_PSH                                = 3;
+            const int ERUDP_KIND_ACK                                = 4;
+            const int ERUDP_KIND_FIN                                = 5;
+            const int ERUDP_HDR                                     = 11;   /* kind(1) seq(4) ack(4) len(2). */
+            const int ERUDP_MSS                                     = 1200; /* Segment payload bytes: under any sane path MTU. */
+            const int ERUDP_WND                                     = 256;  /* Segments in flight before writes park in the queue. */
+            const int ERUDP_RCV_WND                                 = 1024; /* Out-of-order segments held ahead of the cumulative edge. */
+            const int ERUDP_TICK                                    = 20;   /* Retransmission sweep interval in milliseconds. */
+            const int ERUDP_RTO_MIN                                 = 50;
+            const int ERUDP_RTO_MAX                                 = 3000;
+            const int ERUDP_RTO_INIT                                = 300;
+            const int ERUDP_RETRIES                                 = 20;   /* Retransmissions of one segment before the link is declared dead. */
+            const int ERUDP_DUPACKS                                 = 3;    /* Duplicate acks that trigger a fast retransmit. */
+            const int ERUDP_SYN_INTERVAL                            = 300;  /* Milliseconds between client SYN retransmissions. */
+            const int ERUDP_HWM                                     = 4 * 1024 * 1024;
+            const int ERUDP_LWM                                     = 1 * 1024 * 1024;
+            struct segment {
+                uint32_t                                            seq_;
+                std::shared_ptr<Byte>                               datagram_; /* Header and payload, rewritten in place on retransmit. */
+                int                                                 length_;
+                UInt64                                              expires_;
+                UInt64                                              sent_tick_;
+                int                                                 retries_;
+                WriteAsyncCallback                                  callback_; /* Fires when the frame's last segment first hits the wire. */
+            };
+            typedef std::shared_ptr<segment>                        psegment;
+            typedef std::list<psegment>                             segment_queue;
+            struct chunk {
+                std::shared_ptr<Byte>                               buffer_;
+                int                                                 offset_;
+                int                                                 length_;
+            };
+            typedef std::list<chunk>                                chunk_queue;
+            typedef std::map<uint32_t, chunk>                       reorder_map;
+            typedef std::list<WriteAsyncCallback>                   drain_queue;
+
+        public:
+            /* The dialing end: owns a connected udp socket. */
+            UdpTransmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const boost::asio::ip::udp::endpoint& remoteEP, int alignment) noexcept;
+
+            /* The listening end: sends through the listener's shared socket. */
+            UdpTransmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const AsioUdpSocket& socket, const boost::asio::ip::udp::endpoint& remoteEP, int alignment) noexcept;
+
+        public:
+            virtual std::shared_ptr<boost::asio::io_context>        GetContext() noexcept override;
+            virtual bool                                            HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
+            virtual bool                                            ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            virtual bool                                            WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+            virtual void                                            Dispose() noexcept override;
+            virtual uds::net::IPEndPoint                            GetLocalEndPoint() noexcept override;
+            virtual uds::net::IPEndPoint                            GetRemoteEndPoint() noexcept override;
+            virtual bool                                            IsCongested() noexcept override;
+            virtual bool                                            AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+
+        public:
+            inline bool                                             Available() noexcept {
+                return !disposed_;
+            }
+
+        private:
+            void                                                    OnInput(const Byte* datagram, int length) noexcept;
+            void                                                    OnAcknowledge(uint32_t ack) noexcept;
+            void                                                    OnPush(uint32_t seq, const Byte* payload, int length) noexcept;
+            void                                                    OnTickEvent() noexcept;
+
+        private:
+            bool                                                    NextTickCycle() noexcept;
+            bool                                                    ForwardLoopback() noexcept;
+            void                                                    TransmitPending() noexcept;
+            void                                                    TransmitSegment(const psegment& segments) noexcept;
+            void                                                    TransmitControl(Byte kind) noexcept;
+            void                                                    TransmitDatagram(const std::shared_ptr<Byte>& datagram, int length) noexcept;
+            void                                                    DeliverReads() noexcept;
+            void                                                    PullStream(Byte* destination, int length) noexcept;
+            void                                                    OnResumeDrains(bool success) noexcept;
+
+        private:
+            std::atomic<bool>                                       disposed_;
+            std::shared_ptr<uds::threading::Hosting>                hosting_;
+            std::shared_ptr<boost::asio::io_context>                context_;
+            AsioUdpSocket                                           socket_;
+            bool                                                    binded_;      /* True when the socket belongs to a listener. */
+            bool                                                    established_;
+            boost::asio::ip::udp::endpoint                          remoteEP_;
+            int                                                     alignment_;
+            std::shared_ptr<boost::asio::deadline_timer>            ticker_;
+            HandshakeAsyncCallback                                  handshake_;
+            UInt64                                                  syn_tick_;
+            uint32_t                                                snd_nxt_;
+            int                                                     srtt_;
+            int                                                     rto_;
+            uint32_t                                                last_ack_;
+            int                                                     dupacks_;
+            segment_queue                                           flight_;      /* Sent, awaiting the cumulative ack. */
+            segment_queue                                           unsent_;      /* Sequenced, parked behind the window. */
+            uint32_t                                                rcv_nxt_;
+            reorder_map                                             reorder_;
+            chunk_queue                                             instream_;    /* In-order bytes not yet consumed by a frame read. */
+            int                                                     instream_size_;
+            bool                                                    reading_header_;
+            int                                                     reading_length_;
+            ReadAsyncCallback                                       read_;
+            std::shared_ptr<Byte>                                   rbuffer_;
+            std::atomic<int>                                        queued_;      /* Unacked plus parked payload bytes. */
+            std::atomic<bool>                                       congested_;
+            drain_queue                                             drains_;
+        };
+    }
+}
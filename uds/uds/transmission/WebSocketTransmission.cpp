@@ -12,12 +12,17 @@ namespace uds {
             const std::shared_ptr<boost::asio::ip::tcp::socket>&    socket,
             const std::string&                                      host,
             const std::string&                                      path,
+            bool                                                    compression,
+            int                                                     compression_threshold,
             int                                                     alignment) noexcept
             : Transmission(hosting, context, socket, alignment)
             , disposed_(false)
             , host_(host)
             , path_(path)
-            , websocket_(std::move(*socket)) {
+            , compression_(compression)
+            , compression_threshold_(compression_threshold)
+            , websocket_(std::move(*socket))
+            , reader_(websocket_) {
 
         }
 
@@ -28,8 +33,8 @@ namespace uds {
 
             class AcceptWebSocket final : public uds::transmission::templates::WebSocket<AsioWebSocket> {
             public:
-                inline AcceptWebSocket(const std::shared_ptr<WebSocketTransmission>& transmission, AsioWebSocket& websocket, std::string& host, std::string& path) noexcept
-                    : WebSocket(websocket, host, path)
+                inline AcceptWebSocket(const std::shared_ptr<WebSocketTransmission>& transmission, AsioWebSocket& websocket, std::string& host, std::string& path, bool compression, int compression_threshold) noexcept
+                    : WebSocket(websocket, host, path, compression, compression_threshold)
                     , transmission_(transmission) {
 
                 }
@@ -60,7 +65,7 @@ namespace uds {
 
             std::shared_ptr<WebSocketTransmission> transmission = Reference::CastReference<WebSocketTransmission>(GetReference());
             std::shared_ptr<AcceptWebSocket> accept =
-                Reference::NewReference<AcceptWebSocket>(transmission, websocket_, host_, path_);
+                Reference::NewReference<AcceptWebSocket>(transmission, websocket_, host_, path_, compression_, compression_threshold_);
             return accept->HandshakeAsync(type, forward0f(callback));
         }
 
@@ -182,17 +187,14 @@ namespace uds {
             const std::shared_ptr<ITransmission> reference = GetReference();
             const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
 
-            websocket_.async_write(boost::asio::buffer(messages->packet.get(), messages->packet_size),
+            websocket_.async_write(ToBuffers(messages),
                 [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
                     bool success = ec ? false :true;
                     if (!success) {
                         Close();
                     }
 
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
+                    OnWriteCompleted(messages, success);
                     OnAsyncWrite(true);
                 });
             return true;
@@ -203,7 +205,10 @@ namespace uds {
                 return false;
             }
 
-            return Transmission::Unpack(websocket_, forward0f(callback));
+            if (!InOwnerContext()) {
+                return ForwardReadAsync(forward0f(callback));
+            }
+            return Transmission::Unpack(reader_, forward0f(callback));
         }
 
         void WebSocketTransmission::Dispose() noexcept {
@@ -221,7 +226,11 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
+            if (!InOwnerContext()) { /* Paired shards enter through the owning context: the pending chain is unlocked. */
+                return ForwardWriteAsync(buffer, offset, length, forward0f(callback));
+            }
+
+            pmessage messages = Pack(buffer, offset, length, forward0f(callback));
             if (!messages) {
                 return false;
             }
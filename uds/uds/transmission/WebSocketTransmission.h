@@ -1,12 +1,14 @@
 #pragma once
 
 #include <uds/transmission/Transmission.h>
+#include <uds/transmission/templates/WebSocket.hpp>
 
 namespace uds {
     namespace transmission {
-        class WebSocketTransmission : public Transmission {
+        class WebSocketTransmission final : public Transmission {
             typedef boost::asio::ip::tcp::socket                        AsioTcpSocket;
             typedef boost::beast::websocket::stream<AsioTcpSocket>      AsioWebSocket;
+            typedef templates::WebSocketReadStream<AsioWebSocket>       AsioWebSocketReadStream;
 
         public:
             WebSocketTransmission(
@@ -15,10 +17,15 @@ namespace uds {
                 const std::shared_ptr<boost::asio::ip::tcp::socket>&    socket,
                 const std::string&                                      host,
                 const std::string&                                      path,
+                bool                                                    compression,
+                int                                                     compression_threshold,
                 int                                                     alignment) noexcept;
         
         public:
             virtual void                                                Dispose() noexcept override;
+            virtual std::shared_ptr<boost::asio::ip::tcp::socket>      GetUnderlyingSocket() noexcept override {
+                return NULL;
+            }
             virtual bool                                                HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
@@ -39,7 +46,10 @@ namespace uds {
             std::atomic<bool>                                           disposed_;
             std::string                                                 host_;
             std::string                                                 path_;
+            bool                                                        compression_;
+            int                                                         compression_threshold_;
             AsioWebSocket                                               websocket_;
+            AsioWebSocketReadStream                                     reader_;
         };
     }
 }
\ No newline at end of file
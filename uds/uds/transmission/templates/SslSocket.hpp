@@ -85,7 +85,32 @@ namespace uds {
                         }
                     }
 
-                    return PerformSslHandshakeAsync(type, forward0f(callback));
+                    // Resume from the per-host session cache when a ticket is on hand.
+                    if (type == HandshakeType::HandshakeType_Client) {
+                        uds::ssl::SSL::SetSslSession(GetSslHandle(), host_);
+                    }
+
+                    // Kernel TLS wants the opt-in on the handle before the handshake.
+                    uds::ssl::SSL::EnableKernelTls(GetSslHandle());
+
+                    // A reconnect storm queues behind the per-thread handshake gate
+                    // instead of monopolizing the event loop that live channels share.
+                    const std::shared_ptr<Reference> reference_ = GetReference();
+                    const HandshakeType type_ = type;
+                    const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+                    uds::ssl::SSL::BeginSslHandshake(
+                        [reference_, this, type_, callback_]() noexcept {
+                            bool success = PerformSslHandshakeAsync(type_,
+                                (HandshakeAsyncCallback)[callback_](bool success) noexcept {
+                                    uds::ssl::SSL::EndSslHandshake();
+                                    callback_(success);
+                                });
+                            if (!success) {
+                                uds::ssl::SSL::EndSslHandshake();
+                                callback_(false);
+                            }
+                        });
+                    return true;
                 }
 
             protected:
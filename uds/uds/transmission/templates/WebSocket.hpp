@@ -20,11 +20,28 @@ namespace uds {
                 inline WebSocket(
                     T&                                              websocket,
                     std::string&                                    host,
-                    std::string&                                    path) noexcept 
+                    std::string&                                    path,
+                    bool                                            compression,
+                    int                                             compression_threshold) noexcept
                     : host_(host)
                     , path_(path)
                     , websocket_(websocket) {
                     websocket_.binary(true);
+
+                    /* RFC 7692 permessage-deflate is offered by the client and accepted by
+                     * the server only when both roles were configured with it; a peer that
+                     * never negotiates the extension keeps talking plain framed binary. */
+                    if (compression) {
+                        boost::beast::websocket::permessage_deflate deflate;
+                        deflate.client_enable = true;
+                        deflate.server_enable = true;
+#if BOOST_VERSION >= 107800
+                        deflate.msg_size_threshold = compression_threshold; /* Older beast deflates every message once negotiated. */
+#else
+                        (void)compression_threshold;
+#endif
+                        websocket_.set_option(deflate);
+                    }
                 }
 
             protected:
@@ -190,6 +207,55 @@ namespace uds {
                 std::string&                                        path_;
                 T&                                                  websocket_;
             };
+
+            /* AsyncReadStream shim over a beast websocket stream: with permessage-deflate
+             * negotiated, read_some completes with zero bytes at every message boundary,
+             * which a composed boost::asio::async_read mistakes for end of stream. The
+             * shim re-issues those boundary completions so Transmission::Unpack keeps
+             * seeing one contiguous byte stream. */
+            template<class T>
+            class WebSocketReadStream {
+            public:
+                typedef typename T::executor_type                   executor_type;
+
+                inline WebSocketReadStream(T& websocket) noexcept
+                    : websocket_(websocket) {
+
+                }
+
+                inline executor_type                                get_executor() noexcept {
+                    return websocket_.get_executor();
+                }
+
+                template<class MutableBufferSequence, class ReadHandler>
+                inline void                                         async_read_some(const MutableBufferSequence& buffers, BOOST_ASIO_MOVE_ARG(ReadHandler) handler) noexcept {
+                    typedef ReadSomeOp<MutableBufferSequence, typename std::decay<ReadHandler>::type> Op;
+
+                    Op op = { websocket_, buffers, BOOST_ASIO_MOVE_CAST(ReadHandler)(constantof(handler)) };
+                    websocket_.async_read_some(buffers, BOOST_ASIO_MOVE_CAST(Op)(op));
+                }
+
+            private:
+                template<class MutableBufferSequence, class ReadHandler>
+                struct ReadSomeOp {
+                    T&                                              websocket_;
+                    MutableBufferSequence                           buffers_;
+                    ReadHandler                                     handler_;
+
+                    inline void                                     operator()(const boost::system::error_code& ec, std::size_t sz) noexcept {
+                        if (!ec && sz == 0 && boost::asio::buffer_size(buffers_) > 0) {
+                            T& websocket = websocket_;
+                            MutableBufferSequence buffers = buffers_;
+                            websocket.async_read_some(buffers, BOOST_ASIO_MOVE_CAST(ReadSomeOp)(*this)); /* A deflate message boundary, not EOF. */
+                            return;
+                        }
+                        handler_(ec, sz);
+                    }
+                };
+
+            private:
+                T&                                                  websocket_;
+            };
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include <uds/threading/BufferslabPool.h>
+#include <uds/tunnel/Bond.h>
+
+namespace uds {
+    namespace tunnel {
+        Bond::Bond(const std::vector<ITransmissionPtr>& transmissions, int alignment) noexcept
+            : disposed_(false)
+            , pumping_(false)
+            , rseq_(0)
+            , wseq_(0)
+            , windex_(0)
+            , transmissions_(transmissions) {
+            if (alignment >= (UINT8_MAX << 1) && alignment <= uds::threading::Hosting::BufferSize) {
+                constantof(EBOND_MSS) = alignment - EBOND_TSS;
+            }
+
+            std::size_t size = transmissions_.size();
+            buffered_.resize(size, 0);
+            paused_.resize(size, false);
+        }
+
+        void Bond::Dispose() noexcept {
+            if (!disposed_.exchange(true)) {
+                std::vector<ITransmissionPtr> transmissions;
+                ReadAsyncCallback reading; {
+                    MutexScope scope(syncobj_);
+                    transmissions = std::move(transmissions_);
+                    transmissions_.clear();
+                    frames_.clear();
+
+                    reading = std::move(reading_);
+                    reading_ = NULL;
+                }
+
+                if (reading) {
+                    reading(NULL, -1);
+                }
+
+                for (std::size_t i = 0, len = transmissions.size(); i < len; i++) {
+                    const ITransmissionPtr& transmission = transmissions[i];
+                    if (transmission) {
+                        transmission->Close();
+                    }
+                }
+            }
+        }
+
+        bool Bond::HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
+            if (!callback || disposed_) {
+                return false;
+            }
+
+            /* Every member transmission already handshaked before it was bonded. */
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+            boost::asio::post(*context,
+                [reference_, callback_]() noexcept {
+                    callback_(true);
+                });
+            return true;
+        }
+
+        bool Bond::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
+            if (!callback || disposed_) {
+                return false;
+            }
+
+            frame messages;
+            bool delivery = false;
+            bool pumping = false;
+            bool resume = false; {
+                MutexScope scope(syncobj_);
+                if (reading_) {
+                    return false;
+                }
+
+                frame_table::iterator tail = frames_.find(rseq_);
+                if (tail == frames_.end()) {
+                    if (!pumping_) {
+                        pumping_ = true;
+                        pumping = true;
+                    }
+                    reading_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+                }
+                else {
+                    messages = std::move(tail->second);
+                    frames_.erase(tail);
+                    rseq_++;
+                    delivery = true;
+
+                    int index = messages.index;
+                    if (--buffered_[index] < EBOND_WND && paused_[index]) {
+                        paused_[index] = false;
+                        resume = true;
+                    }
+                }
+            }
+
+            if (pumping) {
+                for (std::size_t i = 0, len = transmissions_.size(); i < len; i++) {
+                    if (!ReadCycle((int)i)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            if (!delivery) {
+                return true;
+            }
+
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+            const std::shared_ptr<Byte> packet = messages.packet;
+            const int packet_size = messages.packet_size;
+            boost::asio::post(*context,
+                [reference_, callback_, packet, packet_size]() noexcept {
+                    callback_(packet, packet_size);
+                });
+            return resume ? ReadCycle(messages.index) : true;
+        }
+
+        bool Bond::WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (!buffer || offset < 0 || length < 1) {
+                return false;
+            }
+
+            if (disposed_) {
+                return false;
+            }
+
+            /* The lock spans sequence assignment and member submission together so
+             * frames enter each member queue in sequence order. */
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            MutexScope scope(syncobj_);
+
+            std::size_t size = transmissions_.size();
+            if (!size) {
+                return false;
+            }
+
+            for (int i = 0; i < length; i += EBOND_MSS) { /* An oversize payload is framed as a run of sequenced chunks. */
+                int chunk = std::min<int>(EBOND_MSS, length - i);
+                bool endl = (i + chunk) >= length;
+
+                int packet_size = EBOND_TSS + chunk;
+                std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(packet_size);
+                if (!packet) {
+                    return false;
+                }
+
+                UInt32 seq = wseq_++;
+                Byte* p = packet.get();
+                p[0] = (Byte)(seq >> 24);
+                p[1] = (Byte)(seq >> 16);
+                p[2] = (Byte)(seq >> 8);
+                p[3] = (Byte)(seq);
+                memcpy(p + EBOND_TSS, buffer.get() + offset + i, chunk);
+
+                const ITransmissionPtr& transmission = transmissions_[windex_++ % size];
+                if (!transmission) {
+                    return false;
+                }
+
+                if (!transmission->WriteAsync(packet, 0, packet_size, endl ? WriteAsyncCallback(callback_) : (WriteAsyncCallback)NULL)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool Bond::ReadCycle(int index) noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            ITransmissionPtr transmission; {
+                MutexScope scope(syncobj_);
+                if (index < 0 || index >= (int)transmissions_.size()) {
+                    return false;
+                }
+                transmission = transmissions_[index];
+            }
+
+            if (!transmission) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            return transmission->ReadAsync(
+                [reference_, this, index](const std::shared_ptr<Byte>& buffers, int length) noexcept {
+                    if (length < 1 || !OnFrame(index, buffers, length)) {
+                        Close();
+                    }
+                });
+        }
+
+        bool Bond::OnFrame(int index, const std::shared_ptr<Byte>& buffer, int length) noexcept {
+            if (!buffer || length <= EBOND_TSS) {
+                return false;
+            }
+
+            Byte* packet = buffer.get();
+            UInt32 seq = (UInt32)(packet[0] << 24 | packet[1] << 16 | packet[2] << 8 | packet[3]);
+
+            ReadAsyncCallback reading;
+            bool paused = false; {
+                MutexScope scope(syncobj_);
+                if (seq == rseq_ && reading_) {
+                    reading = std::move(reading_);
+                    reading_ = NULL;
+                    rseq_++;
+                }
+                else {
+                    frame messages;
+                    messages.packet = uds::threading::BufferslabPool::Alloc(length - EBOND_TSS);
+                    messages.packet_size = length - EBOND_TSS;
+                    messages.index = index;
+                    if (!messages.packet) {
+                        return false;
+                    }
+
+                    memcpy(messages.packet.get(), packet + EBOND_TSS, messages.packet_size);
+                    frames_[seq] = std::move(messages);
+
+                    if (++buffered_[index] >= EBOND_WND) { /* A member too far ahead of the delivery sequence pauses;
+                                                            * the member carrying the next expected frame never is. */
+                        paused_[index] = true;
+                        paused = true;
+                    }
+                }
+            }
+
+            if (reading) {
+                /* The member reuses its receive buffer between reads and the relay
+                 * copies synchronously, so an aliased pointer avoids the slab copy. */
+                std::shared_ptr<Byte> messages(buffer, packet + EBOND_TSS);
+                reading(messages, length - EBOND_TSS);
+            }
+            return paused ? true : ReadCycle(index);
+        }
+
+        Bond::AsyncContextPtr Bond::GetContext() noexcept {
+            MutexScope scope(syncobj_);
+            for (std::size_t i = 0, len = transmissions_.size(); i < len; i++) {
+                const ITransmissionPtr& transmission = transmissions_[i];
+                if (transmission) {
+                    return transmission->GetContext();
+                }
+            }
+            return NULL;
+        }
+
+        uds::net::IPEndPoint Bond::GetLocalEndPoint() noexcept {
+            MutexScope scope(syncobj_);
+            for (std::size_t i = 0, len = transmissions_.size(); i < len; i++) {
+                const ITransmissionPtr& transmission = transmissions_[i];
+                if (transmission) {
+                    return transmission->GetLocalEndPoint();
+                }
+            }
+            return uds::net::IPEndPoint();
+        }
+
+        uds::net::IPEndPoint Bond::GetRemoteEndPoint() noexcept {
+            MutexScope scope(syncobj_);
+            for (std::size_t i = 0, len = transmissions_.size(); i < len; i++) {
+                const ITransmissionPtr& transmission = transmissions_[i];
+                if (transmission) {
+                    return transmission->GetRemoteEndPoint();
+                }
+            }
+            return uds::net::IPEndPoint();
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <uds/threading/Hosting.h>
+#include <uds/transmission/ITransmission.h>
+
+namespace uds {
+    namespace tunnel {
+        /* Stripes one logical byte stream across several established transmissions:
+         * every frame carries a big-endian sequence number and members are fed round
+         * robin, so a single bulk channel aggregates the bandwidth of every path
+         * underneath it. The peer reorders by sequence before delivery, which makes
+         * the member that produced a frame irrelevant to correctness. */
+        class Bond final : public uds::transmission::ITransmission {
+        public:
+            using ITransmission                 = uds::transmission::ITransmission;
+            using ITransmissionPtr              = std::shared_ptr<ITransmission>;
+            using AsyncContextPtr               = std::shared_ptr<boost::asio::io_context>;
+
+        public:
+            const int                           EBOND_TSS = 4; /* Big-endian frame sequence number ahead of every payload. */
+            const int                           EBOND_MSS = uds::threading::Hosting::BufferSize - 4;
+            const int                           EBOND_WND = 16;
+
+        public:
+            Bond(const std::vector<ITransmissionPtr>& transmissions, int alignment) noexcept;
+
+        public:
+            virtual void                        Dispose() noexcept override;
+            virtual bool                        HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
+            virtual bool                        ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            virtual bool                        WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+
+        public:
+            virtual AsyncContextPtr             GetContext() noexcept override;
+            virtual uds::net::IPEndPoint        GetLocalEndPoint() noexcept override;
+            virtual uds::net::IPEndPoint        GetRemoteEndPoint() noexcept override;
+
+        private:
+            struct frame {
+                std::shared_ptr<Byte>           packet;
+                int                             packet_size;
+                int                             index;
+            };
+            using frame_table                   = std::unordered_map<UInt32, frame>;
+            using Mutex                         = std::mutex;
+            using MutexScope                    = std::lock_guard<Mutex>;
+
+        private:
+            bool                                ReadCycle(int index) noexcept;
+            bool                                OnFrame(int index, const std::shared_ptr<Byte>& buffer, int length) noexcept;
+
+        private:
+            std::atomic<bool>                   disposed_;
+            bool                                pumping_; /* Member read cycles spin up on the first read. */
+            UInt32                              rseq_;
+            UInt32                              wseq_;
+            UInt32                              windex_;
+            Mutex                               syncobj_;
+            std::vector<ITransmissionPtr>       transmissions_;
+            std::vector<int>                    buffered_; /* Frames parked per member, ahead of the delivery sequence. */
+            std::vector<bool>                   paused_;
+            frame_table                         frames_;
+            ReadAsyncCallback                   reading_;
+        };
+    }
+}
@@ -1,32 +1,247 @@
+#include <uds/Tracepoints.h>
 #include <uds/threading/Timer.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/threading/Statistics.h>
+#include <uds/threading/Logger.h>
 #include <uds/net/Ipep.h>
 #include <uds/tunnel/Connection.h>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace uds {
     namespace tunnel {
+#if defined(__linux__)
+        /* Kernel relay for plaintext channels: bytes move src -> pipe -> dst through
+         * splice() and never surface into userspace buffers. */
+        class Connection::Splicer final : public IDisposable {
+            static const int ESPLICER_CHUNK = 65536;
+
+        public:
+            Splicer(const std::shared_ptr<Reference>& owner, Connection* connection, const AsyncTcpSocketPtr& src, const AsyncTcpSocketPtr& dst) noexcept
+                : disposed_(false)
+                , owner_(owner)
+                , connection_(connection)
+                , src_(src)
+                , dst_(dst)
+                , buffered_(0) {
+                pipe_[0] = -1;
+                pipe_[1] = -1;
+            }
+            virtual ~Splicer() noexcept {
+                ClosePipe();
+            }
+
+        public:
+            bool                                Open() noexcept {
+                return pipe2(pipe_, O_NONBLOCK | O_CLOEXEC) == 0;
+            }
+            bool                                Run() noexcept {
+                return Loopback();
+            }
+            virtual void                        Dispose() noexcept override {
+                if (!disposed_.exchange(true)) {
+                    ClosePipe();
+                    connection_->Close();
+                }
+            }
+
+        private:
+            void                                ClosePipe() noexcept {
+                for (int i = 0; i < 2; i++) {
+                    int fd = pipe_[i];
+                    pipe_[i] = -1;
+
+                    if (fd != -1) {
+                        ::close(fd);
+                    }
+                }
+            }
+            bool                                Loopback() noexcept {
+                while (!disposed_) {
+                    if (buffered_ > 0) { /* Drain the pipe before pulling anything else off the source. */
+                        ssize_t sz = splice(pipe_[0], NULL, dst_->native_handle(), NULL, buffered_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                        if (sz > 0) {
+                            buffered_ -= sz;
+                            continue;
+                        }
+                        elif(sz < 0 && errno == EAGAIN) {
+                            return Wait(dst_, AsyncTcpSocket::wait_write);
+                        }
+                        return false;
+                    }
+
+                    ssize_t sz = splice(src_->native_handle(), NULL, pipe_[1], NULL, ESPLICER_CHUNK, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                    if (sz > 0) {
+                        buffered_ += sz;
+                        continue;
+                    }
+                    elif(sz < 0 && errno == EAGAIN) {
+                        return Wait(src_, AsyncTcpSocket::wait_read);
+                    }
+                    return false; /* EOF or a hard socket error. */
+                }
+                return false;
+            }
+            bool                                Wait(const AsyncTcpSocketPtr& socket, AsyncTcpSocket::wait_type what) noexcept {
+                const std::shared_ptr<Reference> references = GetReference();
+                socket->async_wait(what,
+                    [references, this](const boost::system::error_code& ec) noexcept {
+                        if (ec || !Loopback()) {
+                            Dispose();
+                        }
+                    });
+                return true;
+            }
+
+        private:
+            std::atomic<bool>                   disposed_;
+            std::shared_ptr<Reference>          owner_;
+            Connection*                         connection_;
+            AsyncTcpSocketPtr                   src_;
+            AsyncTcpSocketPtr                   dst_;
+            int                                 pipe_[2];
+            int                                 buffered_;
+        };
+#endif
+
+        bool Connection::FastHandshake = false;
+
+        /* The binary handshake leads with a byte the plaintext codec can never emit
+         * (its padding is strictly alphanumeric), so one octet tells the codecs apart. */
+        static const Byte EHANDSHAKE_BINARY_MAGIC   = 0x16;
+        static const Byte EHANDSHAKE_BINARY_VERSION = 0x02;
+        static const int  EHANDSHAKE_BINARY_HEADERS = 8;
+
+        /* Resume extensions to the binary frame: 0x03 joins with a token minted by
+         * the client, 0x04 carries a token plus the sender's received byte count -
+         * as the join it takes over a detached channel, as the reply it acknowledges. */
+        static const Byte EHANDSHAKE_TOKEN_VERSION  = 0x03;
+        static const Byte EHANDSHAKE_RESUME_VERSION = 0x04;
+        static const int  EHANDSHAKE_TOKEN_HEADERS  = 16;
+        static const int  EHANDSHAKE_RESUME_HEADERS = 24;
+
+        static const int  ERESUME_BUFFER_LIMIT      = 2 * 1024 * 1024;
+        static const int  ERESUME_TIMEOUT           = 10 * 1000;
+        static const int  ECONNECT_STAGGER          = 250; /* RFC 8305: head start in milliseconds before the next candidate dials. */
+
+        /* Sender-side retention for resumable channels: every frame written into the
+         * tunnel stays in the ring until the peer acknowledges it at reattach time.
+         * Acknowledgements only arrive with a resume, so a channel that has pushed
+         * more than the cap forfeits resumability and frees its backlog at once. */
+        class Connection::ReplayRing final {
+        public:
+            using Frame                     = std::pair<std::shared_ptr<Byte>, int>;
+            using FrameList                 = std::list<Frame>;
+
+        public:
+            ReplayRing(int limit) noexcept
+                : limit_(limit)
+                , overflowed_(false)
+                , buffered_(0)
+                , acked_(0) {}
+
+        public:
+            bool                            Push(const std::shared_ptr<Byte>& buffer, int length) noexcept {
+                if (overflowed_) {
+                    return false;
+                }
+
+                if (buffered_ + length > limit_) {
+                    Overflow();
+                    return false;
+                }
+
+                buffered_ += length;
+                frames_.push_back(std::make_pair(buffer, length));
+                return true;
+            }
+            bool                            Ack(UInt64 received) noexcept {
+                if (overflowed_ || received < acked_ || received > acked_ + buffered_) {
+                    return false;
+                }
+
+                while (!frames_.empty()) {
+                    const Frame& frame = frames_.front();
+                    UInt64 next = acked_ + (UInt64)frame.second;
+                    if (next > received) {
+                        break;
+                    }
+
+                    acked_ = next;
+                    buffered_ -= frame.second;
+                    frames_.pop_front();
+                }
+
+                /* Frames are atomic over a transmission: an acknowledgement landing
+                 * inside one means the peers no longer agree on the stream. */
+                return acked_ == received;
+            }
+            inline bool                     Overflowed() noexcept {
+                return overflowed_;
+            }
+            inline void                     Overflow() noexcept { /* Give up on resumability: the backlog can no longer be replayed faithfully. */
+                overflowed_ = true;
+                buffered_ = 0;
+                frames_.clear();
+            }
+            inline FrameList&               Frames() noexcept {
+                return frames_;
+            }
+
+        private:
+            int                             limit_;
+            bool                            overflowed_;
+            int                             buffered_;
+            UInt64                          acked_; /* Bytes the peer has confirmed and the ring has trimmed. */
+            FrameList                       frames_;
+        };
+
         Connection::Connection(const AppConfigurationPtr& configuration, int id, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept
             : Id(id)
             , disposed_(false)
             , available_(false)
             , configuration_(configuration)
             , inbound_(inbound)
-            , outbound_(outbound) {
+            , outbound_(outbound)
+            , listened_(false)
+            , hello_(false)
+            , token_(0)
+            , detached_(false)
+            , active_(0)
+            , remote_reading_(false)
+            , inbound_reading_(false)
+            , remote_inflight_(0)
+            , outbound_inflight_(0)
+            , rx_bytes_(0)
+            , rx_frames_(0)
+            , tx_bytes_(0)
+            , tx_frames_(0) {
             if (configuration) {
                 int alignment = configuration->Alignment;
                 if (alignment >= (UINT8_MAX << 1) && alignment <= ECONNECTION_MSS) {
                     constantof(ECONNECTION_MSS) = alignment;
                 }
+
+                int window = configuration->Window;
+                if (window >= 1 && window <= 64) {
+                    constantof(ECONNECTION_WND) = window;
+                }
             }
         }
 
         bool Connection::Listen(const AsyncTcpSocketPtr& network) noexcept {
             typedef uds::net::Ipep Ipep;
 
-            if (disposed_ || buffers_) {
+            if (disposed_ || listened_) {
                 return false;
             }
 
-            buffers_ = make_shared_alloc<Byte>(ECONNECTION_MSS);
+            listened_ = true;
+            UDS_TRACE1(channel_open, Id);
+            uds::threading::Logger::Write(uds::threading::Logger::LogEvent_ChannelOpen, Id, 0);
             if (network) {
                 remote_ = network;
                 available_ = EstablishRemoteSocket();
@@ -44,14 +259,12 @@ namespace uds {
                 }
                 elif(configuration_->Domain) {
                     const std::shared_ptr<Reference> references = GetReference();
-                    Ipep::GetAddressByHostName(resolver_, configuration_->IP, configuration_->Port,
-                        make_shared_object<Ipep::GetAddressByHostNameCallback>(
-                            [references, this](IPEndPoint* ep) noexcept {
-                                boost::asio::ip::tcp::endpoint remoteEP;
-                                if (ep) {
-                                    remoteEP = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(*ep);
+                    Ipep::GetAddressesByHostName(resolver_, configuration_->IP, configuration_->Port,
+                        make_shared_object<Ipep::GetAddressesByHostNameCallback>(
+                            [references, this](std::vector<IPEndPoint>& addresses) noexcept {
+                                if (!ConnectRemoteSockets(addresses)) {
+                                    Close();
                                 }
-                                ConnectRemoteSocket(remoteEP);
                             }));
                     return true;
                 }
@@ -62,8 +275,230 @@ namespace uds {
             }
         }
 
+        bool Connection::DeferHello() noexcept {
+            if (disposed_ || listened_) {
+                return false;
+            }
+
+            hello_ = true;
+            return true;
+        }
+
+        UInt64 Connection::NewResumeToken() noexcept {
+            return (UInt64)RandomNext(1, INT_MAX) << 32 | (UInt32)RandomNext(1, INT_MAX);
+        }
+
+        bool Connection::SetResumable(UInt64 token) noexcept {
+            if (disposed_ || listened_ || !token) {
+                return false;
+            }
+
+            const std::shared_ptr<ReplayRing> ring = make_shared_object<ReplayRing>(ERESUME_BUFFER_LIMIT);
+            if (!ring) {
+                return false;
+            }
+
+            token_ = token;
+            replays_ = ring;
+            return true;
+        }
+
+        bool Connection::RetainToReplay(const std::shared_ptr<Byte>& buffer, int length) noexcept {
+            const std::shared_ptr<ReplayRing> ring = replays_;
+            if (!token_ || !ring) {
+                return false;
+            }
+
+            /* The outbound transport may transform the frame in place (stream
+             * ciphers encrypt the caller buffer before it hits the wire), so the
+             * ring keeps its own copy: sharing the buffer would retain ciphertext
+             * that a reattached pair's fresh cipher then encrypts a second time. */
+            const std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(length);
+            if (!packet) {
+                ring->Overflow(); /* A hole in the backlog cannot be replayed: fall back to plain teardown on a flap. */
+                return false;
+            }
+
+            memcpy(packet.get(), buffer.get(), length);
+            return ring->Push(packet, length);
+        }
+
+        bool Connection::Detach() noexcept {
+            if (disposed_ || !token_) {
+                return false;
+            }
+            elif(detached_) { /* Both halves of a dead pair report the same flap. */
+                return true;
+            }
+
+            const std::shared_ptr<ReplayRing> ring = replays_;
+            if (!ring || ring->Overflowed()) { /* The backlog outgrew the ring: nothing left to replay from. */
+                return false;
+            }
+
+            detached_ = true;
+            inbound_reading_ = false;
+            outbound_inflight_ = 0;
+
+            const AsyncContextPtr context = GetContext(); /* Taken before the pair is torn out of the members. */
+            const ITransmissionPtr inbound = std::move(inbound_);
+            inbound_.reset();
+            if (inbound) {
+                inbound->Close();
+            }
+
+            const ITransmissionPtr outbound = std::move(outbound_);
+            outbound_.reset();
+            if (outbound) {
+                outbound->Close();
+            }
+
+            /* The remote socket stays open behind the flap, but not forever: the
+             * wheel reclaims the channel if no replacement pair arrives in time. */
+            const std::shared_ptr<TimingWheel> wheel = TimingWheel::GetDefault();
+            if (wheel && context) {
+                const std::shared_ptr<Reference> references = GetReference();
+                TimingWheel::ClearTimeout(resume_);
+                resume_ = wheel->SetTimeout(
+                    [references, this, context](void*) noexcept {
+                        /* The wheel fires on its hosting tick thread: the teardown
+                         * walks unlocked connection state, so it hops to the owning
+                         * context first, like every other completion. */
+                        boost::asio::post(*context,
+                            [references, this]() noexcept {
+                                if (detached_) {
+                                    Close();
+                                }
+                            });
+                    }, ERESUME_TIMEOUT);
+            }
+
+            const ResumeEventHandler resumeEvent = ResumeEvent;
+            if (resumeEvent && !resumeEvent(this)) { /* The owner could not start a redial: tear down as before. */
+                return false;
+            }
+            return true;
+        }
+
+        bool Connection::Reattach(const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, UInt64 received, bool acknowledge) noexcept {
+            if (disposed_ || !token_ || !inbound || !outbound) {
+                return false;
+            }
+
+            const std::shared_ptr<ReplayRing> ring = replays_;
+            if (!ring || !ring->Ack(received)) { /* Overflowed or a gap: the peers no longer agree on the stream. */
+                return false;
+            }
+
+            /* The peer can observe the flap first: reattaching straight from the
+             * attached state supersedes the old pair, whose stale completions the
+             * relay filters by transmission identity. */
+            const ITransmissionPtr sinbound = std::move(inbound_);
+            if (sinbound) {
+                sinbound->Close();
+            }
+
+            const ITransmissionPtr soutbound = std::move(outbound_);
+            if (soutbound) {
+                soutbound->Close();
+            }
+
+            inbound_ = inbound;
+            outbound_ = outbound;
+            detached_ = false;
+            inbound_reading_ = false;
+            outbound_inflight_ = 0;
+            TimingWheel::ClearTimeout(resume_);
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const ITransmissionPtr socket = outbound;
+
+            /* The acknowledging side reports its own received count first: the
+             * frame is queued ahead of the replay, so the peer trims its ring
+             * before any replayed payload lands. */
+            if (acknowledge) {
+                if (!ConnectResumeAsync(socket, std::max<int>(configuration_->Alignment, UINT8_MAX << 1), Id, token_, rx_bytes_.load(std::memory_order_relaxed),
+                    [references, this, socket](bool success, int) noexcept {
+                        if (socket != outbound_) {
+                            return;
+                        }
+
+                        if (!success) {
+                            if (!Detach()) {
+                                Close();
+                            }
+                        }
+                    })) {
+                    Close();
+                    return false;
+                }
+            }
+
+            /* Replay the unacknowledged backlog in order; the frames stay in the
+             * ring until the next reattach acknowledges them. */
+            ReplayRing::FrameList& frames = ring->Frames();
+            for (ReplayRing::FrameList::iterator i = frames.begin(); i != frames.end(); ++i) {
+                outbound_inflight_++;
+                if (!socket->WriteAsync(i->first, 0, i->second,
+                    [references, this, socket](bool success) noexcept {
+                        if (socket != outbound_) {
+                            return;
+                        }
+
+                        outbound_inflight_--;
+                        if (!success) {
+                            if (!Detach()) {
+                                Close();
+                            }
+                        }
+                        elif(!RemoteSocketToOutboundSocket()) {
+                            Close();
+                        }
+                    })) {
+                    Close();
+                    return false;
+                }
+            }
+
+            bool available = RemoteSocketToOutboundSocket() && InboundSocketToRemoteSocket();
+            if (available) {
+                if (configuration_->KeepAlived) {
+                    available = KeepAlivedReadCycle(outbound_) && KeepAlivedSendCycle(inbound_);
+                }
+            }
+
+            if (!available) {
+                Close();
+            }
+            return available;
+        }
+
         bool Connection::EstablishRemoteSocket() noexcept {
-            bool available = InboundSocketToRemoteSocket() && RemoteSocketToOutboundSocket();
+#if defined(__linux__)
+            /* A deferred hello still sits in the inbound stream: the kernel relay
+             * would splice it into the payload, so the channel stays in userspace.
+             * Resumable channels stay there too - retention needs to see frames. */
+            if (!hello_ && !token_ && TrySpliceRelay()) {
+                return true;
+            }
+#endif
+
+            bool available = RemoteSocketToOutboundSocket();
+            if (available) {
+                if (hello_) {
+                    const std::shared_ptr<Reference> references = GetReference();
+                    available = HelloAsync(inbound_,
+                        [references, this](bool success) noexcept {
+                            if (!success || !InboundSocketToRemoteSocket()) {
+                                Close();
+                            }
+                        });
+                }
+                else {
+                    available = InboundSocketToRemoteSocket();
+                }
+            }
+
             if (available) {
                 if (configuration_->KeepAlived) {
                     available = KeepAlivedReadCycle(outbound_) && KeepAlivedSendCycle(inbound_);
@@ -82,6 +517,12 @@ namespace uds {
             socket->async_connect(remoteEP,
                 [references, this](const boost::system::error_code& ec) noexcept {
                     if (!ec) {
+                        /* The connect handshake measured an RTT: resize toward the BDP. */
+                        const AsyncTcpSocketPtr remote = remote_;
+                        if (remote) {
+                            Socket::AdjustSocketBuffers(Socket::GetHandle(*remote));
+                        }
+
                         available_ = EstablishRemoteSocket();
                     }
 
@@ -93,6 +534,146 @@ namespace uds {
             return true;
         }
 
+        bool Connection::ConnectRemoteSockets(std::vector<IPEndPoint>& addresses) noexcept {
+            if (disposed_ || remote_) {
+                return false;
+            }
+
+            /* RFC 8305: alternate families with v6 leading, so one broken path
+             * costs a stagger interval instead of serializing the whole list. */
+            std::vector<boost::asio::ip::tcp::endpoint> v4s;
+            std::vector<boost::asio::ip::tcp::endpoint> v6s;
+            for (size_t i = 0, l = addresses.size(); i < l; i++) {
+                boost::asio::ip::tcp::endpoint remoteEP = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(addresses[i]);
+                boost::asio::ip::address address = remoteEP.address();
+                if (address.is_unspecified() || address.is_multicast()) {
+                    continue;
+                }
+
+                if (address.is_v6()) {
+                    v6s.push_back(remoteEP);
+                }
+                else {
+                    v4s.push_back(remoteEP);
+                }
+            }
+
+            candidates_.clear();
+            for (size_t i = 0, l = std::max(v6s.size(), v4s.size()); i < l; i++) {
+                if (i < v6s.size()) {
+                    candidates_.push_back(v6s[i]);
+                }
+
+                if (i < v4s.size()) {
+                    candidates_.push_back(v4s[i]);
+                }
+            }
+
+            if (candidates_.empty()) {
+                return false;
+            }
+            elif(candidates_.size() == 1) { /* Nothing to race: keep the plain dial. */
+                boost::asio::ip::tcp::endpoint remoteEP = candidates_[0];
+                candidates_.clear();
+                return ConnectRemoteSocket(remoteEP);
+            }
+            else {
+                return DialNextCandidate();
+            }
+        }
+
+        bool Connection::DialNextCandidate() noexcept {
+            if (disposed_ || remote_) {
+                return false;
+            }
+
+            while (!candidates_.empty()) {
+                boost::asio::ip::tcp::endpoint remoteEP = candidates_.front();
+                candidates_.erase(candidates_.begin());
+
+                const AsyncTcpSocketPtr socket = NewRemoteSocket(configuration_, GetContext(), remoteEP);
+                if (!socket) {
+                    continue;
+                }
+
+                attempts_.push_back(socket);
+                const std::shared_ptr<Reference> references = GetReference();
+                socket->async_connect(remoteEP,
+                    [references, this, socket](const boost::system::error_code& ec) noexcept {
+                        OnConnectCandidate(socket, ec ? false : true);
+                    });
+
+                /* The leader gets a head start; the wheel dials the next family
+                 * behind it unless a completion arrives first. */
+                if (!candidates_.empty()) {
+                    const std::shared_ptr<TimingWheel> wheel = TimingWheel::GetDefault();
+                    const AsyncContextPtr context = GetContext();
+                    if (wheel && context) {
+                        TimingWheel::ClearTimeout(stagger_);
+                        stagger_ = wheel->SetTimeout(
+                            [references, this, context](void*) noexcept {
+                                /* The wheel fires on its hosting tick thread: the
+                                 * candidate lists are unlocked and belong to the
+                                 * connection's context, where the async_connect
+                                 * completions land, so the dial hops there first. */
+                                boost::asio::post(*context,
+                                    [references, this]() noexcept {
+                                        stagger_.reset();
+                                        DialNextCandidate();
+                                    });
+                            }, ECONNECT_STAGGER);
+                    }
+                }
+                return true;
+            }
+            return false;
+        }
+
+        void Connection::OnConnectCandidate(const AsyncTcpSocketPtr& socket, bool success) noexcept {
+            for (std::list<AsyncTcpSocketPtr>::iterator i = attempts_.begin(); i != attempts_.end(); ++i) {
+                if (*i == socket) {
+                    attempts_.erase(i);
+                    break;
+                }
+            }
+
+            if (disposed_ || remote_) { /* The race is already decided. */
+                Socket::Closesocket(*socket);
+                return;
+            }
+
+            if (!success) {
+                /* A fast refusal is a better signal than the stagger deadline:
+                 * the next candidate dials at once. */
+                Socket::Closesocket(*socket);
+                TimingWheel::ClearTimeout(stagger_);
+                if (!DialNextCandidate() && attempts_.empty()) {
+                    Close();
+                }
+                return;
+            }
+
+            /* First past the post: the laggards are abandoned and the channel
+             * proceeds exactly as a plain dial would have. */
+            TimingWheel::ClearTimeout(stagger_);
+            candidates_.clear();
+            while (!attempts_.empty()) {
+                const AsyncTcpSocketPtr loser = std::move(attempts_.front());
+                attempts_.pop_front();
+                if (loser) {
+                    Socket::Closesocket(*loser);
+                }
+            }
+
+            remote_ = socket;
+            Socket::AdjustSocketBuffers(Socket::GetHandle(*socket));
+
+            available_ = EstablishRemoteSocket();
+            if (!available_) {
+                Close();
+            }
+        }
+
         Connection::AsyncContextPtr Connection::GetContext() noexcept {
             const ITransmissionPtr inbound = inbound_;
             if (inbound) {
@@ -160,7 +741,12 @@ namespace uds {
             Socket::SetDontFragment(handle, false);
 
             socket->set_option(boost::asio::ip::tcp::no_delay(configuration->Turbo), ec);
-            socket->set_option(boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_FASTOPEN>(configuration->FastOpen), ec);
+            if (configuration->FastOpen) {
+                /* With fast-open connect the dial completes at once and the first
+                 * queued write - the handshake frame - travels in the SYN payload,
+                 * so a warm reconnect to a TFO switches skips the connect RTT. */
+                Socket::SetFastOpenConnect(handle, true);
+            }
             return std::move(socket);
         }
 
@@ -174,7 +760,7 @@ namespace uds {
         }
 
         bool Connection::IsDisposed() noexcept {
-            return IsNone() || !remote_ || !buffers_;
+            return IsNone() || !remote_ || !listened_;
         }
 
         bool Connection::Available() noexcept {
@@ -187,6 +773,11 @@ namespace uds {
 
         void Connection::Dispose() noexcept {
             if (!disposed_.exchange(true)) {
+                uint64_t active = active_;
+                uint64_t now = uds::threading::Hosting::CachedMillisec();
+                UDS_TRACE4(channel_close, Id, rx_bytes_.load(std::memory_order_relaxed), tx_bytes_.load(std::memory_order_relaxed), detached_);
+                uds::threading::Logger::Write(uds::threading::Logger::LogEvent_ChannelClose, Id, active ? (int64_t)(now - active) : 0);
+
                 const ITransmissionPtr inbound = std::move(inbound_);
                 if (inbound) {
                     inbound->Close();
@@ -210,13 +801,37 @@ namespace uds {
                     catch (std::exception&) {}
                 }
 
-                buffers_.reset();
+                candidates_.clear();
+                while (!attempts_.empty()) { /* Dials still racing when the channel died. */
+                    const AsyncTcpSocketPtr attempt = std::move(attempts_.front());
+                    attempts_.pop_front();
+                    if (attempt) {
+                        Socket::Closesocket(*attempt);
+                    }
+                }
+
+                listened_ = false;
                 remote_.reset();
                 inbound_.reset();
                 outbound_.reset();
                 resolver_.reset();
+                replays_.reset();
                 uds::threading::ClearTimeout(timeout_);
+                TimingWheel::ClearTimeout(keepalived_);
+                TimingWheel::ClearTimeout(resume_);
+                TimingWheel::ClearTimeout(stagger_);
+
+#if defined(__linux__)
+                for (int i = 0; i < 2; i++) {
+                    const std::shared_ptr<Splicer> splicer = std::move(splicers_[i]);
+                    if (splicer) {
+                        splicers_[i].reset();
+                        splicer->Dispose();
+                    }
+                }
+#endif
 
+                ResumeEvent = NULL;
                 DisposedEventHandler disposedEvent = std::move(DisposedEvent);
                 if (disposedEvent) {
                     DisposedEvent = NULL;
@@ -225,26 +840,103 @@ namespace uds {
             }
         }
 
+#if defined(__linux__)
+        bool Connection::TrySpliceRelay() noexcept {
+            typedef AppConfiguration::ProtocolType ProtocolType;
+
+            if (IsNone() || !remote_) {
+                return false;
+            }
+
+            /* Only a raw TCP channel moves plain framed bytes end to end; keepalive frames
+             * would be interleaved into the stream, so they force the userspace path too. */
+            if (configuration_->Protocol != ProtocolType::ProtocolType_TCP || configuration_->KeepAlived) {
+                return false;
+            }
+
+            const AsyncTcpSocketPtr inbound = inbound_->GetUnderlyingSocket();
+            const AsyncTcpSocketPtr outbound = outbound_->GetUnderlyingSocket();
+            if (!inbound || !outbound) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            std::shared_ptr<Splicer> splicers[2] = {
+                make_shared_object<Splicer>(references, this, inbound, remote_),
+                make_shared_object<Splicer>(references, this, remote_, outbound),
+            };
+
+            for (int i = 0; i < 2; i++) {
+                if (!splicers[i] || !splicers[i]->Open()) {
+                    return false;
+                }
+            }
+
+            for (int i = 0; i < 2; i++) {
+                splicers_[i] = std::move(splicers[i]);
+            }
+            return splicers_[0]->Run() && splicers_[1]->Run();
+        }
+#endif
+
         bool Connection::RemoteSocketToOutboundSocket() noexcept {
             if (disposed_) {
                 return false;
             }
+            elif(detached_) { /* Parked: reads restart with the replacement pair. */
+                return true;
+            }
 
             const AsyncTcpSocketPtr socket = remote_;
             if (!socket) {
                 return false;
             }
 
-            const std::shared_ptr<Byte> buffers = buffers_;
+            if (remote_reading_ || outbound_inflight_ >= ECONNECTION_WND) { /* Window filled: reads pause until a write drains. */
+                return true;
+            }
+
+            const ITransmissionPtr transmission = outbound_;
+            if (transmission && transmission->IsCongested()) {
+                /* The outbound queue is above its high watermark: park the read until
+                 * it drains, so the remote peer feels TCP backpressure end to end. */
+                const std::shared_ptr<Reference> references = GetReference();
+                if (transmission->AwaitDrainAsync(
+                    [references, this](bool success) noexcept {
+                        if (!success) {
+                            if (!Detach()) {
+                                Close();
+                            }
+                        }
+                        elif(!RemoteSocketToOutboundSocket()) {
+                            Close();
+                        }
+                    })) {
+                    return true;
+                }
+            }
+
+            /* Adaptive transports retune their chunk to the tunnel path; everything
+             * else reads at the configured alignment as before. */
+            int chunk = transmission ? transmission->GetChunkSize() : 0;
+            if (chunk < 1) {
+                chunk = ECONNECTION_MSS;
+            }
+
+            const std::shared_ptr<Byte> buffers = uds::threading::BufferslabPool::Alloc(chunk);
             if (!buffers) {
                 return false;
             }
 
             const std::shared_ptr<Reference> references = GetReference();
-            socket->async_read_some(boost::asio::buffer(buffers.get(), ECONNECTION_MSS),
+            remote_reading_ = true;
+            socket->async_read_some(boost::asio::buffer(buffers.get(), chunk),
                 [references, this, socket, buffers](const boost::system::error_code& ec, size_t sz) noexcept {
+                    remote_reading_ = false;
+
                     int length = std::max<int>(ec ? -1 : sz, -1);
-                    if (!SendToOutboundSocket(buffers.get(), length)) {
+                    UDS_TRACE3(frame_read, Id, length, 0);
+                    if (!SendToOutboundSocket(buffers, length) || !RemoteSocketToOutboundSocket()) {
                         Close();
                     }
                 });
@@ -255,34 +947,72 @@ namespace uds {
             if (disposed_) {
                 return false;
             }
+            elif(detached_) { /* Parked: reads restart with the replacement pair. */
+                return true;
+            }
 
             const ITransmissionPtr socket = inbound_;
             if (!socket) {
                 return false;
             }
 
+            if (inbound_reading_ || remote_inflight_ >= ECONNECTION_WND) { /* Window filled: reads pause until a write drains. */
+                return true;
+            }
+
             const std::shared_ptr<Reference> references = GetReference();
+            inbound_reading_ = true;
             return socket->ReadAsync(
                 [references, this, socket](const std::shared_ptr<Byte>& buffers, int length) noexcept {
-                    if (!SendToRemoteSocket(buffers.get(), length)) {
+                    if (socket != inbound_) { /* A stale read off a pair a resume already superseded. */
+                        return;
+                    }
+
+                    inbound_reading_ = false;
+                    UDS_TRACE3(frame_read, Id, length, 1);
+                    if (length < 1) {
+                        if (!Detach()) { /* The transmission flapped, not the remote peer. */
+                            Close();
+                        }
+                        return;
+                    }
+
+                    if (!SendToRemoteSocket(buffers, length) || !InboundSocketToRemoteSocket()) {
                         Close();
                     }
                 });
         }
 
-        bool Connection::SendToRemoteSocket(const void* buffer, int length) noexcept {
+        bool Connection::SendToRemoteSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept {
             if (disposed_ || !buffer || length < 1) {
                 return false;
             }
 
+            active_ = uds::threading::Hosting::CachedMillisec();
             const AsyncTcpSocketPtr socket = remote_;
             if (!socket) {
                 return false;
             }
 
+            rx_bytes_.fetch_add(length, std::memory_order_relaxed);
+            rx_frames_.fetch_add(1, std::memory_order_relaxed);
+            uds::threading::Statistics::AddInbound(length);
+
+            /* The inbound transmission reuses its receive buffer between reads, so the
+             * frame is pinned into a slab copy while earlier writes are still draining. */
+            const std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(length);
+            if (!packet) {
+                return false;
+            }
+
+            memcpy(packet.get(), buffer.get(), length);
+
             const std::shared_ptr<Reference> references = GetReference();
-            boost::asio::async_write(*socket, boost::asio::buffer(buffer, length),
-                [references, this, socket](const boost::system::error_code& ec, size_t sz) noexcept {
+            remote_inflight_++;
+            boost::asio::async_write(*socket, boost::asio::buffer(packet.get(), length),
+                [references, this, socket, packet](const boost::system::error_code& ec, size_t sz) noexcept {
+                    remote_inflight_--;
+
                     int length = std::max<int>(ec ? -1 : sz, -1);
                     if (length < 1 || !InboundSocketToRemoteSocket()) {
                         Close();
@@ -291,75 +1021,112 @@ namespace uds {
             return true;
         }
 
-        bool Connection::SendToOutboundSocket(const void* buffer, int length) noexcept {
+        bool Connection::SendToOutboundSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept {
             if (disposed_ || !buffer || length < 1) {
                 return false;
             }
 
+            active_ = uds::threading::Hosting::CachedMillisec();
+            tx_bytes_.fetch_add(length, std::memory_order_relaxed);
+            tx_frames_.fetch_add(1, std::memory_order_relaxed);
+            uds::threading::Statistics::AddOutbound(length);
+            RetainToReplay(buffer, length);
+
+            if (detached_) { /* Parked: the frame waits in the ring for the replacement pair. */
+                return true;
+            }
+
             const ITransmissionPtr socket = outbound_;
             if (!socket) {
                 return false;
             }
 
             const std::shared_ptr<Reference> references = GetReference();
-            return socket->WriteAsync(std::shared_ptr<Byte>((Byte*)buffer, [](const void*) noexcept {}), 0, length,
+            outbound_inflight_++;
+            return socket->WriteAsync(buffer, 0, length,
                 [references, this, socket](bool success) noexcept {
-                    if (!success || !RemoteSocketToOutboundSocket()) {
+                    if (socket != outbound_) { /* A stale write off a pair a resume already superseded. */
+                        return;
+                    }
+
+                    outbound_inflight_--;
+                    if (!success) {
+                        if (!Detach()) { /* The transmission flapped, not the remote peer. */
+                            Close();
+                        }
+                    }
+                    elif(!RemoteSocketToOutboundSocket()) {
                         Close();
                     }
                 });
         }
 
-        bool Connection::HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, AcceptAsyncCallback&& handler) noexcept {
+        bool Connection::HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, UInt64 token, Int64 received, AcceptAsyncCallback&& handler) noexcept {
             if (!transmission || !handler || alignment < (UINT8_MAX << 1) || !channelId) {
                 return false;
             }
 
-            MemoryStream messages;
-            if (!PackPlaintextHeaders(messages, channelId, alignment)) {
+            ChunkedStream messages;
+            bool packed = token ?
+                PackResumeHeaders(messages, channelId, alignment, token, received) :
+                FastHandshake ?
+                    PackBinaryHeaders(messages, channelId, alignment) : PackPlaintextHeaders(messages, channelId, alignment);
+            if (!packed) {
+                return false;
+            }
+
+            int messages_size = 0;
+            std::shared_ptr<Byte> messages_buffer = messages.ToArray(messages_size); /* Slab-backed and copy-free while the headers fit in one segment. */
+            if (NULL == messages_buffer) {
                 return false;
             }
 
             const AcceptAsyncCallback callback = std::move(handler);
             const ITransmissionPtr ctransmission = transmission;
-            return ctransmission->WriteAsync(messages.GetBuffer(), 0, messages.GetPosition(),
+            return ctransmission->WriteAsync(messages_buffer, 0, messages_size,
                 [ctransmission, callback, channelId](bool success) noexcept {
                     callback(success, channelId);
                 });;
         }
 
-        bool Connection::HandshakeClient(const ITransmissionPtr& transmission, ConnectAsyncCallback&& handler) noexcept {
+        bool Connection::HandshakeClient(const ITransmissionPtr& transmission, JoinAsyncCallback&& handler) noexcept {
             if (!transmission || !handler) {
                 return false;
             }
 
-            const ConnectAsyncCallback callback = std::move(handler);
+            const JoinAsyncCallback callback = std::move(handler);
             const ITransmissionPtr ctransmission = transmission;
             return ctransmission->ReadAsync(
                 [ctransmission, callback](const std::shared_ptr<Byte>& buffer, int length) noexcept {
                     if (!buffer || length < 1) {
-                        callback(false, 0);
+                        callback(false, 0, 0, -1);
                         return;
                     }
 
-                    Int64 v = UnpackPlaintextLength(buffer.get(), 0, length);
+                    Byte* data = buffer.get();
+                    Int64 v = *data == EHANDSHAKE_BINARY_MAGIC ?
+                        UnpackBinaryLength(data, 0, length) : UnpackPlaintextLength(data, 0, length);
                     if (!v) {
-                        callback(false, 0);
+                        callback(false, 0, 0, -1);
                         return;
                     }
 
                     int messages_size = (int)(v);
                     if (messages_size != length) {
-                        callback(false, 0);
+                        callback(false, 0, 0, -1);
                         return;
                     }
 
                     int channelId = (int)(v >> 32);
                     if (!channelId) {
-                        callback(false, 0);
+                        callback(false, 0, 0, -1);
                         return;
                     }
-                    callback(true, channelId);
+
+                    UInt64 token = 0;
+                    UInt64 received = 0;
+                    int version = UnpackResumeFields(data, 0, length, token, received);
+                    callback(true, channelId, token, version == EHANDSHAKE_RESUME_VERSION ? (Int64)received : -1);
                 });
         }
 
@@ -373,19 +1140,66 @@ namespace uds {
                 return false;
             }
 
-            return HandshakeServer(inbound, alignment, channelId, std::forward<AcceptAsyncCallback>(handler));
+            return HandshakeServer(inbound, alignment, channelId, 0, -1, std::forward<AcceptAsyncCallback>(handler));
         }
 
         bool Connection::AcceptAsync(const ITransmissionPtr& outbound, AcceptAsyncCallback&& handler) noexcept {
-            return HandshakeClient(outbound, std::forward<AcceptAsyncCallback>(handler));
+            if (!handler) {
+                return false;
+            }
+
+            const AcceptAsyncCallback callback = std::move(handler);
+            return HandshakeClient(outbound,
+                [callback](bool success, int channelId, UInt64, Int64) noexcept {
+                    callback(success, channelId);
+                });
+        }
+
+        bool Connection::AcceptJoinAsync(const ITransmissionPtr& outbound, JoinAsyncCallback&& handler) noexcept {
+            return HandshakeClient(outbound, std::forward<JoinAsyncCallback>(handler));
+        }
+
+        bool Connection::AcceptResumeAsync(const ITransmissionPtr& inbound, ResumeAsyncCallback&& handler) noexcept {
+            if (!handler) {
+                return false;
+            }
+
+            const ResumeAsyncCallback callback = std::move(handler);
+            return HandshakeClient(inbound,
+                [callback](bool success, int, UInt64, Int64 received) noexcept {
+                    if (received < 0) { /* Whatever arrived, it was not a resume acknowledgement. */
+                        success = false;
+                    }
+                    callback(success, success ? (UInt64)received : 0);
+                });
         }
 
         bool Connection::ConnectAsync(const ITransmissionPtr& outbound, int alignment, int channelId, ConnectAsyncCallback&& handler) noexcept {
-            return HandshakeServer(outbound, alignment, channelId, std::forward<ConnectAsyncCallback>(handler));
+            return HandshakeServer(outbound, alignment, channelId, 0, -1, std::forward<ConnectAsyncCallback>(handler));
+        }
+
+        bool Connection::ConnectAsync(const ITransmissionPtr& outbound, int alignment, int channelId, UInt64 token, ConnectAsyncCallback&& handler) noexcept {
+            return HandshakeServer(outbound, alignment, channelId, token, -1, std::forward<ConnectAsyncCallback>(handler));
+        }
+
+        bool Connection::ConnectResumeAsync(const ITransmissionPtr& outbound, int alignment, int channelId, UInt64 token, UInt64 received, ConnectAsyncCallback&& handler) noexcept {
+            if (!token) {
+                return false;
+            }
+
+            return HandshakeServer(outbound, alignment, channelId, token, (Int64)received, std::forward<ConnectAsyncCallback>(handler));
         }
 
         bool Connection::ConnectAsync(const ITransmissionPtr& inbound, ConnectAsyncCallback&& handler) noexcept {
-            return HandshakeClient(inbound, std::forward<ConnectAsyncCallback>(handler));
+            if (!handler) {
+                return false;
+            }
+
+            const ConnectAsyncCallback callback = std::move(handler);
+            return HandshakeClient(inbound,
+                [callback](bool success, int channelId, UInt64, Int64) noexcept {
+                    callback(success, channelId);
+                });
         }
 
         bool Connection::HelloAsync(const ITransmissionPtr& outbound) noexcept {
@@ -394,7 +1208,7 @@ namespace uds {
             }
 
             ITransmissionPtr transmission = outbound;
-            return HandshakeServer(outbound, UINT8_MAX << 1, RandomNext(1, INT_MAX),
+            return HandshakeServer(outbound, UINT8_MAX << 1, RandomNext(1, INT_MAX), 0, -1,
                 [transmission](bool success, int) noexcept {
                     if (!success) {
                         transmission->Close();
@@ -411,7 +1225,7 @@ namespace uds {
             ITransmissionPtr transmission = inbound;
 
             return HandshakeClient(inbound,
-                [transmission, callback](bool success, int) noexcept {
+                [transmission, callback](bool success, int, UInt64, Int64) noexcept {
                     if (!success) {
                         transmission->Close();
                     }
@@ -426,9 +1240,7 @@ namespace uds {
 
             Char messages[uds::threading::Hosting::BufferSize];
             int messages_size = RandomNext(UINT8_MAX << 1, std::min<int>(alignment, sizeof(messages)));
-            for (int i = 0; i < messages_size; i++) {
-                messages[i] = RandomAscii();
-            }
+            RandomAsciiFill(messages, messages_size);
 
             int offset = sprintf((char*)messages + 1, "%04X%08X", messages_size, channelId ^ (messages_size << 16 | messages_size));
             if (offset < 1) {
@@ -470,6 +1282,133 @@ namespace uds {
             return channelid << 32 | messages_size;
         }
 
+        bool Connection::PackBinaryHeaders(Stream& stream, int channelId, int alignment) noexcept {
+            if (!stream.CanWrite()) {
+                return false;
+            }
+
+            Byte messages[uds::threading::Hosting::BufferSize];
+            int messages_size = RandomNext(UINT8_MAX << 1, std::min<int>(alignment, sizeof(messages)));
+
+            UInt32 obfuscated = (UInt32)(channelId ^ (messages_size << 16 | messages_size));
+            messages[0] = EHANDSHAKE_BINARY_MAGIC;
+            messages[1] = EHANDSHAKE_BINARY_VERSION;
+            messages[2] = (Byte)(messages_size >> 8);
+            messages[3] = (Byte)(messages_size);
+            messages[4] = (Byte)(obfuscated >> 24);
+            messages[5] = (Byte)(obfuscated >> 16);
+            messages[6] = (Byte)(obfuscated >> 8);
+            messages[7] = (Byte)(obfuscated);
+
+            RandomAsciiFill(messages + EHANDSHAKE_BINARY_HEADERS, messages_size - EHANDSHAKE_BINARY_HEADERS);
+            return stream.Write(messages, 0, messages_size);
+        }
+
+        Int64 Connection::UnpackBinaryLength(const void* buffer, int offset, int length) noexcept {
+            if (!buffer || offset < 0 || length < EHANDSHAKE_BINARY_HEADERS) {
+                return 0;
+            }
+
+            Byte* data = ((Byte*)buffer) + offset;
+            if (data[0] != EHANDSHAKE_BINARY_MAGIC || data[1] < EHANDSHAKE_BINARY_VERSION || data[1] > EHANDSHAKE_RESUME_VERSION) {
+                return 0;
+            }
+
+            int headers = data[1] == EHANDSHAKE_BINARY_VERSION ? EHANDSHAKE_BINARY_HEADERS :
+                data[1] == EHANDSHAKE_TOKEN_VERSION ? EHANDSHAKE_TOKEN_HEADERS : EHANDSHAKE_RESUME_HEADERS;
+
+            Int64 messages_size = data[2] << 8 | data[3];
+            if (headers > messages_size || headers > length) {
+                return 0;
+            }
+
+            Int64 channelid = (UInt32)(data[4] << 24 | data[5] << 16 | data[6] << 8 | data[7]);
+            channelid ^= messages_size << 16 | messages_size;
+            return channelid << 32 | messages_size;
+        }
+
+        bool Connection::PackResumeHeaders(Stream& stream, int channelId, int alignment, UInt64 token, Int64 received) noexcept {
+            if (!stream.CanWrite() || !token) {
+                return false;
+            }
+
+            /* Receivers always accept the binary codec, so resume frames ride it
+             * even when the deployment otherwise speaks plaintext. */
+            Byte messages[uds::threading::Hosting::BufferSize];
+            int headers = received < 0 ? EHANDSHAKE_TOKEN_HEADERS : EHANDSHAKE_RESUME_HEADERS;
+            int messages_size = RandomNext(UINT8_MAX << 1, std::min<int>(alignment, sizeof(messages)));
+
+            UInt32 mask32 = (UInt32)(messages_size << 16 | messages_size);
+            UInt64 mask64 = (UInt64)mask32 << 32 | mask32;
+
+            UInt32 obfuscated = (UInt32)(channelId ^ mask32);
+            messages[0] = EHANDSHAKE_BINARY_MAGIC;
+            messages[1] = received < 0 ? EHANDSHAKE_TOKEN_VERSION : EHANDSHAKE_RESUME_VERSION;
+            messages[2] = (Byte)(messages_size >> 8);
+            messages[3] = (Byte)(messages_size);
+            messages[4] = (Byte)(obfuscated >> 24);
+            messages[5] = (Byte)(obfuscated >> 16);
+            messages[6] = (Byte)(obfuscated >> 8);
+            messages[7] = (Byte)(obfuscated);
+
+            UInt64 t = token ^ mask64;
+            for (int i = 0; i < 8; i++) {
+                messages[8 + i] = (Byte)(t >> (56 - (i << 3)));
+            }
+
+            if (received >= 0) {
+                UInt64 r = (UInt64)received ^ mask64;
+                for (int i = 0; i < 8; i++) {
+                    messages[16 + i] = (Byte)(r >> (56 - (i << 3)));
+                }
+            }
+
+            RandomAsciiFill(messages + headers, messages_size - headers);
+            return stream.Write(messages, 0, messages_size);
+        }
+
+        int Connection::UnpackResumeFields(const void* buffer, int offset, int length, UInt64& token, UInt64& received) noexcept {
+            token = 0;
+            received = 0;
+
+            if (!buffer || offset < 0 || length < EHANDSHAKE_TOKEN_HEADERS) {
+                return 0;
+            }
+
+            Byte* data = ((Byte*)buffer) + offset;
+            if (data[0] != EHANDSHAKE_BINARY_MAGIC) {
+                return 0;
+            }
+
+            int version = data[1];
+            if (version != EHANDSHAKE_TOKEN_VERSION && version != EHANDSHAKE_RESUME_VERSION) {
+                return 0;
+            }
+
+            if (version == EHANDSHAKE_RESUME_VERSION && length < EHANDSHAKE_RESUME_HEADERS) {
+                return 0;
+            }
+
+            int messages_size = data[2] << 8 | data[3];
+            UInt32 mask32 = (UInt32)(messages_size << 16 | messages_size);
+            UInt64 mask64 = (UInt64)mask32 << 32 | mask32;
+
+            UInt64 t = 0;
+            for (int i = 0; i < 8; i++) {
+                t = t << 8 | data[8 + i];
+            }
+
+            token = t ^ mask64;
+            if (version == EHANDSHAKE_RESUME_VERSION) {
+                UInt64 r = 0;
+                for (int i = 0; i < 8; i++) {
+                    r = r << 8 | data[16 + i];
+                }
+                received = r ^ mask64;
+            }
+            return version;
+        }
+
         bool Connection::KeepAlivedReadCycle(const ITransmissionPtr& transmission) noexcept {
             if (disposed_ || !transmission) {
                 return false;
@@ -479,8 +1418,14 @@ namespace uds {
             const ITransmissionPtr network = transmission;
             return network->ReadAsync(
                 [network, references, this](const std::shared_ptr<Byte>& buffers, int length) noexcept {
+                    if (network != outbound_) { /* Superseded by a resume: the cycle restarts on the new pair. */
+                        return;
+                    }
+
                     if (length < 1) {
-                        Close();
+                        if (!Detach()) {
+                            Close();
+                        }
                     }
                     else {
                         KeepAlivedReadCycle(network);
@@ -488,55 +1433,123 @@ namespace uds {
                 });
         }
 
+        std::shared_ptr<Byte> Connection::JunkMessages() noexcept {
+            /* Pre-randomized junk ring: keepalive frames copy from these slabs instead
+             * of refilling a fresh buffer one byte at a time per frame. Senders must
+             * not hand the slabs to a transport directly - stream ciphers transform
+             * the write buffer in place, and the ring is shared process-wide. */
+            static const int EJUNK_COUNT = 16;
+            static std::shared_ptr<Byte> junks[EJUNK_COUNT];
+            static std::once_flag once;
+
+            std::call_once(once,
+                []() noexcept {
+                    for (int i = 0; i < EJUNK_COUNT; i++) {
+                        std::shared_ptr<Byte> messages = uds::threading::BufferslabPool::Alloc(64);
+                        if (!messages) {
+                            continue;
+                        }
+
+                        RandomAsciiFill(messages.get(), 64);
+                        junks[i] = std::move(messages);
+                    }
+                });
+            return junks[RandomNext(0, EJUNK_COUNT - 1)];
+        }
+
         bool Connection::KeepAlivedSendCycle(const ITransmissionPtr& transmission) noexcept {
-            if (disposed_ || !transmission) {
-                return false;
-            }
+            static const uint64_t EKEEPALIVED_BACKOFF = 1000;
 
-            const AsyncContextPtr context = GetContext();
-            if (!context) {
+            if (disposed_ || !transmission) {
                 return false;
             }
 
             const std::shared_ptr<Reference> references = GetReference();
             const ITransmissionPtr network = transmission;
-            if (timeout_) {
-                uds::threading::ClearTimeout(timeout_);
+
+            /* Back off while the channel moves real payload: that traffic keeps the
+             * NAT mapping alive by itself, junk would only burn cycles on it. */
+            int interval = RandomNext(100, 500);
+            if (uds::threading::Hosting::CachedMillisec() - active_ < EKEEPALIVED_BACKOFF) {
+                interval = (int)EKEEPALIVED_BACKOFF;
             }
 
-            timeout_ = uds::threading::SetTimeout(context,
-                [references, this, network](void*) noexcept {
-                    if (timeout_) {
-                        uds::threading::ClearTimeout(timeout_);
-                    }
+            const std::function<void(void*)> sweep = [references, this, network](void*) noexcept {
+                if (disposed_) {
+                    return;
+                }
 
-                    std::shared_ptr<Byte> messages = make_shared_alloc<Byte>(64);
-                    if (!messages) {
+                if (network != inbound_) { /* Superseded by a resume: the cycle restarts on the new pair. */
+                    return;
+                }
+
+                if (uds::threading::Hosting::CachedMillisec() - active_ < EKEEPALIVED_BACKOFF) {
+                    if (!KeepAlivedSendCycle(network)) { /* Still busy: look again later without writing anything. */
                         Close();
-                        return false;
                     }
+                    return;
+                }
 
-                    Byte* packet = messages.get();
-                    int packet_size = RandomNext(8, 64);
-                    for (int i = 0; i < packet_size; i++) {
-                        packet[i] = RandomAscii();
-                    }
+                std::shared_ptr<Byte> messages = JunkMessages();
+                if (!messages) {
+                    Close();
+                    return;
+                }
 
-                    if (!network->WriteAsync(messages, 0, packet_size,
-                        [references, this, network](bool success) noexcept {
-                            if (success) {
-                                success = KeepAlivedSendCycle(network);
-                            }
+                int packet_size = RandomNext(8, 64);
+                std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(packet_size);
+                if (!packet) {
+                    Close();
+                    return;
+                }
 
-                            if (!success) {
-                                Close();
-                            }
-                        })) {
-                        Close();
-                        return false;
-                    }
-                    return true;
-                }, RandomNext(100, 500));
+                memcpy(packet.get(), messages.get(), packet_size); /* Per-send copy: the shared slab stays untouched under in-place ciphers. */
+                if (!network->WriteAsync(packet, 0, packet_size,
+                    [references, this, network](bool success) noexcept {
+                        if (network != inbound_) { /* Superseded by a resume: the cycle restarts on the new pair. */
+                            return;
+                        }
+
+                        if (success) {
+                            success = KeepAlivedSendCycle(network);
+                        }
+
+                        if (!success) {
+                            Close();
+                        }
+                    })) {
+                    Close();
+                }
+            };
+
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            /* The wheel turns every keepalive into a bucket entry on the shared 10ms
+             * tick; without a hosting the per-connection timer remains the fallback.
+             * Either way the sweep itself runs on the connection's context: it reads
+             * the live pair and closes the channel, none of which the wheel's tick
+             * thread may touch. */
+            const std::shared_ptr<TimingWheel> wheel = TimingWheel::GetDefault();
+            if (wheel) {
+                TimingWheel::ClearTimeout(keepalived_);
+                keepalived_ = wheel->SetTimeout(
+                    [context, sweep](void*) noexcept {
+                        boost::asio::post(*context,
+                            [sweep]() noexcept {
+                                sweep(NULL);
+                            });
+                    }, interval);
+                return NULL != keepalived_;
+            }
+
+            if (timeout_) {
+                uds::threading::ClearTimeout(timeout_);
+            }
+
+            timeout_ = uds::threading::SetTimeout(context, std::function<void(void*)>(sweep), interval);
             return NULL != timeout_;
         }
     }
@@ -5,6 +5,7 @@
 #include <uds/io/Stream.h>
 #include <uds/io/BinaryReader.h>
 #include <uds/io/MemoryStream.h>
+#include <uds/io/ChunkedStream.h>
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
 #include <uds/transmission/ITransmission.h>
@@ -25,21 +26,34 @@ namespace uds {
             using AsyncContextPtr               = std::shared_ptr<boost::asio::io_context>;
             using AsyncResolverPtr              = std::shared_ptr<boost::asio::ip::tcp::resolver>;
             using AsyncDeadlineTimerPtr         = std::shared_ptr<boost::asio::deadline_timer>;
+            using TimingWheel                   = uds::threading::TimingWheel;
+            using WheelTimeoutPtr               = TimingWheel::TimeoutPtr;
             using Stream                        = uds::io::Stream;
             using BinaryReader                  = uds::io::BinaryReader;
             using MemoryStream                  = uds::io::MemoryStream;
+            using ChunkedStream                 = uds::io::ChunkedStream;
 
         public:
             using DisposedEventHandler          = std::function<void(Connection*)>;
+            using ResumeEventHandler            = std::function<bool(Connection*)>;
             using AcceptAsyncCallback           = std::function<void(bool, int)>;
             using AcceptAsyncMeasureChannelId   = std::function<int(const ITransmissionPtr&)>;
             using ConnectAsyncCallback          = AcceptAsyncCallback;
+            using JoinAsyncCallback             = std::function<void(bool, int, UInt64, Int64)>;
+            using ResumeAsyncCallback           = std::function<void(bool, UInt64)>;
             using HelloAsyncCallback            = std::function<void(bool)>;
 
         public:
             const int                           ECONNECTION_MSS = uds::threading::Hosting::BufferSize;
+            const int                           ECONNECTION_WND = 4;
             const int                           Id;
             DisposedEventHandler                DisposedEvent;
+            ResumeEventHandler                  ResumeEvent; /* Fired when a resumable channel detaches: return true to own the redial. */
+
+        public:
+            /* Senders emit the fixed-layout binary handshake; receivers always accept
+             * both codecs, so either peer may upgrade first. */
+            static bool                         FastHandshake;
 
         public:
             Connection(const AppConfigurationPtr& configuration, int id, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
@@ -49,20 +63,61 @@ namespace uds {
             virtual void                        Dispose() noexcept override;
             void                                Close() noexcept;
             bool                                Available() noexcept;
+            bool                                DeferHello() noexcept;
+
+        public:
+            /* Resumable channels survive a transport flap: frames sent into the tunnel
+             * are retained in a bounded slab ring until the peer acknowledges them at
+             * reattach time, so a replacement pair replays only what was lost. */
+            bool                                SetResumable(UInt64 token) noexcept;
+            bool                                Reattach(const ITransmissionPtr& inbound, const ITransmissionPtr& outbound, UInt64 received, bool acknowledge) noexcept;
+            inline UInt64                       GetResumeToken() noexcept {
+                return token_;
+            }
+            inline bool                         Detached() noexcept {
+                return detached_;
+            }
+            static UInt64                       NewResumeToken() noexcept;
+
+        public:
+            /* Relaxed snapshots: readers tolerate a frame of skew, the relay
+             * path never pays more than an uncontended atomic add. */
+            inline uint64_t                     GetInboundBytes() noexcept {
+                return rx_bytes_.load(std::memory_order_relaxed);
+            }
+            inline uint64_t                     GetInboundFrames() noexcept {
+                return rx_frames_.load(std::memory_order_relaxed);
+            }
+            inline uint64_t                     GetOutboundBytes() noexcept {
+                return tx_bytes_.load(std::memory_order_relaxed);
+            }
+            inline uint64_t                     GetOutboundFrames() noexcept {
+                return tx_frames_.load(std::memory_order_relaxed);
+            }
 
         public:
             static bool                         AcceptAsync(const ITransmissionPtr& inbound, int alignment, AcceptAsyncMeasureChannelId&& measure, AcceptAsyncCallback&& handler) noexcept;
             static bool                         AcceptAsync(const ITransmissionPtr& outbound, AcceptAsyncCallback&& handler) noexcept;
+            static bool                         AcceptJoinAsync(const ITransmissionPtr& outbound, JoinAsyncCallback&& handler) noexcept;
+            static bool                         AcceptResumeAsync(const ITransmissionPtr& inbound, ResumeAsyncCallback&& handler) noexcept;
             static bool                         ConnectAsync(const ITransmissionPtr& outbound, int alignment, int channelId, ConnectAsyncCallback&& handler) noexcept;
+            static bool                         ConnectAsync(const ITransmissionPtr& outbound, int alignment, int channelId, UInt64 token, ConnectAsyncCallback&& handler) noexcept;
             static bool                         ConnectAsync(const ITransmissionPtr& inbound, ConnectAsyncCallback&& handler) noexcept;
+            static bool                         ConnectResumeAsync(const ITransmissionPtr& outbound, int alignment, int channelId, UInt64 token, UInt64 received, ConnectAsyncCallback&& handler) noexcept;
             static bool                         HelloAsync(const ITransmissionPtr& outbound) noexcept;
             static bool                         HelloAsync(const ITransmissionPtr& inbound, HelloAsyncCallback&& handler) noexcept;
 
-        private:
+        public: /* Stateless handshake codec, also exercised by the microbenchmarks. */
             static bool                         PackPlaintextHeaders(Stream& stream, int channelId, int alignment) noexcept;
             static Int64                        UnpackPlaintextLength(const void* buffer, int offset, int length) noexcept;
-            static bool                         HandshakeClient(const ITransmissionPtr& transmission, ConnectAsyncCallback&& handler) noexcept;
-            static bool                         HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, AcceptAsyncCallback&& handler) noexcept;
+            static bool                         PackBinaryHeaders(Stream& stream, int channelId, int alignment) noexcept;
+            static Int64                        UnpackBinaryLength(const void* buffer, int offset, int length) noexcept;
+            static bool                         PackResumeHeaders(Stream& stream, int channelId, int alignment, UInt64 token, Int64 received) noexcept;
+            static int                          UnpackResumeFields(const void* buffer, int offset, int length, UInt64& token, UInt64& received) noexcept;
+
+        private:
+            static bool                         HandshakeClient(const ITransmissionPtr& transmission, JoinAsyncCallback&& handler) noexcept;
+            static bool                         HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, UInt64 token, Int64 received, AcceptAsyncCallback&& handler) noexcept;
 
         private:
             bool                                IsNone() noexcept;
@@ -78,14 +133,27 @@ namespace uds {
             bool                                KeepAlivedReadCycle(const ITransmissionPtr& transmission) noexcept;
             bool                                KeepAlivedSendCycle(const ITransmissionPtr& transmission) noexcept;
             bool                                ConnectRemoteSocket(boost::asio::ip::tcp::endpoint remoteEP) noexcept;
+            bool                                ConnectRemoteSockets(std::vector<IPEndPoint>& addresses) noexcept;
+            bool                                DialNextCandidate() noexcept;
+            void                                OnConnectCandidate(const AsyncTcpSocketPtr& socket, bool success) noexcept;
 
         private:
             bool                                RemoteSocketToOutboundSocket() noexcept;
             bool                                InboundSocketToRemoteSocket() noexcept;
+#if defined(__linux__)
+            class Splicer;
+            bool                                TrySpliceRelay() noexcept;
+#endif
+
+        private:
+            bool                                SendToRemoteSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                SendToOutboundSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            static std::shared_ptr<Byte>        JunkMessages() noexcept;
 
         private:
-            bool                                SendToRemoteSocket(const void* buffer, int length) noexcept;
-            bool                                SendToOutboundSocket(const void* buffer, int length) noexcept;
+            class ReplayRing;
+            bool                                Detach() noexcept;
+            bool                                RetainToReplay(const std::shared_ptr<Byte>& buffer, int length) noexcept;
 
         private:
             std::atomic<bool>                   disposed_;
@@ -96,7 +164,28 @@ namespace uds {
             AsyncTcpSocketPtr                   remote_;
             AsyncResolverPtr                    resolver_;
             AsyncDeadlineTimerPtr               timeout_;
-            std::shared_ptr<Byte>               buffers_;
+            WheelTimeoutPtr                     keepalived_;
+            uint64_t                            active_; /* Tick of the last relayed payload. */
+            bool                                listened_;
+            bool                                hello_; /* The peer's hello is still in flight on the inbound stream. */
+            UInt64                              token_; /* Nonzero arms resumability. */
+            bool                                detached_; /* Parked without transmissions, awaiting a replacement pair. */
+            std::shared_ptr<ReplayRing>         replays_; /* Frames sent into the tunnel since the last acknowledged offset. */
+            WheelTimeoutPtr                     resume_;  /* Resume-window deadline while detached. */
+            std::vector<boost::asio::ip::tcp::endpoint> candidates_; /* Connect race: the resolved endpoints, families interleaved, not yet dialed. */
+            std::list<AsyncTcpSocketPtr>        attempts_;           /* Connect race: dials in flight; the first to complete wins. */
+            WheelTimeoutPtr                     stagger_;            /* Connect race: deadline before the next candidate joins. */
+            bool                                remote_reading_;
+            bool                                inbound_reading_;
+            int                                 remote_inflight_;   /* Writes draining on the remote socket. */
+            int                                 outbound_inflight_; /* Writes draining on the outbound transmission. */
+            std::atomic<uint64_t>               rx_bytes_;  /* Tunnel to remote socket. */
+            std::atomic<uint64_t>               rx_frames_;
+            std::atomic<uint64_t>               tx_bytes_;  /* Remote socket into the tunnel. */
+            std::atomic<uint64_t>               tx_frames_;
+#if defined(__linux__)
+            std::shared_ptr<Splicer>            splicers_[2];
+#endif
         };
     }
 }
\ No newline at end of file
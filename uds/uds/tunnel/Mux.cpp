@@ -0,0 +1,706 @@
+#include <uds/collections/Dictionary.h>
+#include <uds/threading/Timer.h>
+#include <uds/threading/BufferslabPool.h>
+#include <uds/tunnel/Mux.h>
+
+using uds::collections::Dictionary;
+
+namespace uds {
+    namespace tunnel {
+        static const Byte EMUX_CTRL_OPEN  = 1;
+        static const Byte EMUX_CTRL_CLOSE = 2;
+        static const Byte EMUX_CTRL_PING  = 3;
+
+        /* One logical channel surfaced as a transmission: the relay machinery drives
+         * it like any other, unaware that its frames share a physical byte stream. */
+        class Mux::VirtualChannel final : public ITransmission {
+            friend class Mux;
+
+            struct frame {
+                std::shared_ptr<Byte>           packet;
+                int                             packet_size;
+            };
+            typedef std::list<frame>            frame_queue;
+
+        public:
+            VirtualChannel(const std::shared_ptr<Reference>& owner, Mux* mux, int channel) noexcept
+                : disposed_(false)
+                , remoted_(false)
+                , channel_(channel)
+                , ewma_(0)
+                , bulk_parked_(0)
+                , mux_(mux)
+                , owner_(owner) {
+
+            }
+
+        public:
+            virtual void                        Dispose() noexcept override {
+                if (!disposed_.exchange(true)) {
+                    mux_->CloseChannel(channel_, true);
+                }
+            }
+            virtual bool                        HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override {
+                if (!callback || disposed_) {
+                    return false;
+                }
+
+                /* Logical channels ride a pipe that already handshaked. */
+                const AsyncContextPtr context = mux_->GetContext();
+                if (!context) {
+                    return false;
+                }
+
+                const std::shared_ptr<ITransmission> reference_ = GetReference();
+                const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+                boost::asio::post(*context,
+                    [reference_, callback_]() noexcept {
+                        callback_(true);
+                    });
+                return true;
+            }
+            virtual bool                        ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override {
+                if (!callback || disposed_) {
+                    return false;
+                }
+
+                Mux* const mux = mux_;
+                frame messages; {
+                    MutexScope scope(mux->syncobj_);
+                    if (reading_) {
+                        return false;
+                    }
+
+                    if (frames_.empty()) {
+                        if (remoted_) {
+                            return false;
+                        }
+
+                        reading_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+                        return true;
+                    }
+
+                    messages = std::move(frames_.front());
+                    frames_.pop_front();
+                    mux->backlogs_--;
+                }
+
+                const AsyncContextPtr context = mux->GetContext();
+                if (!context) {
+                    return false;
+                }
+
+                const std::shared_ptr<ITransmission> reference_ = GetReference();
+                const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+                const std::shared_ptr<Byte> packet = messages.packet;
+                const int packet_size = messages.packet_size;
+                boost::asio::post(*context,
+                    [reference_, callback_, packet, packet_size]() noexcept {
+                        callback_(packet, packet_size);
+                    });
+                return mux->ResumeReadCycle();
+            }
+            virtual bool                        WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override {
+                if (!buffer || offset < 0 || length < 1) {
+                    return false;
+                }
+
+                if (disposed_) {
+                    return false;
+                }
+
+                Mux* const mux = mux_;
+                bool urgent = false;
+                if (mux->configuration_->Priority.Enabled) {
+                    MutexScope scope(mux->syncobj_);
+
+                    /* Frame-size EWMA classifies the channel: keystroke-sized writes
+                     * keep it interactive, a sustained transfer pushes it into the
+                     * bulk class. A channel with frames still parked in the bulk
+                     * queue stays bulk, so its own frames can never leapfrog each
+                     * other across the two queues. */
+                    int ewma = ewma_;
+                    ewma_ = ewma = ewma ? (ewma - (ewma >> 3)) + (length >> 3) : length; /* EWMA, alpha 1/8. */
+                    urgent = bulk_parked_ < 1 && ewma <= mux->configuration_->Priority.Threshold;
+                }
+
+                const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+                for (int i = 0; i < length; i += mux->EMUX_MSS) { /* An oversize payload is framed as a run of channel-tagged chunks. */
+                    int chunk = std::min<int>(mux->EMUX_MSS, length - i);
+                    bool endl = (i + chunk) >= length;
+                    if (!mux->WriteFrameAsync(channel_, urgent, buffer, offset + i, chunk, endl ? WriteAsyncCallback(callback_) : (WriteAsyncCallback)NULL)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+        public:
+            virtual AsyncContextPtr             GetContext() noexcept override {
+                return mux_->GetContext();
+            }
+            virtual uds::net::IPEndPoint        GetLocalEndPoint() noexcept override {
+                const ITransmissionPtr writer = mux_->writer_;
+                return writer ? writer->GetLocalEndPoint() : uds::net::IPEndPoint();
+            }
+            virtual uds::net::IPEndPoint        GetRemoteEndPoint() noexcept override {
+                const ITransmissionPtr writer = mux_->writer_;
+                return writer ? writer->GetRemoteEndPoint() : uds::net::IPEndPoint();
+            }
+            virtual bool                        IsCongested() noexcept override { /* Congestion belongs to the shared pipe, not the logical channel. */
+                const ITransmissionPtr writer = mux_->writer_;
+                return writer ? writer->IsCongested() : false;
+            }
+            virtual bool                        AwaitDrainAsync(const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override {
+                const ITransmissionPtr writer = mux_->writer_;
+                return writer ? writer->AwaitDrainAsync(forward0f(callback)) : false;
+            }
+
+        private:
+            std::atomic<bool>                   disposed_;
+            bool                                remoted_; /* The peer sent CLOSE: drained reads fail instead of parking. */
+            int                                 channel_;
+            int                                 ewma_;        /* Frame-size EWMA the write scheduler classifies the channel by. */
+            int                                 bulk_parked_; /* Frames of this channel still parked in the bulk queue. */
+            Mux*                                mux_;
+            std::shared_ptr<Reference>          owner_;
+            frame_queue                         frames_;
+            ReadAsyncCallback                   reading_;
+        };
+
+        Mux::Mux(const AppConfigurationPtr& configuration, const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept
+            : disposed_(false)
+            , running_(false)
+            , paused_(false)
+            , pumping_(false)
+            , backlogs_(0)
+            , channel_(RandomNext(1, INT_MAX))
+            , configuration_(configuration)
+            , reader_(reader)
+            , writer_(writer) {
+            if (configuration) {
+                int alignment = configuration->Alignment;
+                if (alignment >= (UINT8_MAX << 1) && alignment <= uds::threading::Hosting::BufferSize) {
+                    constantof(EMUX_MSS) = alignment - EMUX_TSS;
+                }
+
+                /* Logical channels must not run the junk-frame keepalive: a channel
+                 * frames everything it writes, so the junk would surface as payload on
+                 * the far relay. The mux pings the physical pipe itself instead. */
+                channels_configuration_ = make_shared_object<AppConfiguration>(*configuration);
+                if (channels_configuration_) {
+                    channels_configuration_->KeepAlived = false;
+                }
+            }
+        }
+
+        bool Mux::Run() noexcept {
+            if (disposed_ || running_) {
+                return false;
+            }
+
+            if (!reader_ || !writer_ || !channels_configuration_) {
+                return false;
+            }
+
+            running_ = true;
+            if (configuration_->KeepAlived) {
+                if (!KeepAlivedSendCycle()) {
+                    return false;
+                }
+            }
+            return ReadCycle();
+        }
+
+        void Mux::Close() noexcept {
+            Dispose();
+        }
+
+        void Mux::Dispose() noexcept {
+            if (!disposed_.exchange(true)) {
+                VirtualChannelTable channels;
+                pending_queue discards; {
+                    MutexScope scope(syncobj_);
+                    channels = std::move(channels_);
+                    channels_.clear();
+                    backlogs_ = 0;
+                    paused_ = false;
+                    pumping_ = false;
+                    discards.splice(discards.end(), urgents_);
+                    discards.splice(discards.end(), bulks_);
+                }
+
+                for (pending& frames : discards) {
+                    if (frames.callback) {
+                        frames.callback(false);
+                    }
+                }
+
+                for (auto&& kv : channels) {
+                    VirtualChannelPtr& virtualChannel = kv.second;
+                    virtualChannel->remoted_ = true;
+
+                    ReadAsyncCallback reading = std::move(virtualChannel->reading_);
+                    virtualChannel->reading_ = NULL;
+                    if (reading) {
+                        reading(NULL, -1);
+                    }
+                    virtualChannel->Close();
+                }
+
+                const ITransmissionPtr reader = std::move(reader_);
+                if (reader) {
+                    reader->Close();
+                }
+
+                const ITransmissionPtr writer = std::move(writer_);
+                if (writer) {
+                    writer->Close();
+                }
+
+                reader_.reset();
+                writer_.reset();
+                uds::threading::ClearTimeout(timeout_);
+
+                DisposedEventHandler disposedEvent = std::move(DisposedEvent);
+                if (disposedEvent) {
+                    DisposedEvent = NULL;
+                    disposedEvent(this);
+                }
+                AcceptEvent = NULL;
+            }
+        }
+
+        bool Mux::Available() noexcept {
+            return running_ && !disposed_;
+        }
+
+        Mux::AsyncContextPtr Mux::GetContext() noexcept {
+            const ITransmissionPtr reader = reader_;
+            if (reader) {
+                return reader->GetContext();
+            }
+
+            const ITransmissionPtr writer = writer_;
+            if (writer) {
+                return writer->GetContext();
+            }
+            return NULL;
+        }
+
+        const Mux::AppConfigurationPtr& Mux::GetConfiguration() noexcept {
+            return channels_configuration_;
+        }
+
+        Mux::ITransmissionPtr Mux::OpenChannel(int& channel) noexcept {
+            channel = 0;
+            if (disposed_) {
+                return NULL;
+            }
+
+            VirtualChannelPtr virtualChannel; {
+                MutexScope scope(syncobj_);
+                for (;;) {
+                    channel = ++channel_;
+                    if (channel < 1) {
+                        channel_ = 0;
+                        continue;
+                    }
+
+                    if (Dictionary::ContainsKey(channels_, channel)) {
+                        continue;
+                    }
+                    break;
+                }
+
+                virtualChannel = NewReference<VirtualChannel>(GetReference(), this, channel);
+                if (!virtualChannel) {
+                    return NULL;
+                }
+                channels_[channel] = virtualChannel;
+            }
+
+            ITransmissionPtr transmission = virtualChannel->Constructor(virtualChannel);
+            if (!WriteControlAsync(EMUX_CTRL_OPEN, channel)) {
+                CloseChannel(channel, false);
+                return NULL;
+            }
+            return transmission;
+        }
+
+        Mux::ITransmissionPtr Mux::AcceptChannel(int channel) noexcept {
+            VirtualChannelPtr virtualChannel; {
+                MutexScope scope(syncobj_);
+                Dictionary::TryGetValue(channels_, channel, virtualChannel);
+            }
+            return virtualChannel ? virtualChannel->GetReference() : NULL;
+        }
+
+        bool Mux::CloseChannel(int channel, bool notify) noexcept {
+            VirtualChannelPtr virtualChannel;
+            ReadAsyncCallback reading; {
+                MutexScope scope(syncobj_);
+                if (!Dictionary::TryRemove(channels_, channel, virtualChannel)) {
+                    return false;
+                }
+
+                backlogs_ -= (int)virtualChannel->frames_.size();
+                virtualChannel->frames_.clear();
+                virtualChannel->remoted_ = true;
+
+                reading = std::move(virtualChannel->reading_);
+                virtualChannel->reading_ = NULL;
+            }
+
+            if (notify && !disposed_) {
+                WriteControlAsync(EMUX_CTRL_CLOSE, channel);
+            }
+
+            if (reading) {
+                reading(NULL, -1);
+            }
+
+            virtualChannel->Close();
+            return ResumeReadCycle();
+        }
+
+        bool Mux::ReadCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            const ITransmissionPtr reader = reader_;
+            if (!reader) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            return reader->ReadAsync(
+                [references, this, reader](const std::shared_ptr<Byte>& buffers, int length) noexcept {
+                    if (length < 1 || !OnFrame(buffers, length)) {
+                        Close();
+                    }
+                });
+        }
+
+        bool Mux::ResumeReadCycle() noexcept {
+            bool resume = false; {
+                MutexScope scope(syncobj_);
+                if (paused_ && backlogs_ < EMUX_BACKLOG) {
+                    paused_ = false;
+                    resume = true;
+                }
+            }
+            return resume ? ReadCycle() : true;
+        }
+
+        bool Mux::OnFrame(const std::shared_ptr<Byte>& buffer, int length) noexcept {
+            if (!buffer || length <= EMUX_TSS) {
+                return false;
+            }
+
+            Byte* packet = buffer.get();
+            int channel = packet[0] << 24 | packet[1] << 16 | packet[2] << 8 | packet[3];
+            if (!channel) {
+                return OnControlFrame(packet + EMUX_TSS, length - EMUX_TSS) && ReadCycle();
+            }
+
+            ReadAsyncCallback reading;
+            bool paused = false; {
+                MutexScope scope(syncobj_);
+                VirtualChannelPtr virtualChannel;
+                if (!Dictionary::TryGetValue(channels_, channel, virtualChannel)) {
+                    return ReadCycle(); /* Raced a CLOSE: the frame is dropped on the floor. */
+                }
+
+                reading = std::move(virtualChannel->reading_);
+                virtualChannel->reading_ = NULL;
+                if (!reading) {
+                    VirtualChannel::frame messages;
+                    messages.packet = uds::threading::BufferslabPool::Alloc(length - EMUX_TSS);
+                    messages.packet_size = length - EMUX_TSS;
+                    if (!messages.packet) {
+                        return false;
+                    }
+
+                    memcpy(messages.packet.get(), packet + EMUX_TSS, messages.packet_size);
+                    virtualChannel->frames_.push_back(std::move(messages));
+
+                    if (++backlogs_ >= EMUX_BACKLOG) { /* Parked frames filled the budget: the pipe pauses until a channel drains. */
+                        paused_ = true;
+                        paused = true;
+                    }
+                }
+            }
+
+            if (reading) {
+                /* The transmission reuses its receive buffer between reads and the relay
+                 * copies synchronously, so an aliased pointer avoids the slab copy. */
+                std::shared_ptr<Byte> messages(buffer, packet + EMUX_TSS);
+                reading(messages, length - EMUX_TSS);
+            }
+            return paused ? true : ReadCycle();
+        }
+
+        bool Mux::OnControlFrame(const Byte* packet, int length) noexcept {
+            if (length < 5) {
+                return false;
+            }
+
+            Byte op = packet[0];
+            int channel = packet[1] << 24 | packet[2] << 16 | packet[3] << 8 | packet[4];
+            if (op == EMUX_CTRL_OPEN) {
+                if (!channel) {
+                    return false;
+                }
+
+                VirtualChannelPtr virtualChannel = NewReference<VirtualChannel>(GetReference(), this, channel);
+                if (!virtualChannel) {
+                    return false;
+                }
+
+                virtualChannel->Constructor(virtualChannel); {
+                    MutexScope scope(syncobj_);
+                    if (!Dictionary::TryAdd(channels_, channel, virtualChannel)) {
+                        return false;
+                    }
+                }
+
+                AcceptEventHandler acceptEvent = AcceptEvent;
+                if (acceptEvent) {
+                    acceptEvent(this, channel);
+                }
+                return true;
+            }
+            elif(op == EMUX_CTRL_CLOSE) {
+                if (!channel) {
+                    return false;
+                }
+
+                CloseChannel(channel, false);
+                return true;
+            }
+            elif(op == EMUX_CTRL_PING) {
+                return true; /* The payload is shaping junk; arriving at all is the signal. */
+            }
+            else {
+                return false;
+            }
+        }
+
+        bool Mux::WriteFrameAsync(int channel, bool urgent, const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (disposed_ || !buffer || offset < 0 || length < 1 || length > EMUX_MSS) {
+                return false;
+            }
+
+            const ITransmissionPtr writer = writer_;
+            if (!writer) {
+                return false;
+            }
+
+            int packet_size = EMUX_TSS + length;
+            std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(packet_size);
+            if (!packet) {
+                return false;
+            }
+
+            Byte* p = packet.get();
+            p[0] = (Byte)(channel >> 24);
+            p[1] = (Byte)(channel >> 16);
+            p[2] = (Byte)(channel >> 8);
+            p[3] = (Byte)(channel);
+            memcpy(p + EMUX_TSS, buffer.get() + offset, length);
+
+            if (!configuration_->Priority.Enabled) {
+                return writer->WriteAsync(packet, 0, packet_size, forward0f(callback));
+            }
+
+            {
+                MutexScope scope(syncobj_);
+                pending frames;
+                frames.packet = std::move(packet);
+                frames.packet_size = packet_size;
+                frames.callback = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+                if (urgent) {
+                    urgents_.push_back(std::move(frames));
+                }
+                else {
+                    VirtualChannelPtr owner;
+                    if (Dictionary::TryGetValue(channels_, channel, owner)) {
+                        owner->bulk_parked_++;
+                    }
+                    frames.owner = std::move(owner);
+                    bulks_.push_back(std::move(frames));
+                }
+            }
+            return PumpWriteQueues();
+        }
+
+        bool Mux::PumpWriteQueues() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            pending_queue round; {
+                MutexScope scope(syncobj_);
+                if (pumping_) {
+                    return true; /* The in-flight round's tail completion starts the next. */
+                }
+
+                if (urgents_.empty() && bulks_.empty()) {
+                    return true;
+                }
+
+                /* Interactive frames lead the round wholesale; bulk follows up to
+                 * the fairness budget - always at least one frame - so keystrokes
+                 * stop waiting behind megabytes of queued upload without ever
+                 * starving the upload itself. */
+                round.splice(round.end(), urgents_);
+
+                int budget = EMUX_FAIR;
+                while (!bulks_.empty()) {
+                    pending& frames = bulks_.front();
+                    budget -= frames.packet_size;
+
+                    const VirtualChannelPtr owner = std::move(frames.owner);
+                    if (owner) { /* Leaving the bulk queue: the channel's class may float again. */
+                        owner->bulk_parked_--;
+                    }
+
+                    round.splice(round.end(), bulks_, bulks_.begin());
+                    if (budget <= 0) {
+                        break;
+                    }
+                }
+                pumping_ = true;
+            }
+
+            const ITransmissionPtr writer = writer_;
+            if (!writer) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            while (!round.empty()) {
+                pending frames = std::move(round.front());
+                round.pop_front();
+
+                WriteAsyncCallback callback = std::move(frames.callback);
+                if (round.empty()) { /* The round's tail completion hands the wire to the next round. */
+                    const WriteAsyncCallback chained = std::move(callback);
+                    callback = [references, this, chained](bool success) noexcept {
+                        if (chained) {
+                            chained(success);
+                        }
+
+                        {
+                            MutexScope scope(syncobj_);
+                            pumping_ = false;
+                        }
+
+                        if (success) {
+                            PumpWriteQueues();
+                        }
+                        else {
+                            Close();
+                        }
+                    };
+                }
+
+                if (!writer->WriteAsync(frames.packet, 0, frames.packet_size, std::move(callback))) {
+                    {
+                        MutexScope scope(syncobj_);
+                        pumping_ = false;
+                    }
+
+                    Close();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool Mux::WriteControlAsync(Byte op, int channel) noexcept {
+            int packet_size = EMUX_TSS + 5;
+            if (op == EMUX_CTRL_PING) { /* Pings are padded like the junk keepalive frames they replace. */
+                packet_size = RandomNext(packet_size, 64);
+            }
+
+            std::shared_ptr<Byte> packet = uds::threading::BufferslabPool::Alloc(packet_size);
+            if (!packet) {
+                return false;
+            }
+
+            Byte* p = packet.get();
+            memset(p, 0, EMUX_TSS);
+            p[EMUX_TSS] = op;
+            p[EMUX_TSS + 1] = (Byte)(channel >> 24);
+            p[EMUX_TSS + 2] = (Byte)(channel >> 16);
+            p[EMUX_TSS + 3] = (Byte)(channel >> 8);
+            p[EMUX_TSS + 4] = (Byte)(channel);
+            RandomAsciiFill(p + EMUX_TSS + 5, packet_size - (EMUX_TSS + 5));
+
+            const ITransmissionPtr writer = writer_;
+            if (!writer) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            WriteAsyncCallback callback = [references, this](bool success) noexcept {
+                if (!success) {
+                    Close();
+                }
+            };
+
+            if (configuration_->Priority.Enabled) {
+                pending frames;
+                frames.packet = std::move(packet);
+                frames.packet_size = packet_size;
+                frames.callback = std::move(callback); {
+                    MutexScope scope(syncobj_);
+
+                    /* CLOSE rides the bulk queue so it can never overtake the closing
+                     * channel's parked data; OPEN and PING lead with the interactive
+                     * class - an OPEN stuck behind an upload would stall its channel. */
+                    if (op == EMUX_CTRL_CLOSE) {
+                        bulks_.push_back(std::move(frames));
+                    }
+                    else {
+                        urgents_.push_back(std::move(frames));
+                    }
+                }
+                return PumpWriteQueues();
+            }
+
+            return writer->WriteAsync(packet, 0, packet_size, std::move(callback));
+        }
+
+        bool Mux::KeepAlivedSendCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            if (timeout_) {
+                uds::threading::ClearTimeout(timeout_);
+            }
+
+            timeout_ = uds::threading::SetTimeout(context,
+                [references, this](void*) noexcept {
+                    if (timeout_) {
+                        uds::threading::ClearTimeout(timeout_);
+                    }
+
+                    if (!WriteControlAsync(EMUX_CTRL_PING, RandomNext(1, INT_MAX)) || !KeepAlivedSendCycle()) {
+                        Close();
+                    }
+                }, RandomNext(100, 500));
+            return NULL != timeout_;
+        }
+    }
+}
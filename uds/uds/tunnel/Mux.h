@@ -0,0 +1,100 @@
+#pragma once
+
+#include <uds/IDisposable.h>
+#include <uds/threading/Hosting.h>
+#include <uds/configuration/AppConfiguration.h>
+#include <uds/transmission/ITransmission.h>
+#include <uds/collections/FlatHashMap.h>
+
+namespace uds {
+    namespace tunnel {
+        /* Multiplexes many logical channels over one long-lived transmission pair:
+         * every frame carries a channel id ahead of the payload and channel zero is
+         * the control plane (OPEN/CLOSE/PING). Short-lived relayed connections ride
+         * the established pipe and skip the per-connection TCP, TLS and plaintext
+         * handshakes entirely; the trade is that all channels share the head of one
+         * byte stream, so a stalled pipe stalls every channel on it. */
+        class Mux : public IDisposable {
+        public:
+            using ITransmission                 = uds::transmission::ITransmission;
+            using ITransmissionPtr              = std::shared_ptr<ITransmission>;
+            using AppConfiguration              = uds::configuration::AppConfiguration;
+            using AppConfigurationPtr           = std::shared_ptr<AppConfiguration>;
+            using AsyncContextPtr               = std::shared_ptr<boost::asio::io_context>;
+            using ReadAsyncCallback             = ITransmission::ReadAsyncCallback;
+            using WriteAsyncCallback            = ITransmission::WriteAsyncCallback;
+            using AcceptEventHandler            = std::function<void(Mux*, int)>;
+            using DisposedEventHandler          = std::function<void(Mux*)>;
+
+        public:
+            const int                           EMUX_TSS = 4; /* Big-endian logical channel id ahead of every payload. */
+            const int                           EMUX_MSS = uds::threading::Hosting::BufferSize - 4;
+            const int                           EMUX_BACKLOG = 128;
+            const int                           EMUX_FAIR = 64 * 1024; /* Bulk bytes handed to the pipe per scheduling round while interactive frames bypass. */
+            AcceptEventHandler                  AcceptEvent;
+            DisposedEventHandler                DisposedEvent;
+
+        public:
+            Mux(const AppConfigurationPtr& configuration, const ITransmissionPtr& reader, const ITransmissionPtr& writer) noexcept;
+
+        public:
+            virtual bool                        Run() noexcept;
+            virtual void                        Dispose() noexcept override;
+            void                                Close() noexcept;
+            bool                                Available() noexcept;
+            AsyncContextPtr                     GetContext() noexcept;
+            const AppConfigurationPtr&          GetConfiguration() noexcept;
+
+        public:
+            ITransmissionPtr                    OpenChannel(int& channel) noexcept;
+            ITransmissionPtr                    AcceptChannel(int channel) noexcept;
+
+        private:
+            class VirtualChannel;
+            using VirtualChannelPtr             = std::shared_ptr<VirtualChannel>;
+            using VirtualChannelTable           = uds::collections::FlatHashMap<int, VirtualChannelPtr>;
+            using Mutex                         = std::mutex;
+            using MutexScope                    = std::lock_guard<Mutex>;
+
+        private:
+            bool                                ReadCycle() noexcept;
+            bool                                ResumeReadCycle() noexcept;
+            bool                                OnFrame(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                OnControlFrame(const Byte* packet, int length) noexcept;
+            bool                                KeepAlivedSendCycle() noexcept;
+
+        private:
+            /* A channel-tagged frame parked in the two-class write scheduler. */
+            struct pending {
+                std::shared_ptr<Byte>           packet;
+                int                             packet_size;
+                WriteAsyncCallback              callback;
+                VirtualChannelPtr               owner; /* Set while the frame sits in the bulk queue, pinning its channel to the bulk class. */
+            };
+            typedef std::list<pending>          pending_queue;
+
+        private:
+            bool                                WriteFrameAsync(int channel, bool urgent, const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            bool                                WriteControlAsync(Byte op, int channel) noexcept;
+            bool                                PumpWriteQueues() noexcept;
+            bool                                CloseChannel(int channel, bool notify) noexcept;
+
+        private:
+            std::atomic<bool>                   disposed_;
+            bool                                running_;
+            bool                                paused_;
+            bool                                pumping_; /* A scheduling round is in flight; its tail completion starts the next. */
+            int                                 backlogs_; /* Frames parked on channels that have no read pending. */
+            int                                 channel_;
+            AppConfigurationPtr                 configuration_;
+            AppConfigurationPtr                 channels_configuration_;
+            ITransmissionPtr                    reader_;
+            ITransmissionPtr                    writer_;
+            std::shared_ptr<boost::asio::deadline_timer> timeout_;
+            Mutex                               syncobj_;
+            VirtualChannelTable                 channels_;
+            pending_queue                       urgents_; /* Frames of interactive-class channels: they lead every round. */
+            pending_queue                       bulks_;   /* Frames of bulk-class channels: EMUX_FAIR bytes of them follow. */
+        };
+    }
+}